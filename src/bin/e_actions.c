@@ -3869,6 +3869,7 @@ e_action_add(const char *name)
         eina_hash_direct_add(actions, act->name, act);
         action_names = eina_list_append(action_names, name);
         action_list = eina_list_append(action_list, act);
+        e_bindings_actions_changed();
      }
    return act;
 }
@@ -4039,6 +4040,7 @@ _e_action_free(E_Action *act)
    eina_hash_del(actions, act->name, act);
    action_names = eina_list_remove(action_names, act->name);
    action_list = eina_list_remove(action_list, act);
+   e_bindings_actions_changed();
    free(act);
 }
 
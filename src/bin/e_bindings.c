@@ -8,6 +8,7 @@ static void               _e_bindings_signal_free(E_Binding_Signal *bind);
 static void               _e_bindings_wheel_free(E_Binding_Wheel *bind);
 static void               _e_bindings_acpi_free(E_Binding_Acpi *bind);
 static Eina_Bool          _e_bindings_edge_cb_timer(void *data);
+static void               _e_bindings_key_index_clear(void);
 
 /* local subsystem globals */
 
@@ -20,6 +21,20 @@ static Eina_List *acpi_bindings = NULL;
 
 static unsigned int bindings_disabled = 0;
 
+/* key bindings by key name, each a list of E_Binding_Key_Index in
+ * key_bindings order with their action already looked up. built on the
+ * first key event after key bindings or actions change */
+typedef struct _E_Binding_Key_Index E_Binding_Key_Index;
+
+struct _E_Binding_Key_Index
+{
+   E_Binding_Key *binding;
+   E_Action      *act;
+   unsigned int   seq;
+};
+
+static Eina_Hash *key_index = NULL;
+
 EINTERN E_Action *(*e_binding_key_list_cb)(E_Binding_Context, Ecore_Event_Key*, E_Binding_Modifier, E_Binding_Key **);
 
 typedef struct _E_Binding_Edge_Data E_Binding_Edge_Data;
@@ -93,6 +108,7 @@ EINTERN int
 e_bindings_shutdown(void)
 {
    E_FREE_LIST(mouse_bindings, _e_bindings_mouse_free);
+   _e_bindings_key_index_clear();
    E_FREE_LIST(key_bindings, _e_bindings_key_free);
    E_FREE_LIST(edge_bindings, _e_bindings_edge_free);
    E_FREE_LIST(signal_bindings, _e_bindings_signal_free);
@@ -316,6 +332,7 @@ e_bindings_key_reset(void)
    Eina_List *l;
 
    e_comp_canvas_keys_ungrab();
+   _e_bindings_key_index_clear();
    E_FREE_LIST(key_bindings, _e_bindings_key_free);
 
    EINA_LIST_FOREACH(e_bindings->key_bindings, l, ebk)
@@ -614,6 +631,7 @@ e_bindings_key_add(E_Binding_Context ctxt, const char *key, E_Binding_Modifier m
    if (action) binding->action = eina_stringshare_add(action);
    if (params) binding->params = eina_stringshare_add(params);
    key_bindings = eina_list_append(key_bindings, binding);
+   _e_bindings_key_index_clear();
 }
 
 E_API E_Binding_Key *
@@ -665,6 +683,7 @@ e_bindings_key_del(E_Binding_Context ctxt, const char *key, E_Binding_Modifier m
             (((binding->params) && (params) && (!strcmp(binding->params, params))) ||
              ((!binding->params) && (!params))))
           {
+             _e_bindings_key_index_clear();
              _e_bindings_key_free(binding);
              key_bindings = eina_list_remove_list(key_bindings, l);
              break;
@@ -758,12 +777,64 @@ e_bindings_key_up_event_handle(E_Binding_Context ctxt, E_Object *obj, Ecore_Even
    return act;
 }
 
+static void
+_e_bindings_key_index_bucket_free(void *data)
+{
+   Eina_List *bucket = data;
+   E_Binding_Key_Index *ki;
+
+   EINA_LIST_FREE(bucket, ki)
+     free(ki);
+}
+
+static void
+_e_bindings_key_index_clear(void)
+{
+   E_FREE_FUNC(key_index, eina_hash_free);
+}
+
+static void
+_e_bindings_key_index_build(void)
+{
+   E_Binding_Key *binding;
+   E_Binding_Key_Index *ki;
+   Eina_List *l, *bucket;
+   unsigned int seq = 0;
+
+   key_index = eina_hash_string_superfast_new(_e_bindings_key_index_bucket_free);
+   EINA_LIST_FOREACH(key_bindings, l, binding)
+     {
+        seq++;
+        if (!binding->key) continue;
+        ki = E_NEW(E_Binding_Key_Index, 1);
+        if (!ki) continue;
+        ki->binding = binding;
+        ki->act = e_action_find(binding->action);
+        ki->seq = seq;
+        bucket = eina_hash_find(key_index, binding->key);
+        if (bucket)
+          eina_list_append(bucket, ki);
+        else
+          eina_hash_direct_add(key_index, binding->key,
+                               eina_list_append(NULL, ki));
+     }
+}
+
+/* actions are looked up once when the key index is built, so it has to go
+ * whenever an action appears or is freed */
+EINTERN void
+e_bindings_actions_changed(void)
+{
+   _e_bindings_key_index_clear();
+}
+
 E_API E_Action *
 e_bindings_key_event_find(E_Binding_Context ctxt, Ecore_Event_Key *ev, E_Binding_Key **bind_ret)
 {
    E_Binding_Modifier mod = 0;
    E_Binding_Key *binding;
-   Eina_List *l;
+   E_Binding_Key_Index *ki;
+   Eina_List *lk = NULL, *ln = NULL;
    E_Action *act = NULL;
 
    mod = e_bindings_modifiers_from_ecore(ev->modifiers);
@@ -773,14 +844,33 @@ e_bindings_key_event_find(E_Binding_Context ctxt, Ecore_Event_Key *ev, E_Binding
         if (act) return act;
         if (bind_ret) *bind_ret = NULL;
      }
-   EINA_LIST_FOREACH(key_bindings, l, binding)
+   if (!key_bindings) return NULL;
+   if (!key_index) _e_bindings_key_index_build();
+   /* a binding may name either the key or the keyname; walk both buckets
+    * merged back into key_bindings order so the first match still wins */
+   if (ev->key) lk = eina_hash_find(key_index, ev->key);
+   if ((ev->keyname) && ((!ev->key) || (strcmp(ev->key, ev->keyname))))
+     ln = eina_hash_find(key_index, ev->keyname);
+   while ((lk) || (ln))
      {
-        if ((binding->key) && ((!strcmp(binding->key, ev->key)) || (!strcmp(binding->key, ev->keyname))) &&
-            ((binding->any_mod) || (binding->mod == mod)))
+        if ((lk) && ((!ln) ||
+                     (((E_Binding_Key_Index *)lk->data)->seq <
+                      ((E_Binding_Key_Index *)ln->data)->seq)))
+          {
+             ki = lk->data;
+             lk = lk->next;
+          }
+        else
+          {
+             ki = ln->data;
+             ln = ln->next;
+          }
+        binding = ki->binding;
+        if ((binding->any_mod) || (binding->mod == mod))
           {
              if (!e_bindings_context_match(binding->ctxt, ctxt)) continue;
              if (act && (binding->ctxt == E_BINDING_CONTEXT_ANY)) continue;
-             act = e_action_find(binding->action);
+             act = ki->act;
              if (bind_ret) *bind_ret = binding;
              if (!act) continue;
              if (binding->ctxt != E_BINDING_CONTEXT_ANY) break;
@@ -41,6 +41,11 @@ static E_Drag *client_drag = NULL;
 static Eina_List *focus_stack = NULL;
 static Eina_List *raise_stack = NULL;
 
+/* clients which e_client_idler_before() needs to look at, each holds a ref */
+static Eina_List *dirty_clients = NULL;
+static unsigned int idler_visited = 0;
+static int dirty_comp_w = -1, dirty_comp_h = -1;
+
 static Eina_Bool comp_grabbed = EINA_FALSE;
 static Evas_Object *action_rect;
 
@@ -53,6 +58,7 @@ static Ecore_Timer *action_timer = NULL;
 static Eina_Rectangle action_orig = {0, 0, 0, 0};
 
 static E_Client_Layout_Cb _e_client_layout_cb = NULL;
+static E_Client_Prefetch_Cb _e_client_prefetch_cb = NULL;
 
 EINTERN void e_client_focused_set(E_Client *ec);
 
@@ -674,6 +680,14 @@ _e_client_del(E_Client *ec)
      child->leader = NULL;
 
    e_comp->clients = eina_list_remove(e_comp->clients, ec);
+   if (ec->on_dirty)
+     {
+        dirty_clients = eina_list_remove(dirty_clients, ec);
+        ec->on_dirty = 0;
+        UNREFD(ec, 112);
+        e_object_unref(E_OBJECT(ec));
+     }
+   e_client_index_del(ec);
    if (ec->frame) e_comp_object_render_update_del(ec->frame);
 }
 
@@ -1210,8 +1224,10 @@ static E_Client *
 _e_client_under_pointer_helper(E_Desk *desk, E_Client *exclude, int x, int y)
 {
    E_Client *ec = NULL, *cec;
+   Eina_List *clients;
 
-   E_CLIENT_REVERSE_FOREACH(cec)
+   clients = e_client_index_clients_get(x, y, 1, 1);
+   EINA_LIST_FREE(clients, cec)
      {
         /* If a border was specified which should be excluded from the list
          * (because it will be closed shortly for example), skip */
@@ -1604,6 +1620,9 @@ _e_client_cb_evas_move(void *data, Evas *e EINA_UNUSED, Evas_Object *obj EINA_UN
    _e_client_event_simple(ec, E_EVENT_CLIENT_MOVE);
 
    if (!ec->ignored) _e_client_zone_update(ec);
+   e_client_index_update(ec);
+   /* offscreen checks */
+   e_client_dirty_add(ec);
    evas_object_geometry_get(ec->frame, &x, &y, NULL, NULL);
    if (ec->stack.prev || ec->stack.next)
      {
@@ -1643,6 +1662,8 @@ _e_client_cb_evas_resize(void *data, Evas *e EINA_UNUSED, Evas_Object *obj EINA_
 
    _e_client_event_simple(ec, E_EVENT_CLIENT_RESIZE);
 
+   e_client_index_update(ec);
+   e_client_dirty_add(ec);
    evas_object_geometry_get(ec->frame, &x, &y, &w, &h);
    if (ec->stack.prev || ec->stack.next)
      {
@@ -1686,6 +1707,7 @@ _e_client_cb_evas_resize(void *data, Evas *e EINA_UNUSED, Evas_Object *obj EINA_
 static void
 _e_client_cb_evas_show(void *data, Evas *e EINA_UNUSED, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
 {
+   e_client_index_update(data);
    _e_client_event_simple(data, E_EVENT_CLIENT_SHOW);
 }
 
@@ -1694,6 +1716,7 @@ _e_client_cb_evas_restack(void *data, Evas *e EINA_UNUSED, Evas_Object *obj EINA
 {
    E_Client *ec = data;
 
+   e_client_index_stack_changed();
    if (ec->layer_block) return;
    if (ec->stack.prev || ec->stack.next)
      {
@@ -2419,21 +2442,107 @@ _e_client_frame_update(E_Client *ec)
 }
 
 ////////////////////////////////////////////////
+
+static int
+_e_client_dirty_stack_cmp(const void *a, const void *b)
+{
+   if (e_client_index_stacked_above(b, a)) return -1;
+   if (e_client_index_stacked_above(a, b)) return 1;
+   return 0;
+}
+
+/* returns the dirty clients in stacking order, bottom first, each with a ref
+ * held for the duration of the pass; the previous pass's list is released
+ */
+static Eina_List *
+_e_client_dirty_pass_get(Eina_List *prev)
+{
+   Eina_List *l, *list;
+   E_Client *ec;
+
+   EINA_LIST_FREE(prev, ec)
+     e_object_unref(E_OBJECT(ec));
+   list = eina_list_clone(dirty_clients);
+   list = eina_list_sort(list, 0, _e_client_dirty_stack_cmp);
+   EINA_LIST_FOREACH(list, l, ec)
+     e_object_ref(E_OBJECT(ec));
+   idler_visited = MAX(idler_visited, eina_list_count(list));
+   return list;
+}
+
+/* clients stay dirty until they have no pending changes */
+static void
+_e_client_dirty_prune(void)
+{
+   Eina_List *l, *ll;
+   E_Client *ec;
+
+   EINA_LIST_FOREACH_SAFE(dirty_clients, l, ll, ec)
+     {
+        /* ignored clients are queued again when unignored */
+        if ((ec->changed || ec->changes.visible) && (!ec->ignored)) continue;
+        dirty_clients = eina_list_remove_list(dirty_clients, l);
+        ec->on_dirty = 0;
+        UNREFD(ec, 112);
+        e_object_unref(E_OBJECT(ec));
+     }
+}
+
+/* queue a client for e_client_idler_before(); EC_CHANGED() does this */
+E_API void
+e_client_dirty_add(E_Client *ec)
+{
+   E_Client *bottom;
+
+   if (ec->on_dirty || e_object_is_del(E_OBJECT(ec))) return;
+   ec->on_dirty = 1;
+   dirty_clients = eina_list_append(dirty_clients, ec);
+   REFD(ec, 112);
+   e_object_ref(E_OBJECT(ec));
+   /* the bottom client of a window stack lays out the whole stack */
+   if (ec->stack.prev)
+     {
+        bottom = e_client_stack_bottom_get(ec);
+        if (bottom) e_client_dirty_add(bottom);
+     }
+}
+
+/* number of clients visited by the last e_client_idler_before(), for debugging */
+E_API unsigned int
+e_client_idler_visited_get(void)
+{
+   return idler_visited;
+}
+
 EINTERN void
 e_client_idler_before(void)
 {
-   const Eina_List *l;
+   Eina_List *l, *pass;
    E_Client *ec;
 
    if ((!eina_hash_population(clients_hash[0])) && (!eina_hash_population(clients_hash[1]))) return;
 
+   /* all clients need an offscreen check after the canvas changes size */
+   if ((dirty_comp_w != e_comp->w) || (dirty_comp_h != e_comp->h))
+     {
+        dirty_comp_w = e_comp->w, dirty_comp_h = e_comp->h;
+        EINA_LIST_FOREACH(e_comp->clients, l, ec)
+          e_client_dirty_add(ec);
+     }
+   idler_visited = 0;
+   if (!dirty_clients) return;
 
-   EINA_LIST_FOREACH(e_comp->clients, l, ec)
+   pass = _e_client_dirty_pass_get(NULL);
+   /* lets the compositor request the properties of all changed clients
+    * at once before FETCH asks for them one client at a time */
+   if (_e_client_prefetch_cb)
+     _e_client_prefetch_cb(pass);
+   EINA_LIST_FOREACH(pass, l, ec)
      {
         Eina_Stringshare *title;
         // pass 1 - eval0. fetch properties on new or on change and
         // call hooks to decide what to do - maybe move/resize
-        if (ec->ignored || (!ec->changed)) continue;
+        if (ec->ignored || (!ec->changed) || e_object_is_del(E_OBJECT(ec))) continue;
 
         if (!_e_client_hook_call(E_CLIENT_HOOK_EVAL_PRE_FETCH, ec)) continue;
         /* FETCH is hooked by the compositor to get client hints */
@@ -2454,9 +2563,10 @@ e_client_idler_before(void)
         _e_client_hook_call(E_CLIENT_HOOK_EVAL_POST_FRAME_ASSIGN, ec);
      }
 
-   E_CLIENT_FOREACH(ec)
+   pass = _e_client_dirty_pass_get(pass);
+   EINA_LIST_FOREACH(pass, l, ec)
      {
-        if (ec->ignored) continue;
+        if (ec->ignored || e_object_is_del(E_OBJECT(ec))) continue;
         // pass 2 - show windows needing show
         if ((ec->changes.visible) && (ec->visible) &&
             (!ec->new_client) && (!ec->changes.pos) &&
@@ -2520,7 +2630,7 @@ e_client_idler_before(void)
                             child->pre_cb.x = x;
                             child->pre_cb.y = y;
                             child->changes.pos = 1;
-                            child->changed = 1;
+                            EC_CHANGED(child);
                          }
                     }
                   e_client_stack_list_finish(list);
@@ -2532,7 +2642,8 @@ e_client_idler_before(void)
      _e_client_layout_cb();
 
    // pass 3 - hide windows needing hide and eval (main eval)
-   E_CLIENT_FOREACH(ec)
+   pass = _e_client_dirty_pass_get(pass);
+   EINA_LIST_FOREACH(pass, l, ec)
      {
         if (ec->ignored || e_object_is_del(E_OBJECT(ec))) continue;
 
@@ -2554,6 +2665,9 @@ e_client_idler_before(void)
                evas_object_hide(ec->frame);
           }
      }
+   EINA_LIST_FREE(pass, ec)
+     e_object_unref(E_OBJECT(ec));
+   _e_client_dirty_prune();
 }
 
 
@@ -2562,6 +2676,7 @@ e_client_init(void)
 {
    clients_hash[0] = eina_hash_pointer_new(NULL);
    clients_hash[1] = eina_hash_pointer_new(NULL);
+   e_client_index_init();
 
    E_LIST_HANDLER_APPEND(handlers, E_EVENT_POINTER_WARP,
                          _e_client_cb_pointer_warp, NULL);
@@ -2599,8 +2714,17 @@ e_client_init(void)
 EINTERN void
 e_client_shutdown(void)
 {
+   E_Client *ec;
+
    E_FREE_FUNC(clients_hash[0], eina_hash_free);
    E_FREE_FUNC(clients_hash[1], eina_hash_free);
+   EINA_LIST_FREE(dirty_clients, ec)
+     {
+        ec->on_dirty = 0;
+        UNREFD(ec, 112);
+        e_object_unref(E_OBJECT(ec));
+     }
+   e_client_index_shutdown();
 
    E_FREE_LIST(handlers, ecore_event_handler_del);
 
@@ -2626,6 +2750,8 @@ e_client_unignore(E_Client *ec)
      }
    _e_client_event_simple(ec, E_EVENT_CLIENT_ADD);
    _e_client_hook_call(E_CLIENT_HOOK_UNIGNORE, ec);
+   /* changes made while ignored were dropped from the dirty list */
+   if (ec->changed) e_client_dirty_add(ec);
 }
 
 E_API E_Client *
@@ -2736,6 +2862,7 @@ e_client_new(E_Pixmap *cp, int first_map, int internal)
         evas_object_event_callback_add(ec->frame, EVAS_CALLBACK_RESIZE, _e_client_cb_evas_resize, ec);
         evas_object_event_callback_add(ec->frame, EVAS_CALLBACK_RESTACK, _e_client_cb_evas_restack, ec);
         evas_object_smart_callback_add(ec->frame, "shade_done", _e_client_cb_evas_shade_done, ec);
+        e_client_index_update(ec);
         if (ec->override)
           evas_object_layer_set(ec->frame, E_LAYER_CLIENT_ABOVE);
         else
@@ -5653,6 +5780,14 @@ e_client_layout_cb_set(E_Client_Layout_Cb cb)
    _e_client_layout_cb = cb;
 }
 
+E_API void
+e_client_prefetch_cb_set(E_Client_Prefetch_Cb cb)
+{
+   if (_e_client_prefetch_cb && cb)
+     CRI("ATTEMPTING TO OVERWRITE EXISTING CLIENT PREFETCH HOOK!!!");
+   _e_client_prefetch_cb = cb;
+}
+
 ////////////////////////////////////////////
 
 E_API void
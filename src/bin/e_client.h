@@ -177,6 +177,7 @@ typedef enum _E_Client_Hook_Point
 typedef void (*E_Client_Move_Intercept_Cb)(E_Client *, int x, int y);
 typedef void (*E_Client_Hook_Cb)(void *data, E_Client *ec);
 typedef void (*E_Client_Layout_Cb)(void);
+typedef void (*E_Client_Prefetch_Cb)(const Eina_List *clients);
 #else
 
 #ifndef HAVE_WAYLAND_ONLY
@@ -726,6 +727,7 @@ struct E_Client
    Eina_Bool keyboard_resizing E_BITFIELD;
 
    Eina_Bool on_post_updates E_BITFIELD; // client is on the post update list
+   Eina_Bool on_dirty E_BITFIELD; // client is on the dirty list for e_client_idler_before()
 };
 
 #define e_client_focus_policy_click(ec) \
@@ -738,10 +740,15 @@ struct E_Client
      if (e_object_is_del(E_OBJECT(EC))) \
        EINA_LOG_CRIT("CHANGED SET ON DELETED CLIENT!"); \
      EC->changed = 1; \
+     e_client_dirty_add(EC); \
      INF("%s:%d - EC CHANGED: %p", __FILE__, __LINE__, EC); \
   } while (0)
 #else
-# define EC_CHANGED(EC) EC->changed = 1
+# define EC_CHANGED(EC) \
+  do { \
+     EC->changed = 1; \
+     e_client_dirty_add(EC); \
+  } while (0)
 #endif
 
 #define E_CLIENT_FOREACH(EC) \
@@ -771,6 +778,8 @@ E_API extern int E_EVENT_CLIENT_UNFULLSCREEN;
 
 
 EINTERN void e_client_idler_before(void);
+E_API void e_client_dirty_add(E_Client *ec);
+E_API unsigned int e_client_idler_visited_get(void);
 EINTERN Eina_Bool e_client_init(void);
 EINTERN void e_client_shutdown(void);
 E_API E_Client *e_client_new(E_Pixmap *cp, int first_map, int internal);
@@ -858,6 +867,7 @@ E_API Eina_Bool e_client_has_xwindow(const E_Client *ec);
 E_API Eina_Bool e_client_desk_window_profile_available_check(E_Client *ec, const char *profile);
 E_API void      e_client_desk_window_profile_wait_desk_set(E_Client *ec, E_Desk *desk);
 E_API void      e_client_layout_cb_set(E_Client_Layout_Cb cb);
+E_API void      e_client_prefetch_cb_set(E_Client_Prefetch_Cb cb);
 E_API Eina_List *e_client_stack_list_prepare(E_Client *ec);
 E_API void       e_client_stack_list_finish(Eina_List *list);
 E_API E_Client  *e_client_stack_top_get(E_Client *ec);
@@ -0,0 +1,246 @@
+#include "e.h"
+
+/* uniform grid over the compositor canvas: every client is linked into each
+ * cell its geometry touches, geometry outside of the canvas is clamped to the
+ * border cells. stacking order is resolved lazily, ranks are only reassigned
+ * by a walk of the stack on the first query after something was restacked.
+ */
+#define CELL_SHIFT 8 // 256x256 cells
+
+typedef struct _E_Client_Index_Entry
+{
+   E_Client *ec;
+   int x1, y1, x2, y2; // linked cell range, inclusive; x1 < 0 if unlinked
+   unsigned int rank; // position in the stack, 0 is the top
+   unsigned int mark; // last query which returned this entry
+} E_Client_Index_Entry;
+
+static Eina_Hash *entries = NULL;
+static Eina_List **cells = NULL;
+static int cells_w = 0, cells_h = 0;
+static unsigned int query_serial = 0;
+static Eina_Bool stack_dirty = EINA_TRUE;
+
+static void
+_e_client_index_range_get(int x, int y, int w, int h, int *x1, int *y1, int *x2, int *y2)
+{
+   w = MAX(w, 1), h = MAX(h, 1);
+   *x1 = E_CLAMP(x >> CELL_SHIFT, 0, cells_w - 1);
+   *y1 = E_CLAMP(y >> CELL_SHIFT, 0, cells_h - 1);
+   *x2 = E_CLAMP((x + w - 1) >> CELL_SHIFT, 0, cells_w - 1);
+   *y2 = E_CLAMP((y + h - 1) >> CELL_SHIFT, 0, cells_h - 1);
+}
+
+static void
+_e_client_index_unlink(E_Client_Index_Entry *ent)
+{
+   int x, y;
+
+   if (ent->x1 < 0) return;
+   for (y = ent->y1; y <= ent->y2; y++)
+     for (x = ent->x1; x <= ent->x2; x++)
+       cells[x + (y * cells_w)] = eina_list_remove(cells[x + (y * cells_w)], ent);
+   ent->x1 = -1;
+}
+
+static void
+_e_client_index_link(E_Client_Index_Entry *ent, int x1, int y1, int x2, int y2)
+{
+   int x, y;
+
+   for (y = y1; y <= y2; y++)
+     for (x = x1; x <= x2; x++)
+       cells[x + (y * cells_w)] = eina_list_prepend(cells[x + (y * cells_w)], ent);
+   ent->x1 = x1, ent->y1 = y1;
+   ent->x2 = x2, ent->y2 = y2;
+}
+
+static void
+_e_client_index_entry_free(E_Client_Index_Entry *ent)
+{
+   if (cells) _e_client_index_unlink(ent);
+   free(ent);
+}
+
+static Eina_Bool
+_e_client_index_relink_cb(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED, void *data, void *fdata EINA_UNUSED)
+{
+   E_Client_Index_Entry *ent = data;
+   int x1, y1, x2, y2;
+
+   ent->x1 = -1;
+   _e_client_index_range_get(ent->ec->x, ent->ec->y, ent->ec->w, ent->ec->h, &x1, &y1, &x2, &y2);
+   _e_client_index_link(ent, x1, y1, x2, y2);
+   return EINA_TRUE;
+}
+
+/* the grid follows the canvas size; everything is relinked when it changes */
+static Eina_Bool
+_e_client_index_cells_ensure(void)
+{
+   int w, h, i;
+
+   if (!e_comp) return EINA_FALSE;
+   w = (MAX(e_comp->w, 1) >> CELL_SHIFT) + 1;
+   h = (MAX(e_comp->h, 1) >> CELL_SHIFT) + 1;
+   if (cells && (w == cells_w) && (h == cells_h)) return EINA_TRUE;
+   if (cells)
+     {
+        for (i = 0; i < cells_w * cells_h; i++)
+          eina_list_free(cells[i]);
+        free(cells);
+     }
+   cells = E_NEW(Eina_List*, w * h);
+   if (!cells)
+     {
+        cells_w = cells_h = 0;
+        return EINA_FALSE;
+     }
+   cells_w = w, cells_h = h;
+   eina_hash_foreach(entries, _e_client_index_relink_cb, NULL);
+   return EINA_TRUE;
+}
+
+static void
+_e_client_index_ranks_update(void)
+{
+   E_Client_Index_Entry *ent;
+   E_Client *ec;
+   unsigned int rank = 0;
+
+   if (!stack_dirty) return;
+   E_CLIENT_REVERSE_FOREACH(ec)
+     {
+        ent = eina_hash_find(entries, &ec);
+        if (ent) ent->rank = rank++;
+     }
+   stack_dirty = EINA_FALSE;
+}
+
+static int
+_e_client_index_rank_cmp(const void *a, const void *b)
+{
+   const E_Client_Index_Entry *ea = *(E_Client_Index_Entry * const *)a;
+   const E_Client_Index_Entry *eb = *(E_Client_Index_Entry * const *)b;
+
+   if (ea->rank < eb->rank) return -1;
+   if (ea->rank > eb->rank) return 1;
+   return 0;
+}
+
+EINTERN int
+e_client_index_init(void)
+{
+   entries = eina_hash_pointer_new((Eina_Free_Cb)_e_client_index_entry_free);
+   stack_dirty = EINA_TRUE;
+   return !!entries;
+}
+
+EINTERN int
+e_client_index_shutdown(void)
+{
+   int i;
+
+   E_FREE_FUNC(entries, eina_hash_free);
+   if (cells)
+     {
+        for (i = 0; i < cells_w * cells_h; i++)
+          eina_list_free(cells[i]);
+     }
+   E_FREE(cells);
+   cells_w = cells_h = 0;
+   return 1;
+}
+
+EINTERN void
+e_client_index_update(E_Client *ec)
+{
+   E_Client_Index_Entry *ent;
+   int x1, y1, x2, y2;
+
+   if ((!entries) || e_object_is_del(E_OBJECT(ec))) return;
+   if (!_e_client_index_cells_ensure()) return;
+   ent = eina_hash_find(entries, &ec);
+   if (!ent)
+     {
+        ent = E_NEW(E_Client_Index_Entry, 1);
+        if (!ent) return;
+        ent->ec = ec;
+        ent->x1 = -1;
+        eina_hash_add(entries, &ec, ent);
+        stack_dirty = EINA_TRUE;
+     }
+   _e_client_index_range_get(ec->x, ec->y, ec->w, ec->h, &x1, &y1, &x2, &y2);
+   if ((ent->x1 == x1) && (ent->y1 == y1) && (ent->x2 == x2) && (ent->y2 == y2)) return;
+   _e_client_index_unlink(ent);
+   _e_client_index_link(ent, x1, y1, x2, y2);
+}
+
+EINTERN void
+e_client_index_del(E_Client *ec)
+{
+   if (!entries) return;
+   eina_hash_del_by_key(entries, &ec);
+}
+
+EINTERN void
+e_client_index_stack_changed(void)
+{
+   stack_dirty = EINA_TRUE;
+}
+
+/* returns a list of clients intersecting the given rect, topmost first.
+ * the list must be freed by the caller
+ */
+E_API Eina_List *
+e_client_index_clients_get(int x, int y, int w, int h)
+{
+   E_Client_Index_Entry *ent, **found = NULL, **tmp;
+   Eina_List *l, *ret = NULL;
+   unsigned int num = 0, size = 0, i;
+   int cx, cy, x1, y1, x2, y2;
+
+   if ((!entries) || (!_e_client_index_cells_ensure())) return NULL;
+   _e_client_index_ranks_update();
+   w = MAX(w, 1), h = MAX(h, 1);
+   query_serial++;
+   _e_client_index_range_get(x, y, w, h, &x1, &y1, &x2, &y2);
+   for (cy = y1; cy <= y2; cy++)
+     for (cx = x1; cx <= x2; cx++)
+       EINA_LIST_FOREACH(cells[cx + (cy * cells_w)], l, ent)
+         {
+            if (ent->mark == query_serial) continue;
+            ent->mark = query_serial;
+            if (!E_INTERSECTS(x, y, w, h, ent->ec->x, ent->ec->y, MAX(ent->ec->w, 1), MAX(ent->ec->h, 1)))
+              continue;
+            if (num == size)
+              {
+                 size = size ? size * 2 : 16;
+                 tmp = realloc(found, sizeof(E_Client_Index_Entry*) * size);
+                 if (!tmp) goto out;
+                 found = tmp;
+              }
+            found[num++] = ent;
+         }
+out:
+   if (num > 1)
+     qsort(found, num, sizeof(E_Client_Index_Entry*), _e_client_index_rank_cmp);
+   for (i = 0; i < num; i++)
+     ret = eina_list_append(ret, found[i]->ec);
+   free(found);
+   return ret;
+}
+
+/* whether ec is above 'below' in the stack */
+E_API Eina_Bool
+e_client_index_stacked_above(const E_Client *ec, const E_Client *below)
+{
+   E_Client_Index_Entry *a, *b;
+
+   if ((!entries) || (!ec) || (!below)) return EINA_FALSE;
+   _e_client_index_ranks_update();
+   a = eina_hash_find(entries, &ec);
+   b = eina_hash_find(entries, &below);
+   if ((!a) || (!b)) return EINA_FALSE;
+   return a->rank < b->rank;
+}
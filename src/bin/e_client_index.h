@@ -0,0 +1,23 @@
+#ifdef E_TYPEDEFS
+
+#else
+#ifndef E_CLIENT_INDEX_H
+#define E_CLIENT_INDEX_H
+
+/* spatial index of client geometry for hit-testing and overlap queries.
+ * results are ordered from the top of the stack down and only filtered by
+ * geometry: callers still apply their own visibility/desk checks.
+ */
+
+EINTERN int e_client_index_init(void);
+EINTERN int e_client_index_shutdown(void);
+
+EINTERN void e_client_index_update(E_Client *ec);
+EINTERN void e_client_index_del(E_Client *ec);
+EINTERN void e_client_index_stack_changed(void);
+
+E_API Eina_List *e_client_index_clients_get(int x, int y, int w, int h);
+E_API Eina_Bool  e_client_index_stacked_above(const E_Client *ec, const E_Client *below);
+
+#endif
+#endif
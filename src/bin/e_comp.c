@@ -297,10 +297,13 @@ static void
 _e_comp_client_update(E_Client *ec)
 {
    int pw, ph;
+   double t0;
 
    DBG("UPDATE [%p] pm = %p", ec, ec->pixmap);
    if (e_object_is_del(E_OBJECT(ec))) return;
 
+   t0 = e_comp_profiler_stage_begin(E_COMP_PROFILER_STAGE_CLIENT_UPDATE);
+
    e_pixmap_size_get(ec->pixmap, &pw, &ph);
 
    if (e_pixmap_dirty_get(ec->pixmap) && (!e_comp->nocomp))
@@ -333,6 +336,7 @@ _e_comp_client_update(E_Client *ec)
         if (e_pixmap_is_x(ec->pixmap) && (!ec->override))
           evas_object_resize(ec->frame, ec->w, ec->h);
      }
+   e_comp_profiler_stage_end(E_COMP_PROFILER_STAGE_CLIENT_UPDATE, t0, ec, 0);
 }
 
 static void
@@ -365,7 +369,7 @@ static Eina_Bool
 _e_comp_cb_update(void)
 {
    E_Client *ec;
-   Eina_List *l;
+   unsigned int serial;
    //   static int doframeinfo = -1;
 
    if (!e_comp) return EINA_FALSE;
@@ -375,20 +379,18 @@ _e_comp_cb_update(void)
      ecore_animator_freeze(e_comp->render_animator);
    DBG("UPDATE ALL");
    if (e_comp->nocomp) goto nocomp;
+   e_comp_profiler_frame_begin();
    if (conf->grab && (!e_comp->grabbed))
      {
         if (e_comp->grab_cb) e_comp->grab_cb();
         e_comp->grabbed = 1;
      }
    e_comp->updating = 1;
-   l = e_comp->updates;
-   e_comp->updates = NULL;
-   EINA_LIST_FREE(l, ec)
-     {
-        /* clear update flag */
-        e_comp_object_render_update_del(ec->frame);
-        _e_comp_client_update(ec);
-     }
+   e_comp_profiler_queued_set(e_comp_object_render_updates_count());
+   /* clients queued again while updating are handled on the next frame */
+   serial = e_comp_object_render_updates_begin();
+   while ((ec = e_comp_object_render_updates_next(serial)))
+     _e_comp_client_update(ec);
    e_comp->updating = 0;
    _e_comp_fps_update();
    if (conf->fps_show)
@@ -461,7 +463,7 @@ _e_comp_cb_update(void)
         if (e_comp->grab_cb) e_comp->grab_cb();
         e_comp->grabbed = 0;
      }
-   if (e_comp->updates && (!e_comp->update_job))
+   if (e_comp_object_render_updates_count() && (!e_comp->update_job))
      ecore_animator_thaw(e_comp->render_animator);
    /*
       if (doframeinfo == -1)
@@ -582,8 +584,123 @@ _e_comp_shapes_update_object_checker_function_thingy(Evas_Object *o)
    return EINA_FALSE;
 }
 
+/* x11 input shapes are computed by replaying tiler adds and dels for every
+ * object from the bottom client up. the ops of the last update are kept along
+ * with a snapshot of the tiler region every SHAPE_CHECKPOINT_OPS ops, so an
+ * update only replays the ops above the lowest object which changed.
+ */
+#define SHAPE_CHECKPOINT_OPS 64
+#define SHAPE_OP_EQ(a, b) (((a)->del == (b)->del) && \
+                           ((a)->rect.x == (b)->rect.x) && ((a)->rect.y == (b)->rect.y) && \
+                           ((a)->rect.w == (b)->rect.w) && ((a)->rect.h == (b)->rect.h))
+
+typedef struct _E_Comp_Shape_Op
+{
+   Eina_Rectangle rect;
+   Eina_Bool del;
+} E_Comp_Shape_Op;
+
+typedef struct _E_Comp_Shape_Ops
+{
+   E_Comp_Shape_Op *ops;
+   unsigned int num, size;
+} E_Comp_Shape_Ops;
+
+typedef struct _E_Comp_Shape_Region
+{
+   Eina_Rectangle *rects;
+   unsigned int num;
+   Eina_Bool valid;
+} E_Comp_Shape_Region;
+
+static E_Comp_Shape_Ops shape_ops[2]; //last update, current update
+static E_Comp_Shape_Region *shape_checkpoints = NULL; //region after every SHAPE_CHECKPOINT_OPS ops
+static unsigned int shape_checkpoints_num = 0;
+static unsigned int shape_checkpoints_size = 0;
+static E_Comp_Shape_Region shape_region = { NULL, 0, 0 }; //region last set on the window
+
+static void
+_e_comp_shapes_op_add(E_Comp_Shape_Ops *ops, Eina_Bool del, const Eina_Rectangle *rect)
+{
+   if (ops->num == ops->size)
+     {
+        E_Comp_Shape_Op *tmp;
+        unsigned int size = ops->size ? ops->size * 2 : 128;
+
+        tmp = realloc(ops->ops, sizeof(E_Comp_Shape_Op) * size);
+        EINA_SAFETY_ON_NULL_RETURN(tmp);
+        ops->ops = tmp;
+        ops->size = size;
+     }
+   ops->ops[ops->num].rect = *rect;
+   ops->ops[ops->num].del = !!del;
+   ops->num++;
+}
+
 static void
-_e_comp_shapes_update_comp_client_shape_comp_helper(E_Client *ec, Eina_Tiler *tb, Eina_List **rl)
+_e_comp_shapes_region_get(Eina_Tiler *tb, E_Comp_Shape_Region *region)
+{
+   Eina_Iterator *it;
+   Eina_Rectangle *rect;
+   unsigned int size = 0;
+
+   region->num = 0;
+   it = eina_tiler_iterator_new(tb);
+   EINA_ITERATOR_FOREACH(it, rect)
+     {
+        if (region->num == size)
+          {
+             Eina_Rectangle *tmp;
+
+             size = size ? size * 2 : 32;
+             tmp = realloc(region->rects, sizeof(Eina_Rectangle) * size);
+             if (!tmp) break;
+             region->rects = tmp;
+          }
+        region->rects[region->num++] = *rect;
+     }
+   eina_iterator_free(it);
+}
+
+static void
+_e_comp_shapes_checkpoint_add(Eina_Tiler *tb)
+{
+   if (shape_checkpoints_num == shape_checkpoints_size)
+     {
+        E_Comp_Shape_Region *tmp;
+        unsigned int size = shape_checkpoints_size ? shape_checkpoints_size * 2 : 16;
+
+        tmp = realloc(shape_checkpoints, sizeof(E_Comp_Shape_Region) * size);
+        EINA_SAFETY_ON_NULL_RETURN(tmp);
+        memset(tmp + shape_checkpoints_size, 0, sizeof(E_Comp_Shape_Region) * (size - shape_checkpoints_size));
+        shape_checkpoints = tmp;
+        shape_checkpoints_size = size;
+     }
+   _e_comp_shapes_region_get(tb, &shape_checkpoints[shape_checkpoints_num]);
+   shape_checkpoints_num++;
+}
+
+static void
+_e_comp_shapes_cache_free(void)
+{
+   unsigned int i;
+
+   for (i = 0; i < shape_checkpoints_size; i++)
+     free(shape_checkpoints[i].rects);
+   E_FREE(shape_checkpoints);
+   shape_checkpoints_num = shape_checkpoints_size = 0;
+   for (i = 0; i < EINA_C_ARRAY_LENGTH(shape_ops); i++)
+     {
+        E_FREE(shape_ops[i].ops);
+        shape_ops[i].num = shape_ops[i].size = 0;
+     }
+   E_FREE(shape_region.rects);
+   shape_region.num = 0;
+   shape_region.valid = EINA_FALSE;
+}
+
+static void
+_e_comp_shapes_update_comp_client_shape_comp_helper(E_Client *ec, E_Comp_Shape_Ops *ops, Eina_List **rl)
 {
    int x, y, w, h;
 
@@ -614,22 +731,22 @@ _e_comp_shapes_update_comp_client_shape_comp_helper(E_Client *ec, Eina_Tiler *tb
           {
              if (t - y)
                {
-                  eina_tiler_rect_add(tb, &(Eina_Rectangle){ec->x + x, ec->y + y, w, t - y});
+                  _e_comp_shapes_op_add(ops, EINA_FALSE, &(Eina_Rectangle){ec->x + x, ec->y + y, w, t - y});
                   SHAPE_INF("ADD: %d,%d@%dx%d", ec->x + x, ec->y + y, w, t - y);
                }
              if (l - x)
                {
-                  eina_tiler_rect_add(tb, &(Eina_Rectangle){ec->x + x, ec->y + y, l - x, h});
+                  _e_comp_shapes_op_add(ops, EINA_FALSE, &(Eina_Rectangle){ec->x + x, ec->y + y, l - x, h});
                   SHAPE_INF("ADD: %d,%d@%dx%d", ec->x + x, ec->y + y, l - x, h);
                }
              if (r + (w - ec->w + x))
                {
-                  eina_tiler_rect_add(tb, &(Eina_Rectangle){ec->x + l + ec->client.w + x, ec->y + y, r + (w - ec->w + x), h});
+                  _e_comp_shapes_op_add(ops, EINA_FALSE, &(Eina_Rectangle){ec->x + l + ec->client.w + x, ec->y + y, r + (w - ec->w + x), h});
                   SHAPE_INF("ADD: %d,%d@%dx%d", ec->x + l + ec->client.w + x, ec->y + y, r + (w - ec->w + x), h);
                }
              if (b + (h - ec->h + y))
                {
-                  eina_tiler_rect_add(tb, &(Eina_Rectangle){ec->x + x, ec->y + t + ec->client.h + y, w, b + (h - ec->h + y)});
+                  _e_comp_shapes_op_add(ops, EINA_FALSE, &(Eina_Rectangle){ec->x + x, ec->y + t + ec->client.h + y, w, b + (h - ec->h + y)});
                   SHAPE_INF("ADD: %d,%d@%dx%d", ec->x + x, ec->y + t + ec->client.h + y, w, b + (h - ec->h + y));
                }
           }
@@ -646,7 +763,7 @@ _e_comp_shapes_update_comp_client_shape_comp_helper(E_Client *ec, Eina_Tiler *tb
              //EINA_RECTANGLE_SET(r, x, y, w, h);
              //rl = eina_list_append(rl, r);
    //#endif
-             eina_tiler_rect_del(tb, &(Eina_Rectangle){x, y, w, h});
+             _e_comp_shapes_op_add(ops, EINA_TRUE, &(Eina_Rectangle){x, y, w, h});
              SHAPE_INF("DEL: %d,%d@%dx%d", x, y, w, h);
           }
         return;
@@ -665,20 +782,20 @@ _e_comp_shapes_update_comp_client_shape_comp_helper(E_Client *ec, Eina_Tiler *tb
      {
         e_comp_object_frame_extends_get(ec->frame, &x, &y, &w, &h);
         /* add the frame */
-        eina_tiler_rect_add(tb, &(Eina_Rectangle){ec->x + x, ec->y + y, w, h});
+        _e_comp_shapes_op_add(ops, EINA_FALSE, &(Eina_Rectangle){ec->x + x, ec->y + y, w, h});
         SHAPE_INF("ADD: %d,%d@%dx%d", ec->x + x, ec->y + y, w, h);
      }
 
    if ((!ec->shaded) && (!ec->shading))
      {
         /* delete the client if not shaded */
-        eina_tiler_rect_del(tb, &(Eina_Rectangle){ec->client.x, ec->client.y, ec->client.w, ec->client.h});
+        _e_comp_shapes_op_add(ops, EINA_TRUE, &(Eina_Rectangle){ec->client.x, ec->client.y, ec->client.w, ec->client.h});
         SHAPE_INF("DEL: %d,%d@%dx%d", ec->client.x, ec->client.y, ec->client.w, ec->client.h);
      }
 }
 
 static void
-_e_comp_shapes_update_object_shape_comp_helper(Evas_Object *o, Eina_Tiler *tb)
+_e_comp_shapes_update_object_shape_comp_helper(Evas_Object *o, E_Comp_Shape_Ops *ops)
 {
    int x, y, w, h;
 
@@ -695,36 +812,38 @@ _e_comp_shapes_update_object_shape_comp_helper(Evas_Object *o, Eina_Tiler *tb)
         if (content)
           evas_object_geometry_get(content, &x, &y, &w, &h);
      }
-   eina_tiler_rect_add(tb, &(Eina_Rectangle){x, y, w, h});
+   _e_comp_shapes_op_add(ops, EINA_FALSE, &(Eina_Rectangle){x, y, w, h});
    SHAPE_INF("ADD: %d,%d@%dx%d", x, y, w, h);
 }
 
 static void
 _e_comp_shapes_update_job(void *d EINA_UNUSED)
 {
+   E_Comp_Shape_Ops *ops = &shape_ops[1], *prev = &shape_ops[0], tmp;
+   E_Comp_Shape_Region region = { NULL, 0, 0 };
    Eina_Tiler *tb;
    E_Client *ec;
    Evas_Object *o = NULL;
    Eina_Rectangle *tr;
-   Eina_Iterator *ti;
-   Eina_Rectangle *exr;
-   unsigned int i, tile_count;
+   unsigned int i, first, cp;
    Ecore_Window win;
    Eina_Rectangle *r;
    Eina_List *rl = NULL;
    E_Color color = {0};
+   double t0;
 
    SHAPE_INF("---------------------");
 
+   t0 = e_comp_profiler_stage_begin(E_COMP_PROFILER_STAGE_SHAPE);
+
    if (e_comp->comp_type == E_PIXMAP_TYPE_X)
      win = e_comp->win;
    else
      win = e_comp->cm_selection;
    E_FREE_LIST(e_comp->debug_rects, evas_object_del);
-   tb = eina_tiler_new(e_comp->w, e_comp->h);
-   eina_tiler_tile_size_set(tb, 1, 1);
+   ops->num = 0;
    /* background */
-   eina_tiler_rect_add(tb, &(Eina_Rectangle){0, 0, e_comp->w, e_comp->h});
+   _e_comp_shapes_op_add(ops, EINA_FALSE, &(Eina_Rectangle){0, 0, e_comp->w, e_comp->h});
 
    ec = e_client_bottom_get();
    if (ec) o = ec->frame;
@@ -735,34 +854,70 @@ _e_comp_shapes_update_job(void *d EINA_UNUSED)
         layer = evas_object_layer_get(o);
         if (e_comp_canvas_client_layer_map(layer) == 9999) //not a client layer
           {
-             _e_comp_shapes_update_object_shape_comp_helper(o, tb);
+             _e_comp_shapes_update_object_shape_comp_helper(o, ops);
              continue;
           }
         ec = e_comp_object_client_get(o);
         if (ec && (!ec->no_shape_cut))
-          _e_comp_shapes_update_comp_client_shape_comp_helper(ec, tb
+          _e_comp_shapes_update_comp_client_shape_comp_helper(ec, ops
                                                            ,&rl
                                                           );
 
         else
-          _e_comp_shapes_update_object_shape_comp_helper(o, tb);
+          _e_comp_shapes_update_object_shape_comp_helper(o, ops);
      }
 
-   ti = eina_tiler_iterator_new(tb);
-   tile_count = 128;
-   exr = malloc(sizeof(Eina_Rectangle) * tile_count);
-   i = 0;
-   EINA_ITERATOR_FOREACH(ti, tr)
+   /* only the ops above the first one which changed since the last update
+    * need to be replayed, starting from the closest checkpoint below it
+    */
+   first = 0;
+   if ((!shape_debug) && shape_region.valid)
      {
-        exr[i++] = *((Eina_Rectangle *)tr);
-        if (i == tile_count - 1)
-          exr = realloc(exr, sizeof(Eina_Rectangle) * (tile_count *= 2));
-        if (shape_debug)
+        unsigned int n = MIN(ops->num, prev->num);
+
+        for (; first < n; first++)
+          if (!SHAPE_OP_EQ(&ops->ops[first], &prev->ops[first])) break;
+        if ((first == ops->num) && (ops->num == prev->num))
+          {
+             SHAPE_INF("UNCHANGED");
+             i = 0;
+             goto done;
+          }
+     }
+   cp = MIN(first / SHAPE_CHECKPOINT_OPS, shape_checkpoints_num);
+   tb = eina_tiler_new(e_comp->w, e_comp->h);
+   eina_tiler_tile_size_set(tb, 1, 1);
+   if (cp)
+     {
+        E_Comp_Shape_Region *seed = &shape_checkpoints[cp - 1];
+
+        for (i = 0; i < seed->num; i++)
+          eina_tiler_rect_add(tb, &seed->rects[i]);
+     }
+   shape_checkpoints_num = cp;
+   SHAPE_INF("REPLAY %u/%u OPS FROM %u", ops->num - (cp * SHAPE_CHECKPOINT_OPS), ops->num, first);
+   for (i = cp * SHAPE_CHECKPOINT_OPS; i < ops->num; i++)
+     {
+        E_Comp_Shape_Op *op = &ops->ops[i];
+
+        if (op->del)
+          eina_tiler_rect_del(tb, &op->rect);
+        else
+          eina_tiler_rect_add(tb, &op->rect);
+        if ((!((i + 1) % SHAPE_CHECKPOINT_OPS)) && (i + 1 < ops->num))
+          _e_comp_shapes_checkpoint_add(tb);
+     }
+
+   _e_comp_shapes_region_get(tb, &region);
+   if (shape_debug)
+     {
+        for (i = 0; i < region.num; i++)
           {
              Eina_List *l;
 
-             _e_comp_shape_debug_rect(&exr[i - 1], &color);
-             SHAPE_INF("%d,%d @ %dx%d", exr[i - 1].x, exr[i - 1].y, exr[i - 1].w, exr[i - 1].h);
+             tr = &region.rects[i];
+             _e_comp_shape_debug_rect(tr, &color);
+             SHAPE_INF("%d,%d @ %dx%d", tr->x, tr->y, tr->w, tr->h);
              EINA_LIST_FOREACH(rl, l, r)
                {
                   if (E_INTERSECTS(r->x, r->y, r->w, r->h, tr->x, tr->y, tr->w, tr->h))
@@ -770,20 +925,35 @@ _e_comp_shapes_update_job(void *d EINA_UNUSED)
                }
           }
      }
+   i = region.num;
 
+   /* identical regions don't need another round trip to the server */
+   if ((!shape_region.valid) || (region.num != shape_region.num) ||
+       memcmp(region.rects, shape_region.rects, sizeof(Eina_Rectangle) * region.num))
+     {
 #ifndef HAVE_WAYLAND_ONLY
-   ecore_x_window_shape_input_rectangles_set(win, (Ecore_X_Rectangle*)exr, i);
+        ecore_x_window_shape_input_rectangles_set(win, (Ecore_X_Rectangle*)region.rects, region.num);
 #endif
+     }
+   else
+     SHAPE_INF("REGION UNCHANGED");
+   free(shape_region.rects);
+   shape_region = region;
+   shape_region.valid = EINA_TRUE;
+   eina_tiler_free(tb);
 
+done:
+   /* keep this update's ops to compare the next update against */
+   tmp = *prev;
+   *prev = *ops;
+   *ops = tmp;
    if (shape_debug)
      {
         E_FREE_LIST(rl, free);
         printf("\n");
      }
-   free(exr);
-   eina_iterator_free(ti);
-   eina_tiler_free(tb);
    e_comp->shape_job = NULL;
+   e_comp_profiler_stage_end(E_COMP_PROFILER_STAGE_SHAPE, t0, NULL, i);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -848,6 +1018,7 @@ _e_comp_free(E_Comp *c)
    if (c->nocomp_delay_timer) ecore_timer_del(c->nocomp_delay_timer);
    if (c->nocomp_override_timer) ecore_timer_del(c->nocomp_override_timer);
    ecore_job_del(c->shape_job);
+   _e_comp_shapes_cache_free();
    free(c->canvas);
    free(c);
 }
@@ -991,6 +1162,28 @@ _e_comp_act_redirect_toggle_go(E_Object * obj EINA_UNUSED, const char *params EI
    e_comp_client_redirect_toggle(ec);
 }
 
+static void
+_e_comp_act_profiler_toggle_go(E_Object * obj EINA_UNUSED, const char *params EINA_UNUSED)
+{
+   e_comp_profiler_enabled_set(!e_comp_profiler_enabled_get());
+}
+
+static void
+_e_comp_act_profiler_dump_go(E_Object * obj EINA_UNUSED, const char *params)
+{
+   char buf[PATH_MAX];
+
+   if (params && params[0])
+     eina_strlcpy(buf, params, sizeof(buf));
+   else
+     snprintf(buf, sizeof(buf), "%s/comp-profile-%lld.json",
+              e_user_dir_get(), (long long)ecore_time_unix_get());
+   if (!e_comp_profiler_dump(buf))
+     ERR("Could not write frame profile to '%s'", buf);
+   else
+     INF("Frame profile written to '%s'", buf);
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 static void
@@ -1046,6 +1239,11 @@ e_comp_init(void)
              // going from version 0 we should disable grab for smoothness
              conf->grab = 0;
              /* fallthrough */
+           case 1:
+             conf->damage_coalesce = 1;
+             conf->damage_rect_cost = 4096;
+             conf->damage_rects_max = 512;
+             /* fallthrough */
            default:
              break;
           }
@@ -1074,7 +1272,20 @@ e_comp_init(void)
                                N_("Toggle focused client's redirect state"), "redirect_toggle",
                                NULL, NULL, 0);
       actions = eina_list_append(actions, act);
+      act = e_action_add("comp_profiler_toggle");
+      act->func.go = _e_comp_act_profiler_toggle_go;
+      e_action_predef_name_set(N_("Compositor"),
+                               N_("Toggle frame profiler"), "comp_profiler_toggle",
+                               NULL, NULL, 0);
+      actions = eina_list_append(actions, act);
+      act = e_action_add("comp_profiler_dump");
+      act->func.go = _e_comp_act_profiler_dump_go;
+      e_action_predef_name_set(N_("Compositor"),
+                               N_("Dump frame profile"), "comp_profiler_dump",
+                               NULL, "syntax: file to write the trace to (default: ~/.e/e/comp-profile-<time>.json)", 1);
+      actions = eina_list_append(actions, act);
    }
+   e_comp_profiler_init();
 
    e_comp_new();
    e_comp->comp_type = E_PIXMAP_TYPE_NONE;
@@ -1403,6 +1614,7 @@ e_comp_shutdown(void)
    E_FREE_LIST(handlers, ecore_event_handler_del);
    E_FREE_LIST(actions, e_object_del);
    E_FREE_LIST(hooks, e_client_hook_del);
+   e_comp_profiler_shutdown();
 
    gl_avail = EINA_FALSE;
    e_comp_cfdata_config_free(conf);
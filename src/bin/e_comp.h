@@ -137,7 +137,6 @@ struct _E_Comp
    Eina_List *debug_rects; //used when SHAPE_DEBUG is defined in e_comp.c
    Eina_List *ignore_wins; //windows to be ignored by the compositor
 
-   Eina_List      *updates; //E_Clients with render updates
    Eina_List      *post_updates; //E_Clients awaiting post render flushing
    Ecore_Animator *render_animator; //animator for fixed time rendering
    Ecore_Job      *shape_job; //job to update x11 input shapes
@@ -54,6 +54,7 @@ _e_comp_canvas_render_post(void *data EINA_UNUSED, Evas *e EINA_UNUSED, void *ev
      //}
 
    e_comp->rendering = EINA_FALSE;
+   e_comp_profiler_render_post();
 
    EINA_LIST_FREE(e_comp->post_updates, ec)
      {
@@ -356,6 +357,7 @@ _e_comp_canvas_prerender(void *data EINA_UNUSED, Evas *e EINA_UNUSED, void *even
    Eina_List *l;
 
    e_comp->rendering = EINA_TRUE;
+   e_comp_profiler_render_pre();
 
    EINA_LIST_FOREACH(e_comp->pre_render_cbs, l, cb)
      cb();
@@ -53,6 +53,9 @@ e_comp_cfdata_edd_init(E_Config_DD **conf_edd, E_Config_DD **match_edd)
    E_CONFIG_VAL(D, T, nofade, UCHAR);
    E_CONFIG_VAL(D, T, smooth_windows, UCHAR);
    E_CONFIG_VAL(D, T, first_draw_delay, DOUBLE);
+   E_CONFIG_VAL(D, T, damage_coalesce, UCHAR);
+   E_CONFIG_VAL(D, T, damage_rect_cost, INT);
+   E_CONFIG_VAL(D, T, damage_rects_max, INT);
    E_CONFIG_VAL(D, T, disable_screen_effects, UCHAR);
    E_CONFIG_VAL(D, T, enable_advanced_features, UCHAR);
    E_CONFIG_VAL(D, T, fast_popups, UCHAR);
@@ -104,6 +107,9 @@ e_comp_cfdata_config_new(void)
    cfg->nofade = 0;
    cfg->smooth_windows = 0; // 1 if gl, 0 if not
    cfg->first_draw_delay = 0.15;
+   cfg->damage_coalesce = 1;
+   cfg->damage_rect_cost = 4096; // 64x64
+   cfg->damage_rects_max = 512; // same as evas
 
    cfg->match.popups = NULL;
 
@@ -5,7 +5,7 @@ typedef struct _E_Comp_Match  E_Comp_Match;
 #ifndef E_COMP_CFDATA_H
 #define E_COMP_CFDATA_H
 
-#define E_COMP_VERSION 1
+#define E_COMP_VERSION 2
 struct _E_Comp_Config
 {
    int           version;
@@ -30,6 +30,9 @@ struct _E_Comp_Config
    unsigned char smooth_windows;
    unsigned char nofade;
    double        first_draw_delay;
+   unsigned char damage_coalesce; // merge damage rects by cost and learn full damage per client
+   int           damage_rect_cost; // cost of one extra damage rect, in pixels
+   int           damage_rects_max; // damage calls per frame before falling back to full damage
    Eina_Bool disable_screen_effects;
    Eina_Bool enable_advanced_features;
    // the following options add the "/fast" suffix to the normal groups
@@ -1,4 +1,9 @@
 #include "e.h"
+#if defined(__SSE2__)
+# include <immintrin.h>
+#elif defined(__ARM_NEON)
+# include <arm_neon.h>
+#endif
 
 /* data keys:
 
@@ -20,6 +25,9 @@
 */
 
 #define UPDATE_MAX 512 // same as evas
+#define DAMAGE_FULL_LEAVE 0.75 // learned cost ratio below which full damage is dropped
+#define DAMAGE_PROBE_FRAMES 32 // full damage frames between partial damage probes
+#define DAMAGE_MERGE_WINDOW 16 // previous rects considered when coalescing
 #define FAILURE_MAX 2 // seems reasonable
 #define SMART_NAME     "e_comp_object"
 
@@ -53,7 +61,7 @@ static int render_debug_enabled;
 
 typedef struct _E_Comp_Object
 {
-   //EINA_INLIST;
+   EINA_INLIST; // render update queue
 
    int                  x, y, w, h;  // geometry
    Eina_Tiler          *input_area;
@@ -92,9 +100,21 @@ typedef struct _E_Comp_Object
 
    Evas_Native_Surface *ns; //for custom gl rendering
 
+   unsigned int        *shape_pix; //buffer the shape mask was last applied to
+   int                  shape_w, shape_h; //size the shape mask was last applied at
+   int                  render_y1, render_y2; //rows updated by the last render
+   unsigned int        *wl_pix; //copy of a wayland shm buffer for partial updates
+   int                  wl_pix_w, wl_pix_h; //size of wl_pix
+
    double               action_client_loop_time; //loop time when client's action ended
 
    unsigned int         update_count;  // how many updates have happened to this obj
+   unsigned int         damage_rects; // damage calls since the last dirty
+   unsigned long long   damage_area; // clipped damage area since the last dirty
+   double               damage_ratio; // learned partial/full update cost ratio
+   unsigned int         damage_frames; // consecutive frames using learned full damage
+   unsigned int         update_serial; // render update queue serial when queued
+   unsigned int         update_prio; // render update queue this obj is on
 
    unsigned int         opacity;  // opacity set with _NET_WM_WINDOW_OPACITY
 
@@ -123,6 +143,7 @@ typedef struct _E_Comp_Object
    Eina_Bool            zoomap_disabled E_BITFIELD; //whether zoomap is usable
    Eina_Bool            updates_exist E_BITFIELD;
    Eina_Bool            updates_full E_BITFIELD; // entire object will be updated
+   Eina_Bool            damage_full E_BITFIELD; // full damage is learned to be cheaper
 
    Eina_Bool            force_move E_BITFIELD;
    Eina_Bool            frame_extends E_BITFIELD; //frame may extend beyond object size
@@ -144,9 +165,35 @@ struct E_Comp_Object_Mover
 static Eina_Inlist *_e_comp_object_movers = NULL;
 static Evas_Smart *_e_comp_smart = NULL;
 
+/* render update queues: objects are queued at most once, in order of
+ * addition, on the queue for their priority. the serial keeps objects which
+ * are queued again while the queues are being processed for the next frame.
+ */
+enum
+{
+   UPDATE_PRIO_HIGH, // focused or fullscreen
+   UPDATE_PRIO_NORMAL,
+   UPDATE_PRIO_LAST
+};
+static Eina_Inlist *_e_comp_object_updates[UPDATE_PRIO_LAST];
+static unsigned int _e_comp_object_updates_count = 0;
+static unsigned int _e_comp_object_updates_serial = 0;
+
+static void
+_e_comp_object_render_update_unlink(E_Comp_Object *cw)
+{
+   if (!cw->update) return;
+   cw->update = 0;
+   _e_comp_object_updates[cw->update_prio] =
+     eina_inlist_remove(_e_comp_object_updates[cw->update_prio], EINA_INLIST_GET(cw));
+   _e_comp_object_updates_count--;
+}
+
 /* sekrit functionzzz */
 EINTERN void e_client_focused_set(E_Client *ec);
 
+static void _e_comp_object_shape_apply(E_Comp_Object *cw, int y1, int y2);
+
 /* emitted every time a new noteworthy comp object is added */
 E_API int E_EVENT_COMP_OBJECT_ADD = -1;
 
@@ -331,6 +378,110 @@ _e_comp_object_layers_remove(E_Comp_Object *cw)
 }
 
 /////////////////////////////////////
+
+/* damage on large surfaces is snapped to a coarser tile grid so the tiler
+ * produces fewer, larger rects; a tile never costs more than an extra rect
+ */
+static void
+_e_comp_object_updates_tile_size_set(Eina_Tiler *t, int w, int h)
+{
+   E_Comp_Config *conf = e_comp_config_get();
+   int ts = 1;
+
+   if (conf->damage_coalesce)
+     {
+        while ((ts < 32) && (ts * ts * 4 <= conf->damage_rect_cost) &&
+               ((unsigned long long)(w / (ts * 2)) * (h / (ts * 2)) >= 4096))
+          ts *= 2;
+     }
+   eina_tiler_tile_size_set(t, ts, ts);
+}
+
+static unsigned long long
+_e_comp_object_rect_area(const Eina_Rectangle *r)
+{
+   return (unsigned long long)r->w * r->h;
+}
+
+/* merge rects whose bounding box wastes fewer pixels than the cost of
+ * processing an extra rect. only the most recent output rects are checked,
+ * which keeps this linear for the row ordered output of the tiler.
+ * returns the new number of rects
+ */
+static unsigned int
+_e_comp_object_damage_coalesce(Eina_Rectangle *r, unsigned int num, unsigned long long cost)
+{
+   unsigned int i, j, out = 0;
+
+   for (i = 0; i < num; i++)
+     {
+        Eina_Rectangle cur = r[i];
+        Eina_Bool merged;
+
+        do
+          {
+             merged = EINA_FALSE;
+             for (j = (out > DAMAGE_MERGE_WINDOW) ? out - DAMAGE_MERGE_WINDOW : 0; j < out; j++)
+               {
+                  Eina_Rectangle bb = cur, in = cur;
+                  unsigned long long used;
+
+                  eina_rectangle_union(&bb, &r[j]);
+                  used = _e_comp_object_rect_area(&cur) + _e_comp_object_rect_area(&r[j]);
+                  if (eina_rectangle_intersection(&in, &r[j]))
+                    used -= _e_comp_object_rect_area(&in);
+                  if (_e_comp_object_rect_area(&bb) - used > cost) continue;
+                  cur = bb;
+                  r[j] = r[--out];
+                  merged = EINA_TRUE;
+                  break;
+               }
+          }
+        while (merged);
+        r[out++] = cur;
+     }
+   return out;
+}
+
+/* update the learned cost of partial damage for a client once per frame:
+ * partial updates cost their area plus a fixed cost per rect, full updates
+ * cost the surface area plus one rect. while full damage is in use, the
+ * per-call damage is an upper bound, so every DAMAGE_PROBE_FRAMES frame is
+ * processed as partial damage to measure it exactly.
+ */
+static void
+_e_comp_object_damage_learn(E_Comp_Object *cw, int w, int h, Eina_Bool full, unsigned long long area, unsigned int rects)
+{
+   E_Comp_Config *conf = e_comp_config_get();
+   unsigned long long total = (unsigned long long)w * h;
+   double cost, ratio;
+
+   if ((!conf->damage_coalesce) || (!total))
+     {
+        cw->damage_full = 0;
+        cw->damage_ratio = 0.0;
+        cw->damage_frames = 0;
+        return;
+     }
+   if (!cw->damage_rects) return;
+   if (full)
+     area = cw->damage_area, rects = cw->damage_rects;
+   cost = MAX(conf->damage_rect_cost, 0);
+   ratio = ((double)MIN(area, total) + (rects * cost)) / ((double)total + cost);
+   if (cw->damage_full && (!full))
+     cw->damage_ratio = ratio;
+   else
+     cw->damage_ratio += (ratio - cw->damage_ratio) * 0.25;
+   if (cw->damage_full)
+     cw->damage_full = cw->damage_ratio >= DAMAGE_FULL_LEAVE;
+   else
+     cw->damage_full = cw->damage_ratio >= 1.0;
+   if (cw->damage_full)
+     cw->damage_frames++;
+   else
+     cw->damage_frames = 0;
+}
+
 static void
 _e_comp_object_updates_init(E_Comp_Object *cw)
 {
@@ -343,7 +494,7 @@ _e_comp_object_updates_init(E_Comp_Object *cw)
    if ((!pw) || (!ph)) return;
    cw->updates = eina_tiler_new(pw, ph);
    if (cw->updates)
-     eina_tiler_tile_size_set(cw->updates, 1, 1);
+     _e_comp_object_updates_tile_size_set(cw->updates, pw, ph);
 }
 
 
@@ -984,7 +1135,7 @@ _e_comp_object_pixels_get(void *data, Evas_Object *obj)
      {
         /* apply shape mask if necessary */
         if ((!cw->native) && (ec->shaped || ec->shape_changed))
-          e_comp_object_shape_apply(ec->frame);
+          _e_comp_object_shape_apply(cw, cw->render_y1, cw->render_y2);
         ec->shape_changed = 0;
      }
    if (e_object_is_del(E_OBJECT(ec))) return;
@@ -1059,6 +1210,7 @@ _e_comp_intercept_move(void *data, Evas_Object *obj, int x, int y)
              cw->ec->x = x, cw->ec->y = y;
              cw->ec->client.x = x + cw->client_inset.l;
              cw->ec->client.y = y + cw->client_inset.t;
+             e_client_index_update(cw->ec);
           }
         return;
      }
@@ -1094,6 +1246,7 @@ _e_comp_intercept_move(void *data, Evas_Object *obj, int x, int y)
    /* only update during resize if triggered by resize */
    if (e_client_util_resizing_get(cw->ec) && (!cw->force_move)) return;
    cw->ec->x = x, cw->ec->y = y;
+   e_client_index_update(cw->ec);
    if (cw->ec->new_client)
      {
         /* don't actually do anything until first client idler loop */
@@ -1144,6 +1297,7 @@ _e_comp_intercept_resize(void *data, Evas_Object *obj, int w, int h)
              cw->ec->w = w, cw->ec->h = h;
              cw->ec->client.w = w - cw->client_inset.l - cw->client_inset.r;
              cw->ec->client.h = h - cw->client_inset.t - cw->client_inset.b;
+             e_client_index_update(cw->ec);
              evas_object_smart_callback_call(obj, "client_resize", NULL);
           }
         return;
@@ -1195,6 +1349,7 @@ _e_comp_intercept_resize(void *data, Evas_Object *obj, int w, int h)
              //if ((w != cw->ec->w) || (h != cw->ec->h))
                {
                   cw->ec->w = w, cw->ec->h = h;
+                  e_client_index_update(cw->ec);
                   cw->ec->changes.size = 1;
                   EC_CHANGED(cw->ec);
                }
@@ -1210,6 +1365,7 @@ _e_comp_intercept_resize(void *data, Evas_Object *obj, int w, int h)
         _e_comp_object_client_pending_resize_add(cw->ec, iw, ih, cw->ec->netwm.sync.serial);
      }
    cw->ec->w = w, cw->ec->h = h;
+   e_client_index_update(cw->ec);
    if ((!cw->ec->shading) && (!cw->ec->shaded))
      {
         /* client geom never changes when shading since the client is never altered */
@@ -2449,6 +2605,7 @@ _e_comp_smart_del(Evas_Object *obj)
 
    INTERNAL_ENTRY;
 
+   _e_comp_object_render_update_unlink(cw);
    E_FREE_FUNC(cw->updates, eina_tiler_free);
    E_FREE_FUNC(cw->pending_updates, eina_tiler_free);
    free(cw->ns);
@@ -2483,6 +2640,7 @@ _e_comp_smart_del(Evas_Object *obj)
    eina_array_free(cw->input_objs);
    eina_tiler_free(cw->input_area);
    evas_object_del(cw->obj);
+   free(cw->wl_pix);
    e_comp_shape_queue();
    eina_stringshare_del(cw->frame_theme);
    eina_stringshare_del(cw->frame_name);
@@ -3754,7 +3912,9 @@ e_comp_object_signal_callback_del_full(Evas_Object *obj, const char *sig, const
 E_API void
 e_comp_object_damage(Evas_Object *obj, int x, int y, int w, int h)
 {
+   E_Comp_Config *conf;
    int tw, th;
+   unsigned int max;
    Eina_Rectangle rect;
    API_ENTRY;
 
@@ -3770,6 +3930,13 @@ e_comp_object_damage(Evas_Object *obj, int x, int y, int w, int h)
         cw->nocomp_need_update = EINA_TRUE;
         return;
      }
+   /* clip rect to client surface */
+   RENDER_DEBUG("DAMAGE(%d,%d %dx%d) CLIP(%dx%d)", x, y, w, h, cw->ec->client.w, cw->ec->client.h);
+   E_RECTS_CLIP_TO_RECT(x, y, w, h, 0, 0, cw->ec->client.w, cw->ec->client.h);
+   /* overdraw still counts towards the damage pattern of the client */
+   cw->damage_rects++;
+   if ((w > 0) && (h > 0))
+     cw->damage_area += (unsigned long long)w * h;
    /* ignore overdraw */
    if (cw->updates_full)
      {
@@ -3778,9 +3945,7 @@ e_comp_object_damage(Evas_Object *obj, int x, int y, int w, int h)
           e_comp_object_render_update_add(obj);
         return;
      }
-   /* clip rect to client surface */
-   RENDER_DEBUG("DAMAGE(%d,%d %dx%d) CLIP(%dx%d)", x, y, w, h, cw->ec->client.w, cw->ec->client.h);
-   E_RECTS_CLIP_TO_RECT(x, y, w, h, 0, 0, cw->ec->client.w, cw->ec->client.h);
+   conf = e_comp_config_get();
    /* if rect is the total size of the client after clip, clear the updates
     * since this is guaranteed to be the whole region anyway
     */
@@ -3790,9 +3955,18 @@ e_comp_object_damage(Evas_Object *obj, int x, int y, int w, int h)
         RENDER_DEBUG("DAMAGE RESIZE %p: %dx%d", cw->ec, cw->ec->client.w, cw->ec->client.h);
         eina_tiler_clear(cw->updates);
         eina_tiler_area_size_set(cw->updates, cw->ec->client.w, cw->ec->client.h);
+        _e_comp_object_updates_tile_size_set(cw->updates, cw->ec->client.w, cw->ec->client.h);
         x = 0, y = 0;
         tw = cw->ec->client.w, th = cw->ec->client.h;
      }
+   if (conf->damage_coalesce && cw->damage_full &&
+       ((cw->damage_frames % DAMAGE_PROBE_FRAMES) != DAMAGE_PROBE_FRAMES - 1))
+     {
+        RENDER_DEBUG("DAMAGE LEARNED FULL: %p", cw->ec);
+        e_comp_profiler_damage_add(0, EINA_TRUE);
+        x = 0, y = 0;
+        w = tw, h = th;
+     }
    if ((!x) && (!y) && (w == tw) && (h == th))
      {
         eina_tiler_clear(cw->updates);
@@ -3801,9 +3975,13 @@ e_comp_object_damage(Evas_Object *obj, int x, int y, int w, int h)
         cw->update_count = 0;
      }
    cw->update_count++;
-   if (cw->update_count > UPDATE_MAX)
+   max = UPDATE_MAX;
+   if (conf->damage_coalesce && (conf->damage_rects_max > 0))
+     max = conf->damage_rects_max;
+   if (cw->update_count > max)
      {
         /* this is going to get really dumb, so just update the whole thing */
+        e_comp_profiler_damage_add(0, EINA_TRUE);
         eina_tiler_clear(cw->updates);
         cw->update_count = cw->updates_full = 1;
         eina_tiler_rect_add(cw->updates, &(Eina_Rectangle){0, 0, tw, th});
@@ -3840,7 +4018,14 @@ e_comp_object_render_update_add(Evas_Object *obj)
    if (!cw->update)
      {
         cw->update = 1;
-        e_comp->updates = eina_list_append(e_comp->updates, cw->ec);
+        cw->update_serial = _e_comp_object_updates_serial;
+        if (cw->ec->focused || cw->ec->fullscreen)
+          cw->update_prio = UPDATE_PRIO_HIGH;
+        else
+          cw->update_prio = UPDATE_PRIO_NORMAL;
+        _e_comp_object_updates[cw->update_prio] =
+          eina_inlist_append(_e_comp_object_updates[cw->update_prio], EINA_INLIST_GET(cw));
+        _e_comp_object_updates_count++;
      }
    e_comp_render_queue();
 }
@@ -3851,22 +4036,216 @@ e_comp_object_render_update_del(Evas_Object *obj)
    API_ENTRY;
 
    if (cw->ec->input_only || (!cw->updates)) return;
-   if (!cw->update) return;
-   cw->update = 0;
-   /* this gets called during comp animating to clear the update flag */
-   if (e_comp->grabbed) return;
-   e_comp->updates = eina_list_remove(e_comp->updates, cw->ec);
+   _e_comp_object_render_update_unlink(cw);
 }
 
-E_API void
-e_comp_object_shape_apply(Evas_Object *obj)
+EINTERN unsigned int
+e_comp_object_render_updates_begin(void)
+{
+   /* everything queued from here on is for the following frame */
+   return ++_e_comp_object_updates_serial;
+}
+
+EINTERN E_Client *
+e_comp_object_render_updates_next(unsigned int serial)
+{
+   E_Comp_Object *cw;
+   unsigned int prio;
+
+   for (prio = 0; prio < UPDATE_PRIO_LAST; prio++)
+     {
+        if (!_e_comp_object_updates[prio]) continue;
+        cw = EINA_INLIST_CONTAINER_GET(_e_comp_object_updates[prio], E_Comp_Object);
+        if ((int)(cw->update_serial - serial) >= 0) continue;
+        /* clear update flag */
+        _e_comp_object_render_update_unlink(cw);
+        return cw->ec;
+     }
+   return NULL;
+}
+
+E_API unsigned int
+e_comp_object_render_updates_count(void)
+{
+   return _e_comp_object_updates_count;
+}
+
+/* shape mask application:
+ * the shape rects are cut into horizontal bands at their top/bottom edges and
+ * the covered x spans of each band are merged once; every row of a band then
+ * gets full alpha inside the spans and is cleared outside of them. no
+ * surface-sized temporary mask is needed and only the requested rows are touched.
+ */
+typedef struct
+{
+   int x1, x2;
+} E_Comp_Object_Shape_Span;
+
+static inline void
+_e_comp_object_shape_span_alpha_set(unsigned int *p, int len)
+{
+   int i = 0;
+
+#ifdef __AVX2__
+   {
+      const __m256i a8 = _mm256_set1_epi32((int)0xff000000);
+
+      for (; i + 8 <= len; i += 8)
+        _mm256_storeu_si256((__m256i *)(p + i),
+                            _mm256_or_si256(_mm256_loadu_si256((const __m256i *)(p + i)), a8));
+   }
+#endif
+#ifdef __SSE2__
+   {
+      const __m128i a4 = _mm_set1_epi32((int)0xff000000);
+
+      for (; i + 4 <= len; i += 4)
+        _mm_storeu_si128((__m128i *)(p + i),
+                         _mm_or_si128(_mm_loadu_si128((const __m128i *)(p + i)), a4));
+   }
+#elif defined(__ARM_NEON)
+   {
+      const uint32x4_t a4 = vdupq_n_u32(0xff000000);
+
+      for (; i + 4 <= len; i += 4)
+        vst1q_u32(p + i, vorrq_u32(vld1q_u32(p + i), a4));
+   }
+#endif
+   for (; i < len; i++)
+     p[i] |= 0xff000000;
+}
+
+static int
+_e_comp_object_shape_rect_y_sort_cb(const void *a, const void *b)
+{
+   const Eina_Rectangle *r1 = a, *r2 = b;
+
+   return r1->y - r2->y;
+}
+
+static int
+_e_comp_object_shape_int_sort_cb(const void *a, const void *b)
+{
+   return *(const int *)a - *(const int *)b;
+}
+
+/* apply shape rects to rows y1 -> y2 (exclusive) of a w x h argb buffer.
+ * unshaped rows only get their alpha forced on, a shape without rects
+ * clears them.
+ */
+static void
+_e_comp_object_shape_mask_apply(unsigned int *pix, int stride, int w, int h, Eina_Bool shaped,
+                                const Eina_Rectangle *rects, int num, int y1, int y2)
+{
+   Eina_Rectangle *sorted, *active;
+   E_Comp_Object_Shape_Span *spans;
+   int *edges, nedges = 0, nsorted = 0, nactive = 0, next = 0;
+   int i, j, k, y;
+
+   if (y1 < 0) y1 = 0;
+   if (y2 > h) y2 = h;
+   if ((w < 1) || (y1 >= y2)) return;
+   if (!shaped)
+     {
+        for (y = y1; y < y2; y++)
+          _e_comp_object_shape_span_alpha_set(pix + (y * stride), w);
+        return;
+     }
+   if ((!rects) || (num < 1))
+     {
+        for (y = y1; y < y2; y++)
+          memset(pix + (y * stride), 0, w * sizeof(unsigned int));
+        return;
+     }
+
+   sorted = malloc((sizeof(Eina_Rectangle) * 2 + sizeof(E_Comp_Object_Shape_Span)) * (num + 1) +
+                   sizeof(int) * (num * 2 + 2));
+   if (!sorted) return;
+   active = sorted + num + 1;
+   spans = (E_Comp_Object_Shape_Span *)(active + num + 1);
+   edges = (int *)(spans + num + 1);
+
+   edges[nedges++] = y1;
+   edges[nedges++] = y2;
+   for (i = 0; i < num; i++)
+     {
+        int rx, ry, rw, rh;
+
+        rx = rects[i].x; ry = rects[i].y;
+        rw = rects[i].w; rh = rects[i].h;
+        E_RECTS_CLIP_TO_RECT(rx, ry, rw, rh, 0, y1, w, y2 - y1);
+        if ((rw <= 0) || (rh <= 0)) continue;
+        sorted[nsorted++] = (Eina_Rectangle){ rx, ry, rw, rh };
+        edges[nedges++] = ry;
+        edges[nedges++] = ry + rh;
+     }
+   qsort(sorted, nsorted, sizeof(Eina_Rectangle), _e_comp_object_shape_rect_y_sort_cb);
+   qsort(edges, nedges, sizeof(int), _e_comp_object_shape_int_sort_cb);
+
+   for (k = 0; k < nedges - 1; k++)
+     {
+        int by1 = edges[k], by2 = edges[k + 1], nspans = 0;
+
+        if (by1 == by2) continue;
+        /* drop rects ending above this band, pick up the ones starting in it */
+        for (i = j = 0; i < nactive; i++)
+          {
+             if (active[i].y + active[i].h > by1)
+               active[j++] = active[i];
+          }
+        nactive = j;
+        while ((next < nsorted) && (sorted[next].y <= by1))
+          active[nactive++] = sorted[next++];
+
+        /* merge the x spans of the band, sorted by x */
+        for (i = 0; i < nactive; i++)
+          {
+             E_Comp_Object_Shape_Span s = { active[i].x, active[i].x + active[i].w };
+
+             for (j = nspans; (j > 0) && (spans[j - 1].x1 > s.x1); j--)
+               spans[j] = spans[j - 1];
+             spans[j] = s;
+             nspans++;
+          }
+        for (i = 0, j = 0; i < nspans; i++)
+          {
+             if (j && (spans[i].x1 <= spans[j - 1].x2))
+               {
+                  if (spans[i].x2 > spans[j - 1].x2)
+                    spans[j - 1].x2 = spans[i].x2;
+               }
+             else
+               spans[j++] = spans[i];
+          }
+        nspans = j;
+
+        for (y = by1; y < by2; y++)
+          {
+             unsigned int *p = pix + (y * stride);
+             int x = 0;
+
+             for (i = 0; i < nspans; i++)
+               {
+                  if (spans[i].x1 > x)
+                    memset(p + x, 0, (spans[i].x1 - x) * sizeof(unsigned int));
+                  _e_comp_object_shape_span_alpha_set(p + spans[i].x1, spans[i].x2 - spans[i].x1);
+                  x = spans[i].x2;
+               }
+             if (x < w)
+               memset(p + x, 0, (w - x) * sizeof(unsigned int));
+          }
+     }
+   free(sorted);
+}
+
+static void
+_e_comp_object_shape_apply(E_Comp_Object *cw, int y1, int y2)
 {
    Eina_List *l;
    Evas_Object *o;
-   unsigned int i, *pix, *p;
-   int w, h, px, py;
+   unsigned int *pix;
+   int w, h, stride;
 
-   API_ENTRY;
    if (!cw->ec) return; //NYI
    if (cw->ec->shaped)
      {
@@ -3884,71 +4263,37 @@ e_comp_object_shape_apply(Evas_Object *obj)
 
    //INF("SHAPE RENDER %p", cw->ec);
 
-   p = pix = evas_object_image_data_get(cw->obj, 1);
+   pix = evas_object_image_data_get(cw->obj, 1);
    if (!pix)
      {
         evas_object_image_data_set(cw->obj, pix);
         _e_comp_object_alpha_set(cw);
         return;
      }
-   if (cw->ec->shaped)
-     {
-        unsigned char *spix, *sp;
-
-        spix = calloc(w * h, sizeof(unsigned char));
-        RENDER_DEBUG("SHAPE [%p] rects %i", cw->ec, cw->ec->shape_rects_num);
-        for (i = 0; i < cw->ec->shape_rects_num; i++)
-          {
-             int rx, ry, rw, rh;
-
-             rx = cw->ec->shape_rects[i].x; ry = cw->ec->shape_rects[i].y;
-             rw = cw->ec->shape_rects[i].w; rh = cw->ec->shape_rects[i].h;
-             E_RECTS_CLIP_TO_RECT(rx, ry, rw, rh, 0, 0, w, h);
-             sp = spix + (w * ry) + rx;
-             for (py = 0; py < rh; py++)
-               {
-                  for (px = 0; px < rw; px++)
-                    {
-                       *sp = 0xff; sp++;
-                    }
-                  sp += w - rw;
-               }
-          }
-        sp = spix;
-        for (py = 0; py < h; py++)
-          {
-             for (px = 0; px < w; px++)
-               {
-                  unsigned int mask, imask;
-
-                  mask = ((unsigned int)(*sp)) << 24;
-                  imask = mask >> 8;
-                  imask |= imask >> 8;
-                  imask |= imask >> 8;
-                  *p = mask | (*p & imask);
-                  //if (*sp) *p = 0xff000000 | *p;
-                  //else *p = 0x00000000;
-                  sp++;
-                  p++;
-               }
-          }
-        free(spix);
-     }
-   else
-      {
-         for (py = 0; py < h; py++)
-           {
-              for (px = 0; px < w; px++)
-                *p |= 0xff000000;
-           }
-      }
+   /* rows outside of the render are still masked from the previous apply
+    * unless the shape, the size or the buffer itself changed
+    */
+   if (cw->ec->shape_changed || (pix != cw->shape_pix) ||
+       (w != cw->shape_w) || (h != cw->shape_h))
+     y1 = 0, y2 = h;
+   y1 = MAX(y1, 0);
+   y2 = MIN(y2, h);
+   cw->shape_pix = pix;
+   cw->shape_w = w, cw->shape_h = h;
+   stride = evas_object_image_stride_get(cw->obj) / sizeof(unsigned int);
+   if (stride < w) stride = w;
+   RENDER_DEBUG("SHAPE [%p] rects %i rows %i-%i", cw->ec, cw->ec->shape_rects_num, y1, y2);
+   _e_comp_object_shape_mask_apply(pix, stride, w, h, cw->ec->shaped,
+                                   cw->ec->shape_rects,
+                                   cw->ec->shape_rects_num, y1, y2);
    evas_object_image_data_set(cw->obj, pix);
    _e_comp_object_alpha_set(cw);
-   evas_object_image_data_update_add(cw->obj, 0, 0, w, h);
+   if (y2 <= y1) return;
+   evas_object_image_data_update_add(cw->obj, 0, y1, w, y2 - y1);
    EINA_LIST_FOREACH(cw->obj_mirror, l, o)
      {
         evas_object_image_data_set(o, pix);
-        evas_object_image_data_update_add(o, 0, 0, w, h);
+        evas_object_image_data_update_add(o, 0, y1, w, y2 - y1);
         evas_object_image_alpha_set(o, 1);
      }
 // don't need to fix alpha chanel as blending
@@ -3956,6 +4301,15 @@ e_comp_object_shape_apply(Evas_Object *obj)
 // alpha channel content
 }
 
+E_API void
+e_comp_object_shape_apply(Evas_Object *obj)
+{
+   API_ENTRY;
+   /* external callers get the whole surface masked */
+   cw->shape_pix = NULL;
+   _e_comp_object_shape_apply(cw, 0, INT_MAX);
+}
+
 /* helper function to simplify toggling of redirection for display servers which support it */
 E_API void
 e_comp_object_redirected_set(Evas_Object *obj, Eina_Bool set)
@@ -4080,15 +4434,20 @@ e_comp_object_blank(Evas_Object *obj, Eina_Bool set)
 E_API void
 e_comp_object_dirty(Evas_Object *obj)
 {
+   E_Comp_Config *conf;
    Eina_Iterator *it;
-   Eina_Rectangle *rect;
+   Eina_Rectangle *rect, rstack[64], *r = rstack;
    Eina_List *ll;
    Evas_Object *o;
    int w, h;
    Eina_Bool dirty, visible, alpha;
    int bx, by, bxx, byy;
+   unsigned int i, num = 0, size = EINA_C_ARRAY_LENGTH(rstack), rects = 0;
+   unsigned long long area = 0;
+   double t0;
 
    API_ENTRY;
+   t0 = e_comp_profiler_stage_begin(E_COMP_PROFILER_STAGE_DIRTY);
    /* only actually dirty if pixmap is available */
    dirty = e_pixmap_size_get(cw->ec->pixmap, &w, &h);
    visible = cw->visible;
@@ -4118,6 +4477,7 @@ e_comp_object_dirty(Evas_Object *obj)
      {
         if (!e_object_is_del(E_OBJECT(cw->ec)))
           ERR("ERROR FETCHING PIXMAP FOR %p", cw->ec);
+        e_comp_profiler_stage_end(E_COMP_PROFILER_STAGE_DIRTY, t0, cw->ec, 0);
         return;
      }
 
@@ -4157,32 +4517,162 @@ e_comp_object_dirty(Evas_Object *obj)
    it = eina_tiler_iterator_new(cw->updates);
    EINA_ITERATOR_FOREACH(it, rect)
      {
+        if (num == size)
+          {
+             Eina_Rectangle *tmp;
+
+             if (r == rstack)
+               {
+                  tmp = malloc(sizeof(Eina_Rectangle) * size * 2);
+                  if (tmp) memcpy(tmp, rstack, sizeof(rstack));
+               }
+             else
+               tmp = realloc(r, sizeof(Eina_Rectangle) * size * 2);
+             if (!tmp) break;
+             r = tmp;
+             size *= 2;
+          }
+        r[num++] = *rect;
+     }
+   eina_iterator_free(it);
+
+   conf = e_comp_config_get();
+   if (conf->damage_coalesce && (num > 1))
+     {
+        unsigned int merged;
+
+        merged = _e_comp_object_damage_coalesce(r, num, MAX(conf->damage_rect_cost, 0));
+        if (merged < num)
+          {
+             e_comp_profiler_damage_add(num - merged, EINA_FALSE);
+             num = merged;
+             if (!cw->pending_updates)
+               {
+                  /* the update tiler is about to become the pending tiler */
+                  eina_tiler_clear(cw->updates);
+                  for (i = 0; i < num; i++)
+                    eina_tiler_rect_add(cw->updates, &r[i]);
+               }
+          }
+     }
+   for (i = 0; i < num; i++)
+     {
+        rect = &r[i];
         RENDER_DEBUG("UPDATE ADD [%p]: %d %d %dx%d", cw->ec, rect->x, rect->y, rect->w, rect->h);
         evas_object_image_data_update_add(cw->obj, rect->x, rect->y, rect->w, rect->h);
         EINA_LIST_FOREACH(cw->obj_mirror, ll, o)
           evas_object_image_data_update_add(o, rect->x, rect->y, rect->w, rect->h);
         if (cw->pending_updates)
           eina_tiler_rect_add(cw->pending_updates, rect);
+        area += _e_comp_object_rect_area(rect);
+        rects++;
      }
-   eina_iterator_free(it);
+   if (r != rstack) free(r);
+   _e_comp_object_damage_learn(cw, w, h, cw->updates_full, area, rects);
    if (cw->pending_updates)
      eina_tiler_clear(cw->updates);
    else
      {
         cw->pending_updates = cw->updates;
         cw->updates = eina_tiler_new(w, h);
-        eina_tiler_tile_size_set(cw->updates, 1, 1);
+        _e_comp_object_updates_tile_size_set(cw->updates, w, h);
      }
    cw->update_count = cw->updates_full = cw->updates_exist = 0;
+   cw->damage_rects = 0;
+   cw->damage_area = 0;
    evas_object_smart_callback_call(obj, "dirty", NULL);
+   e_comp_profiler_stage_end(E_COMP_PROFILER_STAGE_DIRTY, t0, cw->ec, rects);
    if (cw->real_hid || cw->visible || (!visible) || (!cw->pending_updates) || cw->native) return;
    /* force render if main object is hidden but mirrors are visible */
    RENDER_DEBUG("FORCING RENDER %p", cw->ec);
    e_comp_object_render(obj);
 }
 
-E_API Eina_Bool
-e_comp_object_render(Evas_Object *obj)
+/* wayland shm buffers change pointer on every commit, so handing them to evas
+ * directly makes it treat the whole surface as new. while clients only damage
+ * small parts of their surface, the damaged rects are copied into a private
+ * buffer instead so the image pointer stays stable and only the update regions
+ * added in e_comp_object_dirty() are processed. surfaces with large damage
+ * (video, scrolling) keep using the client buffer without a copy.
+ */
+static unsigned int *
+_e_comp_object_render_wl(E_Comp_Object *cw, int pw, int ph, unsigned int *rects)
+{
+   Eina_Iterator *it;
+   Eina_Rectangle *r;
+   unsigned int *srcpix;
+   unsigned long long area = 0, full = (unsigned long long)pw * ph;
+   int stride, y;
+
+   cw->render_y1 = 0;
+   cw->render_y2 = ph;
+   srcpix = e_pixmap_image_data_get(cw->ec->pixmap);
+   if (!srcpix)
+     {
+        E_FREE(cw->wl_pix);
+        return NULL;
+     }
+
+   it = eina_tiler_iterator_new(cw->pending_updates);
+   EINA_ITERATOR_FOREACH(it, r)
+     {
+        int rx = r->x, ry = r->y, rw = r->w, rh = r->h;
+
+        E_RECTS_CLIP_TO_RECT(rx, ry, rw, rh, 0, 0, pw, ph);
+        area += (unsigned long long)rw * rh;
+     }
+   eina_iterator_free(it);
+
+   if (area * 2 >= full)
+     {
+        /* most of the surface changed: no point in copying it */
+        E_FREE(cw->wl_pix);
+        e_comp_profiler_upload_add(full * sizeof(unsigned int));
+        return srcpix;
+     }
+
+   if (cw->wl_pix && ((cw->wl_pix_w != pw) || (cw->wl_pix_h != ph)))
+     E_FREE(cw->wl_pix);
+   if (!cw->wl_pix)
+     {
+        cw->wl_pix = malloc(full * sizeof(unsigned int));
+        if (!cw->wl_pix)
+          {
+             e_comp_profiler_upload_add(full * sizeof(unsigned int));
+             return srcpix;
+          }
+        cw->wl_pix_w = pw;
+        cw->wl_pix_h = ph;
+        memcpy(cw->wl_pix, srcpix, full * sizeof(unsigned int));
+        e_comp_profiler_upload_add(full * sizeof(unsigned int));
+        return cw->wl_pix;
+     }
+
+   stride = pw;
+   cw->render_y1 = ph;
+   cw->render_y2 = 0;
+   it = eina_tiler_iterator_new(cw->pending_updates);
+   EINA_ITERATOR_FOREACH(it, r)
+     {
+        int rx = r->x, ry = r->y, rw = r->w, rh = r->h;
+
+        E_RECTS_CLIP_TO_RECT(rx, ry, rw, rh, 0, 0, pw, ph);
+        if ((rw <= 0) || (rh <= 0)) continue;
+        for (y = ry; y < ry + rh; y++)
+          memcpy(cw->wl_pix + (y * stride) + rx, srcpix + (y * stride) + rx,
+                 rw * sizeof(unsigned int));
+        cw->render_y1 = MIN(cw->render_y1, ry);
+        cw->render_y2 = MAX(cw->render_y2, ry + rh);
+        RENDER_DEBUG("UPDATE [%p] WL %i %i %ix%i", cw->ec, rx, ry, rw, rh);
+        (*rects)++;
+     }
+   eina_iterator_free(it);
+   e_comp_profiler_upload_add(area * sizeof(unsigned int));
+   return cw->wl_pix;
+}
+
+static Eina_Bool
+_e_comp_object_render(E_Comp_Object *cw, Evas_Object *obj, unsigned int *rects)
 {
    Eina_Iterator *it = NULL;
    Eina_Rectangle *r;
@@ -4192,9 +4682,6 @@ e_comp_object_render(Evas_Object *obj)
    unsigned int *pix, *srcpix;
    Eina_Bool ret = EINA_FALSE;
 
-   API_ENTRY EINA_FALSE;
-
-   EINA_SAFETY_ON_NULL_RETURN_VAL(cw->ec, EINA_FALSE);
    if (cw->ec->input_only) return EINA_TRUE;
    e_comp_object_render_update_del(obj);
    if (!e_pixmap_size_get(cw->ec->pixmap, &pw, &ph)) return EINA_FALSE;
@@ -4214,9 +4701,11 @@ e_comp_object_render(Evas_Object *obj)
 
    RENDER_DEBUG("RENDER SIZE: %dx%d", pw, ph);
 
+   cw->render_y1 = ph;
+   cw->render_y2 = 0;
    if (e_comp->comp_type == E_PIXMAP_TYPE_WL)
      {
-        pix = e_pixmap_image_data_get(cw->ec->pixmap);
+        pix = _e_comp_object_render_wl(cw, pw, ph, rects);
         ret = EINA_TRUE;
         goto end;
      }
@@ -4244,6 +4733,10 @@ e_comp_object_render(Evas_Object *obj)
                   break;
                }
              RENDER_DEBUG("UPDATE [%p] %i %i %ix%i", cw->ec, r->x, r->y, r->w, r->h);
+             e_comp_profiler_upload_add((unsigned long long)r->w * r->h * sizeof(unsigned int));
+             cw->render_y1 = MIN(cw->render_y1, r->y);
+             cw->render_y2 = MAX(cw->render_y2, r->y + r->h);
+             (*rects)++;
           }
         if (!it) pix = NULL;
         goto end;
@@ -4271,6 +4764,10 @@ e_comp_object_render(Evas_Object *obj)
           }
         e_pixmap_image_data_argb_convert(cw->ec->pixmap, pix, srcpix, r, stride);
         RENDER_DEBUG("UPDATE [%p]: %d %d %dx%d -- pix = %p", cw->ec, r->x, r->y, r->w, r->h, pix);
+        e_comp_profiler_upload_add((unsigned long long)r->w * r->h * sizeof(unsigned int));
+        cw->render_y1 = MIN(cw->render_y1, r->y);
+        cw->render_y2 = MAX(cw->render_y2, r->y + r->h);
+        (*rects)++;
      }
    if (!it) pix = NULL;
 end:
@@ -4284,6 +4781,29 @@ end:
    return ret;
 }
 
+E_API Eina_Bool
+e_comp_object_render(Evas_Object *obj)
+{
+   E_Client *ec;
+   unsigned int rects = 0;
+   Eina_Bool ret;
+   double t0;
+
+   API_ENTRY EINA_FALSE;
+
+   EINA_SAFETY_ON_NULL_RETURN_VAL(cw->ec, EINA_FALSE);
+   t0 = e_comp_profiler_stage_begin(E_COMP_PROFILER_STAGE_RENDER);
+   if (t0 <= 0.0) return _e_comp_object_render(cw, obj, &rects);
+
+   /* client may be deleted by a failed render; keep it alive for the record */
+   ec = cw->ec;
+   e_object_ref(E_OBJECT(ec));
+   ret = _e_comp_object_render(cw, obj, &rects);
+   e_comp_profiler_stage_end(E_COMP_PROFILER_STAGE_RENDER, t0, ec, rects);
+   e_object_unref(E_OBJECT(ec));
+   return ret;
+}
+
 E_API Evas_Object *
 e_comp_object_agent_add(Evas_Object *obj)
 {
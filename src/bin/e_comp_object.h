@@ -76,6 +76,9 @@ E_API void e_comp_object_damage(Evas_Object *obj, int x, int y, int w, int h);
 E_API Eina_Bool e_comp_object_damage_exists(Evas_Object *obj);
 E_API void e_comp_object_render_update_add(Evas_Object *obj);
 E_API void e_comp_object_render_update_del(Evas_Object *obj);
+EINTERN unsigned int e_comp_object_render_updates_begin(void);
+EINTERN E_Client *e_comp_object_render_updates_next(unsigned int serial);
+E_API unsigned int e_comp_object_render_updates_count(void);
 E_API void e_comp_object_shape_apply(Evas_Object *obj);
 E_API void e_comp_object_redirected_set(Evas_Object *obj, Eina_Bool set);
 E_API void e_comp_object_native_surface_set(Evas_Object *obj, Eina_Bool set);
@@ -0,0 +1,413 @@
+#include "e.h"
+
+/* number of frames and stage events kept in the ring buffers */
+#define FRAMES_MAX 1024
+#define EVENTS_MAX 16384
+
+typedef struct _E_Comp_Profiler_Frame
+{
+   unsigned int serial;
+   double start; // first recorded activity of the frame
+   double end; // evas render post; 0.0 while the frame is open
+   double stage[E_COMP_PROFILER_STAGE_LAST]; // accumulated seconds per stage
+   unsigned int clients; // number of client updates processed
+   unsigned int rects; // number of damage rects pushed to evas
+   unsigned int queued; // render update queue length when updates started
+   unsigned long long upload; // bytes of client pixels passed to evas
+   unsigned int coalesced; // damage rects removed by coalescing
+   unsigned int full_damage; // client updates promoted to full damage
+} E_Comp_Profiler_Frame;
+
+typedef struct _E_Comp_Profiler_Event
+{
+   unsigned int frame;
+   E_Comp_Profiler_Stage stage;
+   double start;
+   double dur;
+   Ecore_Window win;
+   Eina_Stringshare *name;
+   unsigned int rects;
+} E_Comp_Profiler_Event;
+
+static const char *stage_names[E_COMP_PROFILER_STAGE_LAST] =
+{
+   "client_update",
+   "dirty",
+   "render",
+   "shape",
+   "evas_render"
+};
+
+static E_Comp_Profiler_Frame *frames = NULL;
+static E_Comp_Profiler_Event *events = NULL;
+static unsigned int frame_serial = 0; // total frames started
+static unsigned int event_count = 0; // total events recorded
+static double render_start = 0.0;
+static double update_start = 0.0; // client update in progress
+static double update_nested = 0.0; // stages timed inside it
+static Eina_Bool frame_open = EINA_FALSE;
+static Eina_Bool enabled = EINA_FALSE;
+
+static E_Comp_Profiler_Frame *
+_e_comp_profiler_frame_current(void)
+{
+   if (!frame_open) e_comp_profiler_frame_begin();
+   return &frames[(frame_serial - 1) % FRAMES_MAX];
+}
+
+static void
+_e_comp_profiler_json_string_write(FILE *f, const char *str)
+{
+   const unsigned char *p;
+
+   fputc('"', f);
+   for (p = (const unsigned char *)str; p && *p; p++)
+     {
+        if ((*p == '"') || (*p == '\\'))
+          fprintf(f, "\\%c", *p);
+        else if (*p < 0x20)
+          fprintf(f, "\\u%04x", *p);
+        else
+          fputc(*p, f);
+     }
+   fputc('"', f);
+}
+
+static void
+_e_comp_profiler_free(void)
+{
+   unsigned int i;
+
+   if (events)
+     {
+        for (i = 0; i < EVENTS_MAX; i++)
+          eina_stringshare_del(events[i].name);
+     }
+   E_FREE(events);
+   E_FREE(frames);
+   frame_serial = event_count = 0;
+   frame_open = EINA_FALSE;
+   render_start = 0.0;
+}
+
+EINTERN int
+e_comp_profiler_init(void)
+{
+   if (getenv("E_COMP_PROFILE"))
+     e_comp_profiler_enabled_set(EINA_TRUE);
+   return 1;
+}
+
+EINTERN int
+e_comp_profiler_shutdown(void)
+{
+   enabled = EINA_FALSE;
+   _e_comp_profiler_free();
+   return 1;
+}
+
+E_API void
+e_comp_profiler_enabled_set(Eina_Bool enable)
+{
+   enable = !!enable;
+   if (enabled == enable) return;
+   if (enable)
+     {
+        if (!frames) frames = E_NEW(E_Comp_Profiler_Frame, FRAMES_MAX);
+        if (!events) events = E_NEW(E_Comp_Profiler_Event, EVENTS_MAX);
+        if ((!frames) || (!events))
+          {
+             _e_comp_profiler_free();
+             return;
+          }
+     }
+   /* the ring is kept around after disabling so that it can still be dumped */
+   frame_open = EINA_FALSE;
+   render_start = 0.0;
+   enabled = enable;
+}
+
+E_API Eina_Bool
+e_comp_profiler_enabled_get(void)
+{
+   return enabled;
+}
+
+E_API void
+e_comp_profiler_clear(void)
+{
+   unsigned int i;
+
+   if (!frames) return;
+   for (i = 0; i < EVENTS_MAX; i++)
+     eina_stringshare_replace(&events[i].name, NULL);
+   memset(frames, 0, sizeof(E_Comp_Profiler_Frame) * FRAMES_MAX);
+   memset(events, 0, sizeof(E_Comp_Profiler_Event) * EVENTS_MAX);
+   frame_serial = event_count = 0;
+   frame_open = EINA_FALSE;
+   render_start = update_start = update_nested = 0.0;
+}
+
+EINTERN double
+e_comp_profiler_stage_begin(E_Comp_Profiler_Stage stage)
+{
+   double t;
+
+   if (!enabled) return 0.0;
+   t = ecore_time_get();
+   if (stage == E_COMP_PROFILER_STAGE_CLIENT_UPDATE)
+     {
+        update_start = t;
+        update_nested = 0.0;
+     }
+   return t;
+}
+
+EINTERN void
+e_comp_profiler_stage_end(E_Comp_Profiler_Stage stage, double t0, const E_Client *ec, unsigned int rects)
+{
+   E_Comp_Profiler_Frame *fr;
+   E_Comp_Profiler_Event *ev;
+   double t;
+
+   if ((!enabled) || (t0 <= 0.0)) return;
+   t = ecore_time_get();
+   fr = _e_comp_profiler_frame_current();
+   if (t0 < fr->start) fr->start = t0;
+   /* the dirty and render stages of a client update are counted once, as
+    * their own. the event keeps the whole client update so traces nest */
+   if (stage == E_COMP_PROFILER_STAGE_CLIENT_UPDATE)
+     {
+        fr->stage[stage] += (t - t0) - update_nested;
+        update_start = update_nested = 0.0;
+     }
+   else
+     {
+        if ((update_start > 0.0) && (t0 >= update_start))
+          update_nested += t - t0;
+        fr->stage[stage] += t - t0;
+     }
+   fr->rects += rects;
+   if (stage == E_COMP_PROFILER_STAGE_CLIENT_UPDATE) fr->clients++;
+
+   ev = &events[event_count % EVENTS_MAX];
+   ev->frame = fr->serial;
+   ev->stage = stage;
+   ev->start = t0;
+   ev->dur = t - t0;
+   ev->rects = rects;
+   if (ec)
+     {
+        ev->win = e_client_util_win_get(ec);
+        eina_stringshare_replace(&ev->name, e_client_util_name_get(ec));
+     }
+   else
+     {
+        ev->win = 0;
+        eina_stringshare_replace(&ev->name, NULL);
+     }
+   event_count++;
+}
+
+EINTERN void
+e_comp_profiler_upload_add(unsigned long long bytes)
+{
+   if (!enabled) return;
+   _e_comp_profiler_frame_current()->upload += bytes;
+}
+
+EINTERN void
+e_comp_profiler_damage_add(unsigned int coalesced, Eina_Bool full)
+{
+   E_Comp_Profiler_Frame *fr;
+
+   if (!enabled) return;
+   fr = _e_comp_profiler_frame_current();
+   fr->coalesced += coalesced;
+   fr->full_damage += !!full;
+}
+
+EINTERN void
+e_comp_profiler_queued_set(unsigned int queued)
+{
+   if (!enabled) return;
+   _e_comp_profiler_frame_current()->queued = queued;
+}
+
+EINTERN void
+e_comp_profiler_frame_begin(void)
+{
+   E_Comp_Profiler_Frame *fr;
+
+   if ((!enabled) || frame_open) return;
+   frame_serial++;
+   fr = &frames[(frame_serial - 1) % FRAMES_MAX];
+   memset(fr, 0, sizeof(E_Comp_Profiler_Frame));
+   fr->serial = frame_serial;
+   fr->start = ecore_time_get();
+   frame_open = EINA_TRUE;
+}
+
+EINTERN void
+e_comp_profiler_render_pre(void)
+{
+   if (!enabled) return;
+   _e_comp_profiler_frame_current();
+   render_start = ecore_time_get();
+}
+
+EINTERN void
+e_comp_profiler_render_post(void)
+{
+   E_Comp_Profiler_Frame *fr;
+
+   if ((!enabled) || (!frame_open)) return;
+   e_comp_profiler_stage_end(E_COMP_PROFILER_STAGE_EVAS_RENDER, render_start, NULL, 0);
+   fr = &frames[(frame_serial - 1) % FRAMES_MAX];
+   fr->end = ecore_time_get();
+   frame_open = EINA_FALSE;
+   render_start = 0.0;
+}
+
+E_API Eina_Bool
+e_comp_profiler_dump(const char *file)
+{
+   FILE *f;
+   unsigned int i, n, first;
+   int pid = getpid();
+   Eina_Bool sep = EINA_FALSE;
+
+   EINA_SAFETY_ON_NULL_RETURN_VAL(file, EINA_FALSE);
+   if (!frames) return EINA_FALSE;
+   f = fopen(file, "w");
+   if (!f) return EINA_FALSE;
+
+   fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+   fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"frames\"}},\n", pid);
+   fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":1,\"args\":{\"name\":\"compositor\"}}", pid);
+   sep = EINA_TRUE;
+
+   n = MIN(frame_serial, FRAMES_MAX);
+   first = frame_serial - n;
+   for (i = first; i < frame_serial; i++)
+     {
+        E_Comp_Profiler_Frame *fr = &frames[i % FRAMES_MAX];
+        E_Comp_Profiler_Stage s;
+
+        if (fr->end <= 0.0) continue;
+        if (sep) fputs(",\n", f);
+        fprintf(f, "{\"name\":\"frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,"
+                "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"serial\":%u,\"clients\":%u,\"rects\":%u,\"queued\":%u,\"upload_bytes\":%llu,"
+                "\"coalesced\":%u,\"full_damage\":%u",
+                pid, fr->start * 1000000.0, (fr->end - fr->start) * 1000000.0,
+                fr->serial, fr->clients, fr->rects, fr->queued, fr->upload,
+                fr->coalesced, fr->full_damage);
+        for (s = 0; s < E_COMP_PROFILER_STAGE_LAST; s++)
+          fprintf(f, ",\"%s_ms\":%.3f", stage_names[s], fr->stage[s] * 1000.0);
+        fputs("}}", f);
+        sep = EINA_TRUE;
+     }
+
+   n = MIN(event_count, EVENTS_MAX);
+   first = event_count - n;
+   for (i = first; i < event_count; i++)
+     {
+        E_Comp_Profiler_Event *ev = &events[i % EVENTS_MAX];
+
+        if (sep) fputs(",\n", f);
+        fprintf(f, "{\"name\":\"%s\",\"cat\":\"comp\",\"ph\":\"X\",\"pid\":%d,\"tid\":1,"
+                "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u,\"rects\":%u",
+                stage_names[ev->stage], pid, ev->start * 1000000.0,
+                ev->dur * 1000000.0, ev->frame, ev->rects);
+        if (ev->win)
+          {
+             fprintf(f, ",\"win\":\"0x%llx\",\"client\":", (unsigned long long)ev->win);
+             _e_comp_profiler_json_string_write(f, ev->name);
+          }
+        fputs("}}", f);
+        sep = EINA_TRUE;
+     }
+   fprintf(f, "\n]}\n");
+   if (fclose(f)) return EINA_FALSE;
+   return EINA_TRUE;
+}
+
+E_API char *
+e_comp_profiler_summary_get(void)
+{
+   Eina_Strbuf *buf;
+   E_Comp_Profiler_Event *worst = NULL;
+   double stage_total[E_COMP_PROFILER_STAGE_LAST] = { 0.0 };
+   double stage_max[E_COMP_PROFILER_STAGE_LAST] = { 0.0 };
+   double total = 0.0, max = 0.0;
+   unsigned long long upload = 0, upload_max = 0;
+   unsigned int queued = 0, queued_max = 0;
+   unsigned int coalesced = 0, full_damage = 0;
+   unsigned int i, n, first, count = 0;
+   E_Comp_Profiler_Stage s;
+   char *ret;
+
+   buf = eina_strbuf_new();
+   if (!frames)
+     {
+        eina_strbuf_append(buf, "Compositor profiler has not been enabled.\n");
+        goto out;
+     }
+   n = MIN(frame_serial, FRAMES_MAX);
+   first = frame_serial - n;
+   for (i = first; i < frame_serial; i++)
+     {
+        E_Comp_Profiler_Frame *fr = &frames[i % FRAMES_MAX];
+        double dt;
+
+        if (fr->end <= 0.0) continue;
+        dt = fr->end - fr->start;
+        total += dt;
+        if (dt > max) max = dt;
+        upload += fr->upload;
+        if (fr->upload > upload_max) upload_max = fr->upload;
+        queued += fr->queued;
+        if (fr->queued > queued_max) queued_max = fr->queued;
+        coalesced += fr->coalesced;
+        full_damage += fr->full_damage;
+        for (s = 0; s < E_COMP_PROFILER_STAGE_LAST; s++)
+          {
+             stage_total[s] += fr->stage[s];
+             if (fr->stage[s] > stage_max[s]) stage_max[s] = fr->stage[s];
+          }
+        count++;
+     }
+   n = MIN(event_count, EVENTS_MAX);
+   first = event_count - n;
+   for (i = first; i < event_count; i++)
+     {
+        E_Comp_Profiler_Event *ev = &events[i % EVENTS_MAX];
+
+        if ((!ev->win) || (ev->stage == E_COMP_PROFILER_STAGE_CLIENT_UPDATE)) continue;
+        if ((!worst) || (ev->dur > worst->dur)) worst = ev;
+     }
+
+   eina_strbuf_append_printf(buf, "Compositor profiler: %s, %u frames\n",
+                             enabled ? "enabled" : "disabled", count);
+   if (!count) goto out;
+   eina_strbuf_append_printf(buf, "frame: avg %.3fms max %.3fms\n",
+                             (total * 1000.0) / count, max * 1000.0);
+   eina_strbuf_append_printf(buf, "upload: avg %lluKiB max %lluKiB\n",
+                             upload / count / 1024, upload_max / 1024);
+   eina_strbuf_append_printf(buf, "update queue: avg %u max %u\n",
+                             queued / count, queued_max);
+   eina_strbuf_append_printf(buf, "damage: %u rects coalesced, %u full damage updates\n",
+                             coalesced, full_damage);
+   for (s = 0; s < E_COMP_PROFILER_STAGE_LAST; s++)
+     eina_strbuf_append_printf(buf, "%s: avg %.3fms max %.3fms\n", stage_names[s],
+                               (stage_total[s] * 1000.0) / count, stage_max[s] * 1000.0);
+   if (worst)
+     eina_strbuf_append_printf(buf, "slowest client stage: %s %.3fms (frame %u, %u rects) 0x%llx '%s'\n",
+                               stage_names[worst->stage], worst->dur * 1000.0,
+                               worst->frame, worst->rects,
+                               (unsigned long long)worst->win, worst->name ?: "");
+out:
+   ret = eina_strbuf_string_steal(buf);
+   eina_strbuf_free(buf);
+   return ret;
+}
@@ -0,0 +1,45 @@
+#ifdef E_TYPEDEFS
+
+typedef enum _E_Comp_Profiler_Stage
+{
+   E_COMP_PROFILER_STAGE_CLIENT_UPDATE, // _e_comp_client_update(), less the stages inside it
+   E_COMP_PROFILER_STAGE_DIRTY, // e_comp_object_dirty()
+   E_COMP_PROFILER_STAGE_RENDER, // e_comp_object_render()
+   E_COMP_PROFILER_STAGE_SHAPE, // x11 input shape update job
+   E_COMP_PROFILER_STAGE_EVAS_RENDER, // evas render pre -> render post
+   E_COMP_PROFILER_STAGE_LAST
+} E_Comp_Profiler_Stage;
+
+#else
+#ifndef E_COMP_PROFILER_H
+#define E_COMP_PROFILER_H
+
+/* frame profiler for the compositor:
+ * every animator tick / render is recorded as a frame in a ring buffer along
+ * with the time spent in each stage, per-client damage rect counts, the
+ * render update queue length, damage coalescing counters and the number of
+ * pixel bytes handed to evas.
+ * the ring can be written out as chrome trace json (chrome://tracing, perfetto)
+ */
+
+EINTERN int e_comp_profiler_init(void);
+EINTERN int e_comp_profiler_shutdown(void);
+
+E_API void      e_comp_profiler_enabled_set(Eina_Bool enabled);
+E_API Eina_Bool e_comp_profiler_enabled_get(void);
+E_API void      e_comp_profiler_clear(void);
+E_API Eina_Bool e_comp_profiler_dump(const char *file);
+E_API char     *e_comp_profiler_summary_get(void);
+
+/* instrumentation points; all of these are no-ops while disabled */
+EINTERN double  e_comp_profiler_stage_begin(E_Comp_Profiler_Stage stage);
+EINTERN void    e_comp_profiler_stage_end(E_Comp_Profiler_Stage stage, double t0, const E_Client *ec, unsigned int rects);
+EINTERN void    e_comp_profiler_upload_add(unsigned long long bytes);
+EINTERN void    e_comp_profiler_damage_add(unsigned int coalesced, Eina_Bool full);
+EINTERN void    e_comp_profiler_queued_set(unsigned int queued);
+EINTERN void    e_comp_profiler_frame_begin(void);
+EINTERN void    e_comp_profiler_render_pre(void);
+EINTERN void    e_comp_profiler_render_post(void);
+
+#endif
+#endif
@@ -185,7 +185,10 @@ _e_comp_x_client_frame_update(E_Client *ec, int l, int r, int t, int b)
    _e_comp_x_client_data_get(ec)->frame_update = 0;
 }
 
-static Eina_List *iconshare = NULL;
+/* shared client icons by a hash of the pixels of their first icon, each a
+ * list of E_Client_Icon_Entry, and the same entries by their icons array */
+static Eina_Hash *iconshare = NULL;
+static Eina_Hash *iconshare_icons = NULL;
 
 typedef struct _E_Client_Icon_Entry E_Client_Icon_Entry;
 
@@ -193,14 +196,15 @@ struct _E_Client_Icon_Entry
 {
    Ecore_X_Icon *icons;
    int num_icons;
+   int hash;
    int ref;
 };
 
 static Ecore_X_Icon *
 _e_comp_x_client_icon_deduplicate(Ecore_X_Icon *icons, int num_icons)
 {
-   int i;
-   Eina_List *l;
+   int i, hash;
+   Eina_List *l, *bucket;
    E_Client_Icon_Entry *ie;
 
    // unless the rest of e uses border icons OTHER than icon #0
@@ -209,11 +213,19 @@ _e_comp_x_client_icon_deduplicate(Ecore_X_Icon *icons, int num_icons)
      {
         E_FREE(icons[i].data);
      }
+   if ((num_icons <= 0) || (!icons[0].data)) return icons;
+   if (!iconshare)
+     {
+        iconshare = eina_hash_int32_new(NULL);
+        iconshare_icons = eina_hash_pointer_new(NULL);
+     }
    // lookup icon data in icons cache/share
-   EINA_LIST_FOREACH(iconshare, l, ie)
+   hash = eina_hash_murmur3((const char *)icons[0].data,
+                            icons[0].width * icons[0].height * 4);
+   bucket = eina_hash_find(iconshare, &hash);
+   EINA_LIST_FOREACH(bucket, l, ie)
      {
         if ((ie->num_icons == num_icons) &&
-            (num_icons  > 0) &&
             (ie->icons[0].width == icons[0].width) &&
             (ie->icons[0].height == icons[0].height) &&
             (!memcmp(ie->icons[0].data, icons[0].data,
@@ -223,10 +235,8 @@ _e_comp_x_client_icon_deduplicate(Ecore_X_Icon *icons, int num_icons)
              for (i = 0; i < num_icons; i++)
                free(icons[i].data);
              free(icons);
-             // ref the shared/cached one
+             // ref the shared/cached one and return that
              ie->ref++;
-             iconshare = eina_list_promote_list(iconshare, l);
-             // and return that
              return ie->icons;
           }
      }
@@ -236,8 +246,11 @@ _e_comp_x_client_icon_deduplicate(Ecore_X_Icon *icons, int num_icons)
      {
         ie->icons = icons;
         ie->num_icons = num_icons;
+        ie->hash = hash;
         ie->ref = 1;
-        iconshare = eina_list_prepend(iconshare, ie);
+        bucket = eina_list_prepend(bucket, ie);
+        eina_hash_set(iconshare, &hash, bucket);
+        eina_hash_add(iconshare_icons, &icons, ie);
      }
    return icons;
 }
@@ -246,37 +259,36 @@ static void
 _e_comp_x_client_icon_free(Ecore_X_Icon *icons, int num_icons)
 {
    int i;
-   Eina_List *l;
-   E_Client_Icon_Entry *ie;
+   Eina_List *bucket;
+   E_Client_Icon_Entry *ie = NULL;
 
+   if (!icons) return;
    // lookup in icon share cache
-   EINA_LIST_FOREACH(iconshare, l, ie)
-     {
-        if ((ie->num_icons == num_icons) &&
-            (num_icons  > 0) &&
-            (ie->icons[0].width == icons[0].width) &&
-            (ie->icons[0].height == icons[0].height) &&
-            (!memcmp(ie->icons[0].data, icons[0].data,
-                     icons[0].width * icons[0].height * 4)))
-          {
-             // found so deref
-             ie->ref--;
-             if (ie->ref <= 0)
-               {
-                  // no refs left - free the icon from the share/cache
-                  iconshare = eina_list_remove_list(iconshare, l);
-                  for (i = 0; i < ie->num_icons; i++)
-                    free(ie->icons[i].data);
-                  free(ie->icons);
-                  free(ie);
-               }
-             return;
-          }
+   if (iconshare_icons)
+     ie = eina_hash_find(iconshare_icons, &icons);
+   if (!ie)
+     {
+        // not shared - so just free it
+        for (i = 0; i < num_icons; i++)
+          free(icons[i].data);
+        free(icons);
+        return;
      }
-   // not found - so just free it ... odd - we should never be here
-   for (i = 0; i < num_icons; i++)
-     free(icons[i].data);
-   free(icons);
+   // found so deref
+   ie->ref--;
+   if (ie->ref > 0) return;
+   // no refs left - free the icon from the share/cache
+   eina_hash_del_by_key(iconshare_icons, &icons);
+   bucket = eina_hash_find(iconshare, &ie->hash);
+   bucket = eina_list_remove(bucket, ie);
+   if (bucket)
+     eina_hash_set(iconshare, &ie->hash, bucket);
+   else
+     eina_hash_del_by_key(iconshare, &ie->hash);
+   for (i = 0; i < ie->num_icons; i++)
+     free(ie->icons[i].data);
+   free(ie->icons);
+   free(ie);
 }
 
 static void
@@ -3453,6 +3465,47 @@ _e_comp_x_hook_client_pre_frame_assign(void *d EINA_UNUSED, E_Client *ec)
    _e_comp_x_evas_comp_hidden_cb(ec, NULL, NULL);
 }
 
+/* request what the fetch hook below will get for all clients in one go */
+static void
+_e_comp_x_clients_prefetch(const Eina_List *clients)
+{
+   const Eina_List *l;
+   E_Client *ec;
+   E_Comp_X_Client_Data *cd;
+   Ecore_X_Window win;
+
+   e_comp_x_prefetch_begin();
+   EINA_LIST_FOREACH(clients, l, ec)
+     {
+        if (ec->ignored || (!ec->changed) || e_object_is_del(E_OBJECT(ec))) continue;
+        if (!e_client_has_xwindow(ec)) continue;
+        win = e_client_util_win_get(ec);
+        cd = _e_comp_x_client_data_get(ec);
+        if (!cd) continue;
+        if (ec->icccm.fetch.client_leader)
+          e_comp_x_prefetch_add(win, ECORE_X_ATOM_WM_CLIENT_LEADER, ECORE_X_ATOM_WINDOW);
+        if (ec->netwm.fetch.name)
+          e_comp_x_prefetch_add(win, ECORE_X_ATOM_NET_WM_NAME, ECORE_X_ATOM_UTF8_STRING);
+        if (ec->icccm.fetch.name_class)
+          e_comp_x_prefetch_add(win, ECORE_X_ATOM_WM_CLASS, ECORE_X_ATOM_STRING);
+        if (ec->icccm.fetch.transient_for)
+          e_comp_x_prefetch_add(win, ECORE_X_ATOM_WM_TRANSIENT_FOR, ECORE_X_ATOM_WINDOW);
+        if (ec->netwm.fetch.icon_name)
+          e_comp_x_prefetch_add(win, ECORE_X_ATOM_NET_WM_ICON_NAME, ECORE_X_ATOM_UTF8_STRING);
+        if (ec->netwm.fetch.opacity)
+          e_comp_x_prefetch_add(win, ECORE_X_ATOM_NET_WM_WINDOW_OPACITY, ECORE_X_ATOM_CARDINAL);
+        if (ec->netwm.fetch.user_time)
+          e_comp_x_prefetch_add(win, ECORE_X_ATOM_NET_WM_USER_TIME, ECORE_X_ATOM_CARDINAL);
+        if (cd->fetch_exe)
+          {
+             if (!ec->internal)
+               e_comp_x_prefetch_add(win, ECORE_X_ATOM_NET_STARTUP_ID, ECORE_X_ATOM_UTF8_STRING);
+             e_comp_x_prefetch_add(win, ECORE_X_ATOM_NET_WM_PID, ECORE_X_ATOM_CARDINAL);
+          }
+     }
+   e_comp_x_prefetch_end();
+}
+
 static void
 _e_comp_x_hook_client_fetch(void *d EINA_UNUSED, E_Client *ec)
 {
@@ -3479,7 +3532,7 @@ _e_comp_x_hook_client_fetch(void *d EINA_UNUSED, E_Client *ec)
         /* TODO: What do to if the client leader isn't mapped yet? */
         E_Client *ec_leader = NULL;
 
-        ec->icccm.client_leader = ecore_x_icccm_client_leader_get(win);
+        ec->icccm.client_leader = e_comp_x_prefetch_icccm_client_leader_get(win);
         if (ec->icccm.client_leader)
           ec_leader = _e_comp_x_client_find_by_window(ec->icccm.client_leader);
         if (ec->leader)
@@ -3535,7 +3588,7 @@ _e_comp_x_hook_client_fetch(void *d EINA_UNUSED, E_Client *ec)
    if (ec->netwm.fetch.name)
      {
         char *name;
-        ecore_x_netwm_name_get(win, &name);
+        e_comp_x_prefetch_netwm_name_get(win, &name);
         eina_stringshare_replace(&ec->netwm.name, name);
         free(name);
 
@@ -3554,7 +3607,7 @@ _e_comp_x_hook_client_fetch(void *d EINA_UNUSED, E_Client *ec)
         const char *pname, *pclass;
         char *nname, *nclass;
 
-        ecore_x_icccm_name_class_get(win, &nname, &nclass);
+        e_comp_x_prefetch_icccm_name_class_get(win, &nname, &nclass);
         pname = ec->icccm.name;
         pclass = ec->icccm.class;
         ec->icccm.name = eina_stringshare_add(nname);
@@ -4018,7 +4071,7 @@ _e_comp_x_hook_client_fetch(void *d EINA_UNUSED, E_Client *ec)
         /* TODO: What do to if the transient for isn't mapped yet? */
         E_Client *ec_parent = NULL;
 
-        ec->icccm.transient_for = ecore_x_icccm_transient_for_get(win);
+        ec->icccm.transient_for = e_comp_x_prefetch_icccm_transient_for_get(win);
         if (ec->icccm.transient_for)
           ec_parent = _e_comp_x_client_find_by_window(ec->icccm.transient_for);
 
@@ -4063,7 +4116,7 @@ _e_comp_x_hook_client_fetch(void *d EINA_UNUSED, E_Client *ec)
    if (ec->netwm.fetch.icon_name)
      {
         char *icon_name;
-        ecore_x_netwm_icon_name_get(win, &icon_name);
+        e_comp_x_prefetch_netwm_icon_name_get(win, &icon_name);
         eina_stringshare_replace(&ec->netwm.icon_name, icon_name);
         free(icon_name);
 
@@ -4074,7 +4127,7 @@ _e_comp_x_hook_client_fetch(void *d EINA_UNUSED, E_Client *ec)
      {
         unsigned int val;
 
-        if (ecore_x_netwm_opacity_get(win, &val))
+        if (e_comp_x_prefetch_netwm_opacity_get(win, &val))
           {
              val >>= 24;
              if (ec->netwm.opacity != val)
@@ -4106,7 +4159,7 @@ _e_comp_x_hook_client_fetch(void *d EINA_UNUSED, E_Client *ec)
      }
    if (ec->netwm.fetch.user_time)
      {
-        ecore_x_netwm_user_time_get(win, &ec->netwm.user_time);
+        e_comp_x_prefetch_netwm_user_time_get(win, &ec->netwm.user_time);
         ec->netwm.fetch.user_time = 0;
      }
    if (ec->netwm.fetch.strut)
@@ -4517,7 +4570,7 @@ _e_comp_x_hook_client_fetch(void *d EINA_UNUSED, E_Client *ec)
            char *str = NULL;
 
            if ((!ec->internal) &&
-               ((ecore_x_netwm_startup_id_get(win, &str) && (str)) ||
+               ((e_comp_x_prefetch_netwm_startup_id_get(win, &str) && (str)) ||
                ((ec->icccm.client_leader > 0) &&
                 ecore_x_netwm_startup_id_get(ec->icccm.client_leader, &str) && (str)))
                )
@@ -4534,7 +4587,7 @@ _e_comp_x_hook_client_fetch(void *d EINA_UNUSED, E_Client *ec)
         }
         /* It's ok not to have fetch flag, should only be set on startup
          * and not changed. */
-        if (!ecore_x_netwm_pid_get(win, &ec->netwm.pid))
+        if (!e_comp_x_prefetch_netwm_pid_get(win, &ec->netwm.pid))
           {
              if (ec->icccm.client_leader)
                {
@@ -5846,6 +5899,8 @@ e_comp_x_init(void)
    dead_wins = eina_hash_int32_new(NULL);
    pending_configures = eina_hash_int32_new(NULL);
    frame_extents = eina_hash_string_superfast_new(free);
+   e_comp_x_prefetch_init();
+   e_client_prefetch_cb_set(_e_comp_x_clients_prefetch);
 
    h = eina_list_append(h, e_client_hook_add(E_CLIENT_HOOK_DESK_SET, _e_comp_x_hook_client_desk_set, NULL));
    h = eina_list_append(h, e_client_hook_add(E_CLIENT_HOOK_RESIZE_BEGIN, _e_comp_x_hook_client_resize_begin, NULL));
@@ -5985,6 +6040,8 @@ e_comp_x_shutdown(void)
    E_FREE_FUNC(pending_configures, eina_hash_free);
    E_FREE_FUNC(frame_extents, eina_hash_free);
    E_FREE_FUNC(mouse_in_fix_check_timer, ecore_timer_del);
+   e_client_prefetch_cb_set(NULL);
+   e_comp_x_prefetch_shutdown();
    e_xsettings_shutdown();
    if (x_fatal) return;
    if (e_comp->comp_type == E_PIXMAP_TYPE_X)
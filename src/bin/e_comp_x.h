@@ -122,5 +122,20 @@ E_API E_Pixmap *e_comp_x_client_pixmap_get(const E_Client *ec);
 EINTERN Eina_Bool _e_comp_x_screensaver_on();
 EINTERN Eina_Bool _e_comp_x_screensaver_off();
 
+EINTERN void e_comp_x_prefetch_init(void);
+EINTERN void e_comp_x_prefetch_shutdown(void);
+EINTERN void e_comp_x_prefetch_begin(void);
+EINTERN void e_comp_x_prefetch_add(Ecore_X_Window win, Ecore_X_Atom atom, Ecore_X_Atom type);
+EINTERN void e_comp_x_prefetch_end(void);
+EINTERN Ecore_X_Window e_comp_x_prefetch_icccm_client_leader_get(Ecore_X_Window win);
+EINTERN Ecore_X_Window e_comp_x_prefetch_icccm_transient_for_get(Ecore_X_Window win);
+EINTERN void e_comp_x_prefetch_icccm_name_class_get(Ecore_X_Window win, char **n, char **c);
+EINTERN void e_comp_x_prefetch_netwm_name_get(Ecore_X_Window win, char **name);
+EINTERN void e_comp_x_prefetch_netwm_icon_name_get(Ecore_X_Window win, char **name);
+EINTERN Eina_Bool e_comp_x_prefetch_netwm_startup_id_get(Ecore_X_Window win, char **id);
+EINTERN Eina_Bool e_comp_x_prefetch_netwm_opacity_get(Ecore_X_Window win, unsigned int *opacity);
+EINTERN Eina_Bool e_comp_x_prefetch_netwm_user_time_get(Ecore_X_Window win, unsigned int *t);
+EINTERN Eina_Bool e_comp_x_prefetch_netwm_pid_get(Ecore_X_Window win, int *pid);
+
 # endif
 #endif
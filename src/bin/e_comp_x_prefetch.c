@@ -0,0 +1,271 @@
+#include "e.h"
+#include <X11/Xlib-xcb.h>
+
+/* Every synchronous property get in the client fetch hook is a round trip
+ * to the X server. Before the fetch hooks run, the properties the changed
+ * clients are about to ask for are requested through xcb all at once and
+ * the replies collected after, so a batch of clients costs one round trip.
+ * The e_comp_x_prefetch_*_get() calls decode a prefetched reply the same
+ * way the ecore_x call they stand in for does, or make that call if the
+ * property was not prefetched. A reply is used once and the rest are
+ * dropped when the next batch begins.
+ */
+
+typedef struct _E_Comp_X_Prefetch_Req  E_Comp_X_Prefetch_Req;
+typedef struct _E_Comp_X_Prefetch_Prop E_Comp_X_Prefetch_Prop;
+
+struct _E_Comp_X_Prefetch_Req
+{
+   unsigned long long        key;
+   xcb_get_property_cookie_t cookie;
+};
+
+struct _E_Comp_X_Prefetch_Prop
+{
+   Ecore_X_Atom  type;
+   int           format;
+   unsigned int  num;
+   unsigned char data[]; // num items plus a nul byte
+};
+
+static xcb_connection_t *_conn = NULL;
+static Eina_Inarray *_reqs = NULL;
+static Eina_Hash *_props = NULL;
+
+static inline unsigned long long
+_e_comp_x_prefetch_key(Ecore_X_Window win, Ecore_X_Atom atom)
+{
+   return ((unsigned long long)win << 32) | atom;
+}
+
+static E_Comp_X_Prefetch_Prop *
+_e_comp_x_prefetch_find(Ecore_X_Window win, Ecore_X_Atom atom)
+{
+   unsigned long long key;
+
+   if ((!_props) || (!eina_hash_population(_props))) return NULL;
+   key = _e_comp_x_prefetch_key(win, atom);
+   return eina_hash_find(_props, &key);
+}
+
+static void
+_e_comp_x_prefetch_del(Ecore_X_Window win, Ecore_X_Atom atom)
+{
+   unsigned long long key;
+
+   key = _e_comp_x_prefetch_key(win, atom);
+   eina_hash_del_by_key(_props, &key);
+}
+
+/* same result as ecore_x_window_prop_card32_get(win, atom, &val, 1) == 1 */
+static int
+_e_comp_x_prefetch_card32_get(Ecore_X_Window win, Ecore_X_Atom atom, Ecore_X_Atom type, unsigned int *val)
+{
+   E_Comp_X_Prefetch_Prop *p;
+   int ret = 0;
+
+   p = _e_comp_x_prefetch_find(win, atom);
+   if (!p) return -1;
+   if ((p->type == type) && (p->format == 32) && (p->num >= 1))
+     {
+        memcpy(val, p->data, sizeof(unsigned int));
+        ret = 1;
+     }
+   _e_comp_x_prefetch_del(win, atom);
+   return ret;
+}
+
+/* the netwm strings are UTF8_STRING properties copied as they are */
+static Eina_Bool
+_e_comp_x_prefetch_utf8_get(Ecore_X_Window win, Ecore_X_Atom atom, char **str)
+{
+   E_Comp_X_Prefetch_Prop *p;
+
+   p = _e_comp_x_prefetch_find(win, atom);
+   if (!p) return EINA_FALSE;
+   *str = NULL;
+   if ((p->type == ECORE_X_ATOM_UTF8_STRING) && (p->format == 8) && (p->num > 0))
+     *str = strndup((char *)p->data, p->num);
+   _e_comp_x_prefetch_del(win, atom);
+   return EINA_TRUE;
+}
+
+EINTERN void
+e_comp_x_prefetch_init(void)
+{
+   _conn = XGetXCBConnection(ecore_x_display_get());
+   _reqs = eina_inarray_new(sizeof(E_Comp_X_Prefetch_Req), 64);
+   _props = eina_hash_int64_new(free);
+}
+
+EINTERN void
+e_comp_x_prefetch_shutdown(void)
+{
+   E_FREE_FUNC(_props, eina_hash_free);
+   E_FREE_FUNC(_reqs, eina_inarray_free);
+   _conn = NULL;
+}
+
+EINTERN void
+e_comp_x_prefetch_begin(void)
+{
+   if (!_props) return;
+   eina_hash_free_buckets(_props);
+}
+
+/* queue a request for a property, nothing is waited on until _end() */
+EINTERN void
+e_comp_x_prefetch_add(Ecore_X_Window win, Ecore_X_Atom atom, Ecore_X_Atom type)
+{
+   E_Comp_X_Prefetch_Req req;
+
+   if ((!_conn) || (!win)) return;
+   req.key = _e_comp_x_prefetch_key(win, atom);
+   req.cookie = xcb_get_property(_conn, 0, win, atom, type, 0, 0x1fffffff);
+   eina_inarray_push(_reqs, &req);
+}
+
+EINTERN void
+e_comp_x_prefetch_end(void)
+{
+   E_Comp_X_Prefetch_Req *req;
+   E_Comp_X_Prefetch_Prop *p;
+   xcb_get_property_reply_t *rep;
+   xcb_generic_error_t *err;
+   unsigned int len;
+
+   if ((!_reqs) || (!eina_inarray_count(_reqs))) return;
+   /* the first reply flushes all of the requests, the others are in by
+    * the time it arrives */
+   EINA_INARRAY_FOREACH(_reqs, req)
+     {
+        err = NULL;
+        rep = xcb_get_property_reply(_conn, req->cookie, &err);
+        free(err);
+        len = rep ? (unsigned int)xcb_get_property_value_length(rep) : 0;
+        p = malloc(sizeof(E_Comp_X_Prefetch_Prop) + len + 1);
+        if (p)
+          {
+             /* a failed request (usually BadWindow) is kept as a missing
+              * property so the fetch doesn't ask again */
+             p->type = rep ? rep->type : 0;
+             p->format = rep ? rep->format : 0;
+             p->num = rep ? rep->value_len : 0;
+             if (len) memcpy(p->data, xcb_get_property_value(rep), len);
+             p->data[len] = 0;
+             if (!eina_hash_add(_props, &req->key, p)) free(p);
+          }
+        free(rep);
+     }
+   eina_inarray_flush(_reqs);
+}
+
+EINTERN Ecore_X_Window
+e_comp_x_prefetch_icccm_client_leader_get(Ecore_X_Window win)
+{
+   unsigned int leader;
+   int ret;
+
+   ret = _e_comp_x_prefetch_card32_get(win, ECORE_X_ATOM_WM_CLIENT_LEADER,
+                                       ECORE_X_ATOM_WINDOW, &leader);
+   if (ret < 0) return ecore_x_icccm_client_leader_get(win);
+   return ret ? leader : 0;
+}
+
+EINTERN Ecore_X_Window
+e_comp_x_prefetch_icccm_transient_for_get(Ecore_X_Window win)
+{
+   unsigned int forwin;
+   int ret;
+
+   ret = _e_comp_x_prefetch_card32_get(win, ECORE_X_ATOM_WM_TRANSIENT_FOR,
+                                       ECORE_X_ATOM_WINDOW, &forwin);
+   if (ret < 0) return ecore_x_icccm_transient_for_get(win);
+   return ret ? forwin : 0;
+}
+
+/* as XGetClassHint(): the instance name, then the class after its nul */
+EINTERN void
+e_comp_x_prefetch_icccm_name_class_get(Ecore_X_Window win, char **n, char **c)
+{
+   E_Comp_X_Prefetch_Prop *p;
+   const char *data;
+   int len;
+
+   p = _e_comp_x_prefetch_find(win, ECORE_X_ATOM_WM_CLASS);
+   if (!p)
+     {
+        ecore_x_icccm_name_class_get(win, n, c);
+        return;
+     }
+   *n = *c = NULL;
+   if ((p->type == ECORE_X_ATOM_STRING) && (p->format == 8))
+     {
+        data = (const char *)p->data;
+        len = strlen(data);
+        *n = strdup(data);
+        /* without a nul between them the class is empty */
+        if (len < (int)p->num)
+          *c = strdup(data + len + 1);
+        else
+          *c = strdup("");
+     }
+   _e_comp_x_prefetch_del(win, ECORE_X_ATOM_WM_CLASS);
+}
+
+EINTERN void
+e_comp_x_prefetch_netwm_name_get(Ecore_X_Window win, char **name)
+{
+   if (!_e_comp_x_prefetch_utf8_get(win, ECORE_X_ATOM_NET_WM_NAME, name))
+     ecore_x_netwm_name_get(win, name);
+}
+
+EINTERN void
+e_comp_x_prefetch_netwm_icon_name_get(Ecore_X_Window win, char **name)
+{
+   if (!_e_comp_x_prefetch_utf8_get(win, ECORE_X_ATOM_NET_WM_ICON_NAME, name))
+     ecore_x_netwm_icon_name_get(win, name);
+}
+
+EINTERN Eina_Bool
+e_comp_x_prefetch_netwm_startup_id_get(Ecore_X_Window win, char **id)
+{
+   if (!_e_comp_x_prefetch_utf8_get(win, ECORE_X_ATOM_NET_STARTUP_ID, id))
+     return ecore_x_netwm_startup_id_get(win, id);
+   return EINA_TRUE;
+}
+
+EINTERN Eina_Bool
+e_comp_x_prefetch_netwm_opacity_get(Ecore_X_Window win, unsigned int *opacity)
+{
+   int ret;
+
+   ret = _e_comp_x_prefetch_card32_get(win, ECORE_X_ATOM_NET_WM_WINDOW_OPACITY,
+                                       ECORE_X_ATOM_CARDINAL, opacity);
+   if (ret < 0) return ecore_x_netwm_opacity_get(win, opacity);
+   return ret;
+}
+
+EINTERN Eina_Bool
+e_comp_x_prefetch_netwm_user_time_get(Ecore_X_Window win, unsigned int *t)
+{
+   int ret;
+
+   ret = _e_comp_x_prefetch_card32_get(win, ECORE_X_ATOM_NET_WM_USER_TIME,
+                                       ECORE_X_ATOM_CARDINAL, t);
+   if (ret < 0) return ecore_x_netwm_user_time_get(win, t);
+   return ret;
+}
+
+EINTERN Eina_Bool
+e_comp_x_prefetch_netwm_pid_get(Ecore_X_Window win, int *pid)
+{
+   unsigned int tmp;
+   int ret;
+
+   ret = _e_comp_x_prefetch_card32_get(win, ECORE_X_ATOM_NET_WM_PID,
+                                       ECORE_X_ATOM_CARDINAL, &tmp);
+   if (ret < 0) return ecore_x_netwm_pid_get(win, pid);
+   if (ret) *pid = tmp;
+   return ret;
+}
@@ -5,16 +5,24 @@ E_API E_Config_Bindings *e_bindings = NULL;
 
 static int _e_config_revisions = 9;
 
+typedef struct _E_Config_Save_Job E_Config_Save_Job;
+
 /* local subsystem functions */
 static void      _e_config_save_cb(void *data);
 static void      _e_config_free(E_Config *cfg);
 static Eina_Bool _e_config_cb_timer(void *data);
-static int       _e_config_eet_close_handle(Eet_File *ef, char *file);
+static int       _e_config_eet_error_handle(Eet_Error err, char *file);
+static void      _e_config_save_wait(void);
 
 /* local subsystem globals */
 static int _e_config_save_block = 0;
 static E_Powersave_Deferred_Action *_e_config_save_defer = NULL;
 static const char *_e_config_profile = NULL;
+static Eina_Lock _e_config_save_lock;
+static Eina_List *_e_config_save_jobs = NULL;
+static E_Config_Save_Job *_e_config_save_job = NULL;
+static double _e_config_save_latency_last = 0.0;
+static double _e_config_save_latency_max = 0.0;
 
 static E_Config_DD *_e_config_edd = NULL;
 static E_Config_DD *_e_config_binding_edd = NULL;
@@ -680,6 +688,7 @@ _e_config_edd_init(Eina_Bool old)
    E_CONFIG_VAL(D, T, screen_limits, INT);
 
    E_CONFIG_VAL(D, T, thumb_nice, INT);
+   E_CONFIG_VAL(D, T, thumb_workers, INT);
 
    E_CONFIG_VAL(D, T, menu_icons_hide, UCHAR);
    E_CONFIG_VAL(D, T, menu_favorites_show, INT);
@@ -806,6 +815,7 @@ _e_config_edd_init(Eina_Bool old)
 EINTERN int
 e_config_init(void)
 {
+   eina_lock_new(&_e_config_save_lock);
    E_EVENT_CONFIG_ICON_THEME = ecore_event_type_new();
    E_EVENT_CONFIG_MODE_CHANGED = ecore_event_type_new();
    E_EVENT_CONFIG_LOADED = ecore_event_type_new();
@@ -990,6 +1000,9 @@ e_config_init(void)
 EINTERN int
 e_config_shutdown(void)
 {
+   _e_config_save_wait();
+   /* a worker that has yet to see its job is done still takes the lock */
+   if (!_e_config_save_job) eina_lock_free(&_e_config_save_lock);
    E_FREE_LIST(handlers, ecore_event_handler_del);
    eina_stringshare_del(_e_config_profile);
    E_CONFIG_DD_FREE(_e_config_binding_edd);
@@ -1740,6 +1753,7 @@ e_config_load(void)
    E_CONFIG_LIMIT(e_config->menu_gadcon_client_toplevel, 0, 1);
 
    E_CONFIG_LIMIT(e_config->ping_clients_interval, 16, 1024);
+   E_CONFIG_LIMIT(e_config->thumb_workers, 0, 64);
 
    E_CONFIG_LIMIT(e_config->mode.presentation, 0, 1);
    E_CONFIG_LIMIT(e_config->mode.offline, 0, 1);
@@ -1798,6 +1812,16 @@ e_config_save_flush(void)
         _e_config_save_defer = NULL;
         _e_config_save_cb(NULL);
      }
+   _e_config_save_wait();
+}
+
+/* how long the last and the slowest config file save took from being
+ * asked for until the file was in place, in seconds */
+E_API void
+e_config_save_latency_get(double *last, double *max)
+{
+   if (last) *last = _e_config_save_latency_last;
+   if (max) *max = _e_config_save_latency_max;
 }
 
 E_API void
@@ -1818,6 +1842,7 @@ e_config_profile_get(void)
 E_API void
 e_config_profile_set(const char *prof)
 {
+   _e_config_save_wait();
    eina_stringshare_replace(&_e_config_profile, prof);
    e_util_env_set("E_CONF_PROFILE", _e_config_profile);
 }
@@ -1929,6 +1954,8 @@ E_API void
 e_config_profile_del(const char *prof)
 {
    char buf[4096];
+
+   _e_config_save_wait();
    if (e_user_dir_snprintf(buf, sizeof(buf), "config/%s", prof) >= sizeof(buf))
      return;
    ecore_file_recursive_rm(buf);
@@ -1963,6 +1990,7 @@ e_config_domain_load(const char *domain, E_Config_DD *edd)
    void *data = NULL;
    int i;
 
+   _e_config_save_wait();
    e_user_dir_snprintf(buf, sizeof(buf), "config/%s/%s.cfg",
                        _e_config_profile, domain);
    ef = eet_open(buf, EET_FILE_MODE_READ);
@@ -2041,65 +2069,231 @@ _e_config_mv_error(const char *from, const char *to)
    _e_config_error_dialog = dia;
 }
 
-E_API int
-e_config_profile_save(void)
+/* Config files are saved in two steps. The data is encoded into a buffer
+ * on the main loop when the save is asked for, so the config can change
+ * right after. Writing that to base.cfg.tmp, fsync, rotating the
+ * revisions and moving it in place are done by a worker, one file at a
+ * time in the order they were saved, so saves of the same file never
+ * share the tmp file. A save still waiting for its turn is dropped when
+ * the same file is saved again, without touching the disk.
+ */
+struct _E_Config_Save_Job
+{
+   void      *data;
+   int        size;
+   char      *base; // file path without .cfg, revisions are base.N.cfg
+   char      *tmp;
+   char      *mv_from, *mv_to; // the move that failed
+   double     queued, finished;
+   Eet_Error  err;
+   Eina_Bool  compress;
+   Eina_Bool  strict; // stop rotating revisions when a move fails
+   Eina_Bool  unopened; // the tmp file could not be created
+   Eina_Bool  skip;
+   Eina_Bool  done;
+};
+
+/* the file io of a save, run by the worker or _e_config_save_wait() */
+static void
+_e_config_save_job_run(E_Config_Save_Job *job)
 {
    Eet_File *ef;
-   char buf[4096], buf2[4096];
-   const char *s;
-   int ok = 0;
-
-   if ((s = getenv("E_CONF_PROFILE_NOSAVE")) && atoi(s))
-     return 1;
-
-   /* FIXME: check for other sessions fo E running */
-   e_user_dir_concat_static(buf, "config/profile.cfg");
-   e_user_dir_concat_static(buf2, "config/profile.cfg.tmp");
+   char bsrc[4096], bdst[4096];
+   Eina_Bool ret = EINA_TRUE;
+   int i, fd;
 
-   ef = eet_open(buf2, EET_FILE_MODE_WRITE);
-   if (ef)
+   if (job->skip) goto end;
+   ef = eet_open(job->tmp, EET_FILE_MODE_WRITE);
+   if (!ef)
+     {
+        job->unopened = EINA_TRUE;
+        goto end;
+     }
+   eet_write(ef, "config", job->data, job->size, job->compress);
+   job->err = eet_close(ef);
+   if (job->err != EET_ERROR_NONE) goto done;
+   /* the new file has to be on disk before it replaces the old one */
+   fd = open(job->tmp, O_RDONLY | O_CLOEXEC);
+   if (fd >= 0)
      {
-        ok = eet_write(ef, "config", _e_config_profile,
-                       strlen(_e_config_profile), 0);
-        if (_e_config_eet_close_handle(ef, buf2))
+        fsync(fd);
+        close(fd);
+     }
+   if (_e_config_revisions > 0)
+     {
+        for (i = _e_config_revisions; i > 1; i--)
           {
-             Eina_Bool ret = EINA_TRUE;
-
-             if (_e_config_revisions > 0)
+             snprintf(bsrc, sizeof(bsrc), "%s.%i.cfg", job->base, i - 1);
+             snprintf(bdst, sizeof(bdst), "%s.%i.cfg", job->base, i);
+             if ((ecore_file_exists(bsrc)) &&
+                 (ecore_file_size(bsrc)))
                {
-                  int i;
-                  char bsrc[4096], bdst[4096];
-
-                  for (i = _e_config_revisions; i > 1; i--)
-                    {
-                       e_user_dir_snprintf(bsrc, sizeof(bsrc), "config/profile.%i.cfg", i - 1);
-                       e_user_dir_snprintf(bdst, sizeof(bdst), "config/profile.%i.cfg", i);
-                       if ((ecore_file_exists(bsrc)) &&
-                           (ecore_file_size(bsrc)))
-                         {
-                            ret = ecore_file_mv(bsrc, bdst);
-                            if (!ret)
-                              {
-                                 _e_config_mv_error(bsrc, bdst);
-                                 break;
-                              }
-                         }
-                    }
-                  if (ret)
+                  ret = ecore_file_mv(bsrc, bdst);
+                  if ((!ret) && (job->strict))
                     {
-                       e_user_dir_snprintf(bsrc, sizeof(bsrc), "config/profile.cfg");
-                       e_user_dir_snprintf(bdst, sizeof(bdst), "config/profile.1.cfg");
-                       ecore_file_mv(bsrc, bdst);
-//                       if (!ret)
-//                          _e_config_mv_error(bsrc, bdst);
+                       job->mv_from = strdup(bsrc);
+                       job->mv_to = strdup(bdst);
+                       break;
                     }
                }
-             ret = ecore_file_mv(buf2, buf);
-             if (!ret) _e_config_mv_error(buf2, buf);
           }
-        ecore_file_unlink(buf2);
+        if ((ret) || (!job->strict))
+          {
+             snprintf(bsrc, sizeof(bsrc), "%s.cfg", job->base);
+             snprintf(bdst, sizeof(bdst), "%s.1.cfg", job->base);
+             ecore_file_mv(bsrc, bdst);
+          }
+     }
+   snprintf(bdst, sizeof(bdst), "%s.cfg", job->base);
+   if ((!ecore_file_mv(job->tmp, bdst)) && (!job->mv_from))
+     {
+        job->mv_from = strdup(job->tmp);
+        job->mv_to = strdup(bdst);
      }
-   return ok;
+done:
+   ecore_file_unlink(job->tmp);
+end:
+   E_FREE(job->data);
+   job->finished = ecore_time_get();
+   job->done = EINA_TRUE;
+}
+
+static void
+_e_config_save_job_finish(E_Config_Save_Job *job)
+{
+   double latency;
+
+   if (job->unopened)
+     ERR("Cannot open %s for writing", job->tmp);
+   else if (job->err != EET_ERROR_NONE)
+     _e_config_eet_error_handle(job->err, job->tmp);
+   else if (job->mv_from)
+     {
+        if (job->strict)
+          _e_config_mv_error(job->mv_from, job->mv_to);
+        else
+          ERR("*** Error saving config. ***");
+     }
+   if (!job->skip)
+     {
+        latency = job->finished - job->queued;
+        _e_config_save_latency_last = latency;
+        if (latency > _e_config_save_latency_max)
+          _e_config_save_latency_max = latency;
+        DBG("saved %s.cfg in %1.3fs", job->base, latency);
+     }
+   free(job->data);
+   free(job->base);
+   free(job->tmp);
+   free(job->mv_from);
+   free(job->mv_to);
+   free(job);
+}
+
+static void _e_config_save_next(void);
+
+static void
+_e_config_save_thread_cb(void *data, Ecore_Thread *th EINA_UNUSED)
+{
+   E_Config_Save_Job *job = data;
+
+   eina_lock_take(&_e_config_save_lock);
+   if (!job->done) _e_config_save_job_run(job);
+   eina_lock_release(&_e_config_save_lock);
+}
+
+static void
+_e_config_save_thread_end_cb(void *data, Ecore_Thread *th EINA_UNUSED)
+{
+   E_Config_Save_Job *job = data;
+
+   /* cancelled before it ran, the file still has to be written */
+   if (!job->done) _e_config_save_thread_cb(job, NULL);
+   _e_config_save_job = NULL;
+   _e_config_save_job_finish(job);
+   _e_config_save_next();
+}
+
+static void
+_e_config_save_next(void)
+{
+   if ((_e_config_save_job) || (!_e_config_save_jobs)) return;
+   _e_config_save_job = eina_list_data_get(_e_config_save_jobs);
+   _e_config_save_jobs = eina_list_remove_list(_e_config_save_jobs,
+                                               _e_config_save_jobs);
+   ecore_thread_run(_e_config_save_thread_cb,
+                    _e_config_save_thread_end_cb,
+                    _e_config_save_thread_end_cb,
+                    _e_config_save_job);
+}
+
+/* takes the encoded data */
+static int
+_e_config_save_job_add(void *data, int size, Eina_Bool compress, const char *base, Eina_Bool strict)
+{
+   E_Config_Save_Job *job, *job2;
+   Eina_List *l;
+   char tmp[4096 + 16];
+
+   snprintf(tmp, sizeof(tmp), "%s.cfg.tmp", base);
+   job = E_NEW(E_Config_Save_Job, 1);
+   if (!job)
+     {
+        free(data);
+        return 0;
+     }
+   job->data = data;
+   job->size = size;
+   job->compress = compress;
+   job->base = strdup(base);
+   job->tmp = strdup(tmp);
+   job->strict = strict;
+   job->queued = ecore_time_get();
+   EINA_LIST_FOREACH(_e_config_save_jobs, l, job2)
+     {
+        if (!strcmp(job2->base, base)) job2->skip = EINA_TRUE;
+     }
+   _e_config_save_jobs = eina_list_append(_e_config_save_jobs, job);
+   _e_config_save_next();
+   return 1;
+}
+
+/* finish all saves now, before config files are read or e exits */
+static void
+_e_config_save_wait(void)
+{
+   E_Config_Save_Job *job;
+
+   if ((!_e_config_save_job) && (!_e_config_save_jobs)) return;
+   /* the worker may not have got to the running job yet, then do it here.
+    * it is freed when its thread ends */
+   eina_lock_take(&_e_config_save_lock);
+   if ((_e_config_save_job) && (!_e_config_save_job->done))
+     _e_config_save_job_run(_e_config_save_job);
+   eina_lock_release(&_e_config_save_lock);
+   EINA_LIST_FREE(_e_config_save_jobs, job)
+     {
+        _e_config_save_job_run(job);
+        _e_config_save_job_finish(job);
+     }
+}
+
+E_API int
+e_config_profile_save(void)
+{
+   char base[4096];
+   const char *s;
+   char *data;
+
+   if ((s = getenv("E_CONF_PROFILE_NOSAVE")) && atoi(s))
+     return 1;
+
+   /* FIXME: check for other sessions fo E running */
+   e_user_dir_concat_static(base, "config/profile");
+   if (!_e_config_profile[0]) return 0;
+   data = strdup(_e_config_profile);
+   if (!data) return 0;
+   return _e_config_save_job_add(data, strlen(data), EINA_FALSE, base, EINA_TRUE);
 }
 
 /**
@@ -2115,9 +2309,9 @@ e_config_profile_save(void)
 E_API int
 e_config_domain_save(const char *domain, E_Config_DD *edd, const void *data)
 {
-   Eet_File *ef;
-   char buf[4096], buf2[4096];
-   int ok = 0, ret;
+   char buf[4096];
+   void *enc;
+   int size = 0;
    size_t len, len2;
 
    if (_e_config_save_block) return 0;
@@ -2133,47 +2327,9 @@ e_config_domain_save(const char *domain, E_Config_DD *edd, const void *data)
    len2 = eina_strlcpy(buf + len, domain, sizeof(buf) - len);
    if (len2 + sizeof(".cfg") >= sizeof(buf) - len) return 0;
 
-   len += len2;
-
-   memcpy(buf + len, ".cfg", sizeof(".cfg"));
-   len += sizeof(".cfg") - 1;
-
-   if (len + sizeof(".tmp") >= sizeof(buf)) return 0;
-   memcpy(buf2, buf, len);
-   memcpy(buf2 + len, ".tmp", sizeof(".tmp"));
-
-   ef = eet_open(buf2, EET_FILE_MODE_WRITE);
-   if (ef)
-     {
-        ok = eet_data_write(ef, edd, "config", data, 1);
-        if (_e_config_eet_close_handle(ef, buf2))
-          {
-             if (_e_config_revisions > 0)
-               {
-                  int i;
-                  char bsrc[4096], bdst[4096];
-
-                  for (i = _e_config_revisions; i > 1; i--)
-                    {
-                       e_user_dir_snprintf(bsrc, sizeof(bsrc), "config/%s/%s.%i.cfg", _e_config_profile, domain, i - 1);
-                       e_user_dir_snprintf(bdst, sizeof(bdst), "config/%s/%s.%i.cfg", _e_config_profile, domain, i);
-                       if ((ecore_file_exists(bsrc)) &&
-                           (ecore_file_size(bsrc)))
-                         {
-                            ecore_file_mv(bsrc, bdst);
-                         }
-                    }
-                  e_user_dir_snprintf(bsrc, sizeof(bsrc), "config/%s/%s.cfg", _e_config_profile, domain);
-                  e_user_dir_snprintf(bdst, sizeof(bdst), "config/%s/%s.1.cfg", _e_config_profile, domain);
-                  ecore_file_mv(bsrc, bdst);
-               }
-             ret = ecore_file_mv(buf2, buf);
-             if (!ret)
-               ERR("*** Error saving config. ***");
-          }
-        ecore_file_unlink(buf2);
-     }
-   return ok;
+   enc = eet_data_descriptor_encode(edd, data, &size);
+   if (!enc) return 0;
+   return _e_config_save_job_add(enc, size, EINA_TRUE, buf, EINA_FALSE);
 }
 
 E_API E_Config_Binding_Mouse *
@@ -2562,12 +2718,10 @@ _e_config_cb_timer(void *data)
 }
 
 static int
-_e_config_eet_close_handle(Eet_File *ef, char *file)
+_e_config_eet_error_handle(Eet_Error err, char *file)
 {
-   Eet_Error err;
    char *erstr = NULL;
 
-   err = eet_close(ef);
    switch (err)
      {
       case EET_ERROR_NONE:
@@ -288,6 +288,7 @@ struct _E_Config
    int                       screen_limits;
 
    int                       thumb_nice;
+   int                       thumb_workers; // number of thumbnailer processes, 0 for one per cpu core
 
    int                       ping_clients_interval; // GUI
 
@@ -649,6 +650,7 @@ E_API void                     e_config_load(void);
 E_API int                      e_config_save(void);
 E_API void                     e_config_save_flush(void);
 E_API void                     e_config_save_queue(void);
+E_API void                     e_config_save_latency_get(double *last, double *max);
 
 E_API const char              *e_config_profile_get(void);
 E_API char                    *e_config_profile_dir_get(const char *prof);
@@ -4,6 +4,8 @@
 
 #define OVERCLIP          128
 #define ICON_BOTTOM_SPACE 100
+#define INDEX_LEVELS      16 /* skip list levels of the icon sort index */
+#define ICON_POOL_MAX     128 /* unrealized icon objects kept for reuse */
 
 /* in order to check files (ie: extensions) use simpler and faster
  * strcasecmp version that instead of checking case for each
@@ -38,12 +40,16 @@ typedef struct _E_Fm2_Action            E_Fm2_Action;
 typedef struct _E_Fm2_Client            E_Fm2_Client;
 typedef struct _E_Fm2_Uri               E_Fm2_Uri;
 typedef struct _E_Fm2_Context_Menu_Data E_Fm2_Context_Menu_Data;
+typedef struct _E_Fm2_Index_Link        E_Fm2_Index_Link;
 
 struct _E_Fm2_Smart_Data
 {
    int          id;
    Evas_Coord   x, y, w, h, pw, ph;
    Eina_List   *icons;
+   Eina_Hash   *icons_hash; /* file -> queued or inserted icon */
+   E_Fm2_Icon  *index[INDEX_LEVELS]; /* inserted icons in sort order */
+   Eina_List   *icon_pool; /* unrealized icon objects for reuse */
    Evas_Object *obj;
    Evas_Object *clip;
    Evas_Object *underlay;
@@ -71,6 +77,13 @@ struct _E_Fm2_Smart_Data
       int        member_max;
    } regions;
    struct
+   {
+      E_Fm2_Region *from; /* first region changed since the last layout */
+      Evas_Coord    w, gw, gh; /* view and grid cell size of the last layout */
+      int           mode; /* view mode of the last layout */
+      Eina_Bool     full E_BITFIELD; /* a change no region tracks */
+   } layout;
+   struct
    {
       struct
       {
@@ -120,8 +133,6 @@ struct _E_Fm2_Smart_Data
    struct
    {
       Evas_Object *obj, *obj2;
-      Eina_List   *last_insert;
-      Eina_List  **list_index;
       int          iter;
    } tmp;
 
@@ -172,10 +183,16 @@ struct _E_Fm2_Smart_Data
    Efreet_Desktop      *desktop;
 };
 
+struct _E_Fm2_Index_Link
+{
+   E_Fm2_Icon *prev, *next;
+};
+
 struct _E_Fm2_Region
 {
    E_Fm2_Smart_Data *sd;
    Evas_Coord        x, y, w, h;
+   int               first; /* position of its first icon in sd->icons */
    Eina_List        *list;
    Eina_Bool         realized E_BITFIELD;
 };
@@ -198,6 +215,9 @@ struct _E_Fm2_Icon
    E_Dialog         *dialog;
 
    E_Fm2_Icon_Info   info;
+   Eina_List        *node; // in sd->icons
+   E_Fm2_Index_Link *index; // one link per level in the sort index
+   int               index_level;
    E_Fm2_Mount      *mount; // for dnd into unmounted dirs
    Ecore_Timer      *mount_timer; // autounmount in 15s
 
@@ -223,6 +243,8 @@ struct _E_Fm2_Icon
    Eina_Bool thumb_failed E_BITFIELD;
    Eina_Bool queued E_BITFIELD;
    Eina_Bool inserted E_BITFIELD;
+   Eina_Bool obj_dirty E_BITFIELD; // obj got signals that can't be undone
+   Eina_Bool mime_cached E_BITFIELD; // mime came from the slave's dir cache
 };
 
 struct _E_Fm2_Finfo
@@ -231,6 +253,7 @@ struct _E_Fm2_Finfo
    int         broken_link;
    const char *lnk;
    const char *rlnk;
+   const char *mime; // from the dir cache, listings only
 };
 
 struct _E_Fm2_Action
@@ -268,6 +291,9 @@ static void          _e_fm2_queue_process(Evas_Object *obj);
 static void          _e_fm2_queue_free(Evas_Object *obj);
 static void          _e_fm2_regions_free(Evas_Object *obj);
 static void          _e_fm2_regions_populate(Evas_Object *obj);
+static void          _e_fm2_regions_populate_from(Evas_Object *obj, Eina_List *start, int first);
+static void          _e_fm2_layout_changed(E_Fm2_Smart_Data *sd, E_Fm2_Region *rg);
+static Eina_Bool     _e_fm2_layout_incremental(E_Fm2_Smart_Data *sd);
 static void          _e_fm2_icons_place(Evas_Object *obj);
 static void          _e_fm2_icons_free(Evas_Object *obj);
 static void          _e_fm2_regions_eval(Evas_Object *obj);
@@ -277,7 +303,14 @@ static void          _e_fm2_dir_load_props(E_Fm2_Smart_Data *sd);
 static void          _e_fm2_dir_save_props(E_Fm2_Smart_Data *sd);
 
 static Eina_List    *_e_fm2_file_fm2_find(const char *file);
+static void          _e_fm2_path_views_add(Evas_Object *obj);
+static void          _e_fm2_path_views_del(Evas_Object *obj);
 static E_Fm2_Icon   *_e_fm2_icon_find(Evas_Object *obj, const char *file);
+static E_Fm2_Icon   *_e_fm2_icon_index_add(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic);
+static void          _e_fm2_icon_index_del(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic);
+static void          _e_fm2_icons_index_rebuild(E_Fm2_Smart_Data *sd);
+static void          _e_fm2_icon_insert(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic, E_Fm2_Icon *rel, Eina_Bool after);
+static void          _e_fm2_icon_remove(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic);
 static const char   *_e_fm2_uri_escape(const char *path);
 static Eina_List    *_e_fm2_uri_selected_icon_list_get(Eina_List *uri);
 
@@ -285,6 +318,7 @@ static E_Fm2_Icon   *_e_fm2_icon_new(E_Fm2_Smart_Data *sd, const char *file, E_F
 static void          _e_fm2_icon_unfill(E_Fm2_Icon *ic);
 static int           _e_fm2_icon_fill(E_Fm2_Icon *ic, E_Fm2_Finfo *finf);
 static void          _e_fm2_icon_free(E_Fm2_Icon *ic);
+static void          _e_fm2_icon_pool_flush(E_Fm2_Smart_Data *sd);
 static void          _e_fm2_icon_realize(E_Fm2_Icon *ic);
 static void          _e_fm2_icon_unrealize(E_Fm2_Icon *ic);
 static Eina_Bool     _e_fm2_icon_visible(const E_Fm2_Icon *ic);
@@ -483,6 +517,7 @@ static char *_e_fm2_meta_path = NULL;
 static Evas_Smart *_e_fm2_smart = NULL;
 static Eina_List *_e_fm2_list = NULL;
 static Eina_List *_e_fm2_list_remove = NULL;
+static Eina_Hash *_e_fm2_paths = NULL; /* real path -> list of views */
 static int _e_fm2_list_walking = 0;
 static Eina_List *_e_fm2_client_list = NULL;
 static Eina_List *_e_fm2_menu_contexts = NULL;
@@ -793,6 +828,7 @@ e_fm2_init(void)
    e_user_dir_concat_static(path, "fileman/metadata");
    ecore_file_mkpath(path);
    _e_fm2_meta_path = strdup(path);
+   _e_fm2_paths = eina_hash_string_superfast_new(NULL);
 
    {
       static const Evas_Smart_Class sc =
@@ -855,6 +891,7 @@ EINTERN int
 e_fm2_shutdown(void)
 {
    E_FREE_LIST(_e_fm2_list, evas_object_del);
+   E_FREE_FUNC(_e_fm2_paths, eina_hash_free);
 
    eina_stringshare_replace(&_e_fm2_icon_desktop_str, NULL);
    eina_stringshare_replace(&_e_fm2_icon_thumb_str, NULL);
@@ -933,7 +970,9 @@ _e_fm2_cb_mount_ok(void *data)
         /* Clean up typebuf. */
         _e_fm2_typebuf_hide(data);
         /* we only just now have the mount point so we should do stuff we couldn't do before */
+        _e_fm2_path_views_del(data);
         eina_stringshare_replace(&sd->realpath, sd->mount->volume->mount_point);
+        _e_fm2_path_views_add(data);
         eina_stringshare_replace(&sd->mount->mount_point, sd->mount->volume->mount_point);
         _e_fm2_dir_load_props(sd);
      }
@@ -1100,8 +1139,10 @@ e_fm2_path_set(Evas_Object *obj, const char *dev, const char *path)
    eina_stringshare_replace(&sd->new_file.filename, NULL);
    eina_stringshare_replace(&sd->dev, dev);
    eina_stringshare_replace(&sd->path, path);
+   _e_fm2_path_views_del(obj);
    eina_stringshare_del(sd->realpath);
    sd->realpath = real_path;
+   _e_fm2_path_views_add(obj);
    _e_fm2_queue_free(obj);
    _e_fm2_regions_free(obj);
    _e_fm2_icons_free(obj);
@@ -1218,6 +1259,7 @@ e_fm2_custom_theme_set(Evas_Object *obj, const char *path)
                                 "overlay");
    _e_fm2_theme_edje_object_set(sd, sd->sel_rect, "base/theme/fileman",
                                 "rubberband");
+   _e_fm2_icon_pool_flush(sd);
 }
 
 E_API void
@@ -1231,6 +1273,7 @@ e_fm2_custom_theme_content_set(Evas_Object *obj, const char *content)
                                 "list/drop_in");
    _e_fm2_theme_edje_object_set(sd, sd->overlay, "base/theme/fileman",
                                 "overlay");
+   _e_fm2_icon_pool_flush(sd);
 }
 
 E_API void
@@ -2683,12 +2726,44 @@ _e_fm2_client_eject(const char *udi)
    return _e_fm_client_send_new(E_FM_OP_EJECT, data, size);
 }
 
+/* hands the mime types worked out for a listing back to efm so its
+ * directory cache has them next time, see _e_fm_ipc_mime_cache() */
+static void
+_e_fm2_client_mime_cache_send(E_Fm2_Smart_Data *sd)
+{
+   Eina_Binbuf *buf;
+   Eina_List *l;
+   E_Fm2_Icon *ic;
+
+   if ((sd->listing) || (!sd->realpath)) return;
+   buf = eina_binbuf_new();
+   if (!buf) return;
+   EINA_LIST_FOREACH(sd->icons, l, ic)
+     {
+        if ((ic->mime_cached) || (!ic->info.mime) ||
+            (ic->info.mime == _e_fm2_mime_inode_directory))
+          continue;
+        eina_binbuf_append_length(buf, (void *)ic->info.file,
+                                  strlen(ic->info.file) + 1);
+        eina_binbuf_append_length(buf, (void *)ic->info.mime,
+                                  strlen(ic->info.mime) + 1);
+        /* only sent once */
+        ic->mime_cached = EINA_TRUE;
+     }
+   if (eina_binbuf_length_get(buf) > 0)
+     _e_fm_client_send(E_FM_OP_MIME_CACHE, sd->id,
+                       (void *)eina_binbuf_string_get(buf),
+                       eina_binbuf_length_get(buf));
+   eina_binbuf_free(buf);
+}
+
 static void
 _e_fm2_client_monitor_list_end(Evas_Object *obj)
 {
    E_Fm2_Smart_Data *sd;
 
    sd = evas_object_smart_data_get(obj);
+   _e_fm2_client_mime_cache_send(sd);
    sd->busy_count--;
    if (sd->busy_count == 0)
      {
@@ -2715,7 +2790,6 @@ _e_fm2_client_monitor_list_end(Evas_Object *obj)
         ecore_idler_del(sd->sort_idler);
         sd->sort_idler = NULL;
      }
-   E_FREE(sd->tmp.list_index);
    _e_fm2_queue_free(obj);
    _e_fm2_obj_icons_place(sd);
    _e_fm2_live_process_begin(obj);
@@ -2761,6 +2835,72 @@ _e_fm2_file_force_update(const char *path)
    free(dir);
 }
 
+/* Files from a directory listing are queued here and sorted in by the
+ * scan timer, which is started with the first of them.
+ */
+static void
+_e_fm2_listing_begin(E_Fm2_Smart_Data *sd)
+{
+   if (!sd->scan_timer)
+     {
+        sd->scan_timer =
+          ecore_timer_loop_add(0.5,
+                          _e_fm2_cb_scan_timer,
+                          sd->obj);
+        sd->busy_count++;
+        if (sd->busy_count == 1)
+          edje_object_signal_emit(sd->overlay, "e,state,busy,start", "e");
+     }
+   else
+     {
+        if ((eina_list_count(sd->icons) > 50) && (ecore_timer_interval_get(sd->scan_timer) < 1.5))
+          {
+             /* increase timer interval when loading large directories to
+              * dramatically improve load times
+              */
+             ecore_timer_interval_set(sd->scan_timer, 1.5);
+             ecore_timer_loop_reset(sd->scan_timer);
+          }
+     }
+}
+
+static void
+_e_fm2_listing_file_add(E_Fm2_Smart_Data *sd, const char *file, E_Fm2_Finfo *finf)
+{
+   unsigned int n;
+   char buf[1024];
+
+   if ((!strcmp(file, ".order")))
+     {
+        sd->order_file = EINA_TRUE;
+        return;
+     }
+   if ((file[0] == '.') && (!sd->show_hidden_files)) return;
+   n = eina_list_count(sd->queue) + eina_list_count(sd->icons);
+   _e_fm2_file_add(sd->obj, file, sd->order_file, NULL, 0, finf);
+   if (n - sd->overlay_count > 150)
+     {
+        sd->overlay_count = n + 1;
+        snprintf(buf, sizeof(buf), P_("%u file", "%u files", sd->overlay_count), sd->overlay_count);
+        edje_object_part_text_set(sd->overlay, "e.text.busy_label", buf);
+     }
+}
+
+static void
+_e_fm2_listing_end(E_Fm2_Smart_Data *sd)
+{
+   sd->listing = EINA_FALSE;
+   if (sd->scan_timer)
+     {
+        ecore_timer_interval_set(sd->scan_timer, 0.0001);
+        ecore_timer_loop_reset(sd->scan_timer);
+     }
+   else
+     {
+        _e_fm2_client_monitor_list_end(sd->obj);
+     }
+}
+
 E_API void
 e_fm2_client_data(Ecore_Ipc_Event_Client_Data *e)
 {
@@ -2838,6 +2978,7 @@ e_fm2_client_data(Ecore_Ipc_Event_Client_Data *e)
               finf.broken_link = broken_link;
               finf.lnk = lnk;
               finf.rlnk = rlnk;
+              finf.mime = NULL;
 
               evdir = ecore_file_dir_get(path);
               if ((evdir) && (sd->id == e->ref_to) &&
@@ -2865,67 +3006,11 @@ e_fm2_client_data(Ecore_Ipc_Event_Client_Data *e)
                    /*file add - listing*/
                    if (e->minor == E_FM_OP_FILE_ADD)    /*file add*/
                      {
-                        if (!sd->scan_timer)
-                          {
-                             sd->scan_timer =
-                               ecore_timer_loop_add(0.5,
-                                               _e_fm2_cb_scan_timer,
-                                               sd->obj);
-                             sd->busy_count++;
-                             if (sd->busy_count == 1)
-                               edje_object_signal_emit(sd->overlay, "e,state,busy,start", "e");
-                          }
-                        else
-                          {
-                             if ((eina_list_count(sd->icons) > 50) && (ecore_timer_interval_get(sd->scan_timer) < 1.5))
-                               {
-                                  /* increase timer interval when loading large directories to
-                                   * dramatically improve load times
-                                   */
-                                  ecore_timer_interval_set(sd->scan_timer, 1.5);
-                                  ecore_timer_loop_reset(sd->scan_timer);
-                               }
-                          }
+                        _e_fm2_listing_begin(sd);
                         if (path[0] != 0)
-                          {
-                             file = ecore_file_file_get(path);
-                             if ((!strcmp(file, ".order")))
-                               sd->order_file = EINA_TRUE;
-                             else
-                               {
-                                  unsigned int n;
-
-                                  n = eina_list_count(sd->queue) + eina_list_count(sd->icons);
-                                  if (!((file[0] == '.') &&
-                                        (!sd->show_hidden_files)))
-                                    {
-                                       char buf[1024];
-
-                                       _e_fm2_file_add(obj, file,
-                                                       sd->order_file,
-                                                       NULL, 0, &finf);
-                                       if (n - sd->overlay_count > 150)
-                                         {
-                                            sd->overlay_count = n + 1;
-                                            snprintf(buf, sizeof(buf), P_("%u file", "%u files", sd->overlay_count), sd->overlay_count);
-                                            edje_object_part_text_set(sd->overlay, "e.text.busy_label", buf);
-                                         }
-                                    }
-                               }
-                          }
+                          _e_fm2_listing_file_add(sd, ecore_file_file_get(path), &finf);
                         if (e->response == 2)    /* end of scan */
-                          {
-                             sd->listing = EINA_FALSE;
-                             if (sd->scan_timer)
-                               {
-                                  ecore_timer_interval_set(sd->scan_timer, 0.0001);
-                                  ecore_timer_loop_reset(sd->scan_timer);
-                               }
-                             else
-                               {
-                                  _e_fm2_client_monitor_list_end(obj);
-                               }
-                          }
+                          _e_fm2_listing_end(sd);
                      }
                    break;
                 }
@@ -2952,6 +3037,47 @@ e_fm2_client_data(Ecore_Ipc_Event_Client_Data *e)
            }
            break;
 
+           case E_FM_OP_FILE_ADD_BATCH: /*listing*/
+           {
+              E_Fm2_Finfo finf;
+              unsigned char *end;
+
+              /* see _e_fm_ipc_list_batch_send() for the format */
+              if ((sd->id != e->ref_to) || (!e->data) || (e->size <= 0)) break;
+              p = e->data;
+              end = p + e->size;
+              path = (char *)p;
+              if ((!dir) || (strcmp(dir, path))) break;
+              p += strlen(path) + 1;
+              _e_fm2_listing_begin(sd);
+              memset(&finf, 0, sizeof(E_Fm2_Finfo));
+              while ((p + sizeof(struct stat) + 5) <= end)
+                {
+                   memcpy(&(finf.st), p, sizeof(struct stat));
+                   p += sizeof(struct stat);
+
+                   finf.broken_link = p[0];
+                   p += 1;
+
+                   file = (char *)p;
+                   p += strlen(file) + 1;
+
+                   finf.lnk = (char *)p;
+                   p += strlen(finf.lnk) + 1;
+
+                   finf.rlnk = (char *)p;
+                   p += strlen(finf.rlnk) + 1;
+
+                   finf.mime = (char *)p;
+                   p += strlen(finf.mime) + 1;
+
+                   _e_fm2_listing_file_add(sd, file, &finf);
+                }
+              if (e->response == 2)    /* end of scan */
+                _e_fm2_listing_end(sd);
+           }
+           break;
+
            case E_FM_OP_FILE_DEL: /*file del*/
 //             printf("E_FM_OP_FILE_DEL\n");
              path = e->data;
@@ -3430,34 +3556,16 @@ _e_fm2_file_add(Evas_Object *obj, const char *file, int unique, Eina_Stringshare
 {
    E_Fm2_Smart_Data *sd;
    E_Fm2_Icon *ic, *ic2;
-   Eina_List *l;
 
    sd = evas_object_smart_data_get(obj);
    if (!sd) return;
    /* if we only want unique icon names - if it's there - ignore */
-   if (unique)
-     {
-        EINA_LIST_FOREACH(sd->icons, l, ic)
-          {
-             if (!strcmp(ic->info.file, file))
-               {
-                  sd->tmp.last_insert = NULL;
-                  return;
-               }
-          }
-        EINA_LIST_FOREACH(sd->queue, l, ic)
-          {
-             if (!strcmp(ic->info.file, file))
-               {
-                  sd->tmp.last_insert = NULL;
-                  return;
-               }
-          }
-     }
+   if ((unique) && (eina_hash_find(sd->icons_hash, file))) return;
    /* create icon obj and append to unsorted list */
    ic = _e_fm2_icon_new(sd, file, finf);
    if (ic)
      {
+        eina_hash_direct_add(sd->icons_hash, ic->info.file, ic);
         if (!file_rel)
           {
              if (ic->queued) abort();
@@ -3476,26 +3584,12 @@ _e_fm2_file_add(Evas_Object *obj, const char *file, int unique, Eina_Stringshare
           {
              if (ic->queued) abort();
              if (ic->inserted) abort();
-             EINA_LIST_FOREACH(sd->icons, l, ic2)
-               {
-                  if (ic2->info.file == file_rel)
-                    {
-                       if (after)
-                         sd->icons = eina_list_append_relative(sd->icons, ic, ic2);
-                       else
-                         sd->icons = eina_list_prepend_relative(sd->icons, ic, ic2);
-                       ic->inserted = EINA_TRUE;
-                       break;
-                    }
-               }
-             if (ic->inserted)
-               {
-                  sd->icons = eina_list_append(sd->icons, ic);
-                  ic->inserted = EINA_TRUE;
-               }
+             ic2 = eina_hash_find(sd->icons_hash, file_rel);
+             if ((ic2) && (!ic2->inserted)) ic2 = NULL;
+             _e_fm2_icon_index_add(sd, ic);
+             _e_fm2_icon_insert(sd, ic, ic2, after);
              sd->icons_place = eina_list_append(sd->icons_place, ic);
           }
-        sd->tmp.last_insert = NULL;
         sd->iconlist_changed = EINA_TRUE;
      }
 }
@@ -3505,37 +3599,28 @@ _e_fm2_file_del(Evas_Object *obj, const char *file)
 {
    E_Fm2_Smart_Data *sd;
    E_Fm2_Icon *ic;
-   Eina_List *l;
 
    sd = evas_object_smart_data_get(obj);
    if (!sd) return;
-   EINA_LIST_FOREACH(sd->icons, l, ic)
+   ic = eina_hash_find(sd->icons_hash, file);
+   if (!ic) return;
+   if (ic->inserted)
      {
-        if (!strcmp(ic->info.file, file))
+        _e_fm2_icon_remove(sd, ic);
+        sd->icons_place = eina_list_remove(sd->icons_place, ic);
+        if (ic->region)
           {
-             if (!ic->inserted) abort();
-             sd->icons = eina_list_remove_list(sd->icons, l);
-             ic->inserted = EINA_FALSE;
-             sd->icons_place = eina_list_remove(sd->icons_place, ic);
-             if (ic->region)
-               {
-                  ic->region->list = eina_list_remove(ic->region->list, ic);
-                  ic->region = NULL;
-               }
-             _e_fm2_icon_free(ic);
-             return;
+             ic->region->list = eina_list_remove(ic->region->list, ic);
+             ic->region = NULL;
           }
+        _e_fm2_icon_free(ic);
      }
-   EINA_LIST_FOREACH(sd->queue, l, ic)
+   else if (ic->queued)
      {
-        if (!strcmp(ic->info.file, file))
-          {
-             INF("MATCH!");
-             sd->queue = eina_list_remove_list(sd->queue, l);
-             ic->queued = EINA_FALSE;
-             _e_fm2_icon_free(ic);
-             return;
-          }
+        INF("MATCH!");
+        sd->queue = eina_list_remove(sd->queue, ic);
+        ic->queued = EINA_FALSE;
+        _e_fm2_icon_free(ic);
      }
 }
 
@@ -3783,8 +3868,7 @@ _e_fm2_queue_process(Evas_Object *obj)
 {
    E_Fm2_Smart_Data *sd;
    E_Fm2_Icon *ic, *ic2;
-   Eina_List *l, **ll;
-   int added = 0, i, p0, p1, n, v;
+   int added = 0;
    double t;
    char buf[4096];
 
@@ -3795,96 +3879,25 @@ _e_fm2_queue_process(Evas_Object *obj)
         if (sd->resize_job) ecore_job_del(sd->resize_job);
         sd->resize_job = ecore_job_add(_e_fm2_cb_resize_job, obj);
         evas_object_smart_callback_call(sd->obj, "changed", NULL);
-        sd->tmp.last_insert = NULL;
         return;
      }
 //   double tt = ecore_time_get();
 //   int queued = eina_list_count(sd->queue);
 /* take unsorted and insert into the icon list - reprocess regions */
    t = ecore_time_get();
-   if (!sd->tmp.last_insert)
-     {
-#if 1
-        n = eina_list_count(sd->icons);
-        E_FREE(sd->tmp.list_index);
-        if (n > 0)
-          sd->tmp.list_index = calloc(n, sizeof(Eina_List *));
-        if (sd->tmp.list_index)
-          {
-             ll = sd->tmp.list_index;
-             for (l = sd->icons; l; l = eina_list_next(l))
-               {
-                  *ll = l;
-                  ll++;
-               }
-             /* binary search first queue */
-             ic = eina_list_data_get(sd->queue);
-             p0 = 0; p1 = n;
-             i = (p0 + p1) / 2;
-             ll = sd->tmp.list_index;
-             if (ll[i])
-               do /* avoid garbage deref */
-                 {
-                    ic2 = eina_list_data_get(ll[i]);
-                    v = _e_fm2_cb_icon_sort(ic, ic2);
-                    if (v < 0) /* ic should go before ic2 */
-                      p1 = i;
-                    else /* ic should go at or after ic2 */
-                      p0 = i;
-                    i = (p0 + p1) / 2;
-                    l = ll[i];
-                 }
-               while ((p1 - p0) > 1);
-          }
-        else
-#endif
-        l = sd->icons;
-     }
-   else
-     l = sd->tmp.last_insert;
    while (sd->queue)
      {
         ic = sd->queue->data;
         sd->queue = eina_list_remove_list(sd->queue, sd->queue);
-        /* insertion sort - better than qsort for the way we are doing
-         * things - incrimentally scan and sort as we go as we now know
-         * that the queue files are in order, we speed up insertions to
-         * a worst case of O(n) where n is the # of files in the list
-         * so far
+        if (!ic->queued) abort();
+        if (ic->inserted) abort();
+        ic->queued = EINA_FALSE;
+        /* the sort index gives the icon to insert before in O(log n),
+         * with an order file the directory order is kept
          */
-        if (sd->order_file)
-          {
-             l = NULL;
-          }
-        else
-          {
-             EINA_LIST_FOREACH(l, l, ic2)
-               {
-                  if (_e_fm2_cb_icon_sort(ic, ic2) < 0)
-                    {
-                       if (!ic->queued) abort();
-                       if (ic->inserted) abort();
-                       ic->queued = EINA_FALSE;
-                       ic->inserted = EINA_TRUE;
-                       if (l == sd->icons)
-                         sd->icons = eina_list_prepend(sd->icons, ic);
-                       else
-                         sd->icons = eina_list_prepend_relative_list(sd->icons,
-                                                                     ic, l);
-                       sd->tmp.last_insert = l;
-                       break;
-                    }
-               }
-          }
-        if (!l)
-          {
-             if (!ic->queued) abort();
-             if (ic->inserted) abort();
-             ic->queued = EINA_FALSE;
-             ic->inserted = EINA_TRUE;
-             sd->icons = eina_list_append(sd->icons, ic);
-             sd->tmp.last_insert = eina_list_last(sd->icons);
-          }
+        ic2 = _e_fm2_icon_index_add(sd, ic);
+        if (sd->order_file) ic2 = NULL;
+        _e_fm2_icon_insert(sd, ic, ic2, EINA_FALSE);
         sd->icons_place = eina_list_append(sd->icons_place, ic);
         added++;
         /* if we spent more than 1/20th of a second inserting - give up
@@ -3938,10 +3951,23 @@ _e_fm2_regions_free(Evas_Object *obj)
    /* free up all regions */
    EINA_LIST_FREE(sd->regions.list, rg)
      _e_fm2_region_free(rg);
+   sd->layout.from = NULL;
 }
 
 static void
 _e_fm2_regions_populate(Evas_Object *obj)
+{
+   E_Fm2_Smart_Data *sd;
+
+   sd = evas_object_smart_data_get(obj);
+   if (!sd) return;
+   _e_fm2_regions_populate_from(obj, sd->icons, 0);
+}
+
+/* split the icons from start on into regions, first is the position of
+ * start in sd->icons */
+static void
+_e_fm2_regions_populate_from(Evas_Object *obj, Eina_List *start, int first)
 {
    E_Fm2_Smart_Data *sd;
    Eina_List *l;
@@ -3954,13 +3980,15 @@ _e_fm2_regions_populate(Evas_Object *obj)
    rg = NULL;
    evas_event_freeze(evas_object_evas_get(obj));
    edje_freeze();
-   EINA_LIST_FOREACH(sd->icons, l, ic)
+   EINA_LIST_FOREACH(start, l, ic)
      {
         if (!rg)
           {
              rg = _e_fm2_region_new(sd);
+             rg->first = first;
              sd->regions.list = eina_list_append(sd->regions.list, rg);
           }
+        first++;
         ic->region = rg;
         rg->list = eina_list_append(rg->list, ic);
         if (rg->w == 0)
@@ -3995,7 +4023,7 @@ _e_fm2_regions_populate(Evas_Object *obj)
           rg = NULL;
      }
    _e_fm2_regions_eval(obj);
-   EINA_LIST_FOREACH(sd->icons, l, ic)
+   EINA_LIST_FOREACH(start, l, ic)
      {
         if ((!ic->region->realized) && (ic->realized))
           _e_fm2_icon_unrealize(ic);
@@ -4005,6 +4033,120 @@ _e_fm2_regions_populate(Evas_Object *obj)
    evas_event_thaw(evas_object_evas_get(obj));
 }
 
+/* Record that the icons around region rg changed, NULL being an icon
+ * not laid out yet. Only the regions from the first changed one on are
+ * laid out again, see _e_fm2_layout_incremental().
+ */
+static void
+_e_fm2_layout_changed(E_Fm2_Smart_Data *sd, E_Fm2_Region *rg)
+{
+   if (!rg)
+     {
+        /* an icon added since the last layout is behind the first
+         * change, unless there is none */
+        if (!sd->layout.from) sd->layout.full = EINA_TRUE;
+        return;
+     }
+   if ((!sd->layout.from) || (rg->first < sd->layout.from->first))
+     sd->layout.from = rg;
+}
+
+static Eina_Bool
+_e_fm2_layout_fits(E_Fm2_Smart_Data *sd, Eina_List *start, int mode)
+{
+   Eina_List *l;
+   E_Fm2_Icon *ic;
+
+   EINA_LIST_FOREACH(start, l, ic)
+     {
+        if (mode == E_FM2_VIEW_MODE_LIST)
+          {
+             if (ic->min_w > sd->layout.gw) return EINA_FALSE;
+          }
+        else if ((ic->w > sd->layout.gw) || (ic->h > sd->layout.gh))
+          return EINA_FALSE;
+     }
+   return EINA_TRUE;
+}
+
+/* Lay out only the icons from the first changed region on, keeping the
+ * row width (list) or cell size (grid) of the last full layout. Returns
+ * EINA_FALSE if a full layout is needed instead.
+ */
+static Eina_Bool
+_e_fm2_layout_incremental(E_Fm2_Smart_Data *sd)
+{
+   Eina_List *l, *start;
+   E_Fm2_Region *rg, *prev = NULL;
+   E_Fm2_Icon *ic, *last = NULL;
+   Evas_Coord y = 0;
+   int mode, i = 0, first, cols = 1;
+
+   mode = _e_fm2_view_mode_get(sd);
+   if ((sd->layout.full) || (!sd->layout.from)) return EINA_FALSE;
+   if ((mode != sd->layout.mode) || (sd->w != sd->layout.w)) return EINA_FALSE;
+   if ((mode != E_FM2_VIEW_MODE_LIST) &&
+       (mode != E_FM2_VIEW_MODE_GRID_ICONS)) return EINA_FALSE;
+   if (sd->layout.gw <= 0) return EINA_FALSE;
+   l = eina_list_data_find_list(sd->regions.list, sd->layout.from);
+   if (!l) return EINA_FALSE;
+   start = sd->icons;
+   if (eina_list_prev(l))
+     {
+        prev = eina_list_data_get(eina_list_prev(l));
+        last = eina_list_last_data_get(prev->list);
+        if ((!last) || (!last->node)) return EINA_FALSE;
+        start = eina_list_next(last->node);
+        i = prev->first + eina_list_count(prev->list);
+        y = last->y + last->h;
+     }
+   if (mode == E_FM2_VIEW_MODE_GRID_ICONS)
+     {
+        cols = sd->w / sd->layout.gw;
+        if (cols < 1) cols = 1;
+        /* a part filled first row may change the view width */
+        if ((int)eina_list_count(sd->icons) < cols) return EINA_FALSE;
+     }
+   if (!_e_fm2_layout_fits(sd, start, mode)) return EINA_FALSE;
+
+   while (l)
+     {
+        rg = eina_list_data_get(l);
+        l = eina_list_next(l);
+        sd->regions.list = eina_list_remove(sd->regions.list, rg);
+        _e_fm2_region_free(rg);
+     }
+   sd->layout.from = NULL;
+   first = i;
+   EINA_LIST_FOREACH(start, l, ic)
+     {
+        if (mode == E_FM2_VIEW_MODE_LIST)
+          {
+             ic->x = 0;
+             ic->y = y;
+             ic->w = sd->layout.gw;
+             ic->odd = (i & 0x01);
+             y += ic->h;
+          }
+        else
+          {
+             ic->x = ((i % cols) * sd->layout.gw) + ((sd->layout.gw - ic->w) / 2);
+             ic->y = ((i / cols) * sd->layout.gh) + (sd->layout.gh - ic->h);
+          }
+        sd->min.w = MAX(ic->min_w, sd->min.w);
+        sd->min.h = MAX(ic->min_h, sd->min.h);
+        i++;
+     }
+   if (mode == E_FM2_VIEW_MODE_LIST)
+     sd->max.h = y;
+   else
+     sd->max.h = ((i + cols - 1) / cols) * sd->layout.gh;
+   _e_fm2_regions_populate_from(sd->obj, start, first);
+   /* tell our parent scrollview - if any, that we have changed */
+   evas_object_smart_callback_call(sd->obj, "changed", NULL);
+   return EINA_TRUE;
+}
+
 static void
 _e_fm2_icons_place_icons(E_Fm2_Smart_Data *sd)
 {
@@ -4049,6 +4191,8 @@ _e_fm2_icons_place_grid_icons(E_Fm2_Smart_Data *sd)
      }
    if (gw > 0) cols = sd->w / gw;
    if (cols < 1) cols = 1;
+   sd->layout.gw = gw;
+   sd->layout.gh = gh;
    x = 0; y = 0; col = 0;
    EINA_LIST_FOREACH(sd->icons, l, ic)
      {
@@ -4310,6 +4454,7 @@ _e_fm2_icons_place_list(E_Fm2_Smart_Data *sd)
      }
    EINA_LIST_FOREACH(sd->icons, l, ic)
      ic->w = w;
+   sd->layout.gw = w;
 }
 
 static void
@@ -4377,14 +4522,16 @@ _e_fm2_icons_free(Evas_Object *obj)
         if (ic->queued) abort();
         if (!ic->inserted) abort();
         ic->inserted = EINA_FALSE;
+        ic->node = NULL;
+        E_FREE(ic->index);
         _e_fm2_icon_free(ic);
      }
+   memset(sd->index, 0, sizeof(sd->index));
    sd->last_selected = NULL;
    sd->range_selected = NULL;
    eina_list_free(sd->icons_place);
    sd->icons_place = NULL;
-   sd->tmp.last_insert = NULL;
-   E_FREE(sd->tmp.list_index);
+   _e_fm2_icon_pool_flush(sd);
 }
 
 static void
@@ -4424,31 +4571,167 @@ _e_fm2_file_fm2_find(const char *file)
 
    dir = ecore_file_dir_get(file);
    if (!dir) return NULL;
-   EINA_LIST_FOREACH(_e_fm2_list, l, obj)
+   EINA_LIST_FOREACH(eina_hash_find(_e_fm2_paths, dir), l, obj)
      {
         if ((_e_fm2_list_walking > 0) &&
             (eina_list_data_find(_e_fm2_list_remove, obj))) continue;
-        if (!strcmp(e_fm2_real_path_get(obj), dir))
-          ret = eina_list_append(ret, obj);
+        ret = eina_list_append(ret, obj);
      }
    free(dir);
    return ret;
 }
 
+static void
+_e_fm2_path_views_add(Evas_Object *obj)
+{
+   E_Fm2_Smart_Data *sd;
+   Eina_List *l;
+
+   sd = evas_object_smart_data_get(obj);
+   if ((!sd) || (!sd->realpath)) return;
+   l = eina_hash_find(_e_fm2_paths, sd->realpath);
+   l = eina_list_append(l, obj);
+   eina_hash_set(_e_fm2_paths, sd->realpath, l);
+}
+
+static void
+_e_fm2_path_views_del(Evas_Object *obj)
+{
+   E_Fm2_Smart_Data *sd;
+   Eina_List *l;
+
+   sd = evas_object_smart_data_get(obj);
+   if ((!sd) || (!sd->realpath)) return;
+   l = eina_hash_find(_e_fm2_paths, sd->realpath);
+   l = eina_list_remove(l, obj);
+   if (l)
+     eina_hash_set(_e_fm2_paths, sd->realpath, l);
+   else
+     eina_hash_del_by_key(_e_fm2_paths, sd->realpath);
+}
+
 static E_Fm2_Icon *
 _e_fm2_icon_find(Evas_Object *obj, const char *file)
 {
    E_Fm2_Smart_Data *sd;
-   Eina_List *l;
    E_Fm2_Icon *ic;
 
    sd = evas_object_smart_data_get(obj);
    if (!sd) return NULL;
+   ic = eina_hash_find(sd->icons_hash, file);
+   if ((ic) && (ic->inserted)) return ic;
+   return NULL;
+}
+
+/* The sort index is a skip list over the inserted icons, ordered by
+ * _e_fm2_cb_icon_sort(). Its links are doubly linked so an icon can be
+ * taken out without comparing, even if its sort key changed meanwhile.
+ * Returns the icon ic was put in front of, NULL if it went last.
+ */
+static E_Fm2_Icon *
+_e_fm2_icon_index_add(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic)
+{
+   E_Fm2_Icon *update[INDEX_LEVELS], *x = NULL, *next;
+   int lvl, level = 1;
+
+   if (ic->index) return NULL;
+   while ((level < INDEX_LEVELS) && (!(rand() & 3))) level++;
+   ic->index = calloc(level, sizeof(E_Fm2_Index_Link));
+   if (!ic->index) return NULL;
+   ic->index_level = level;
+   for (lvl = INDEX_LEVELS - 1; lvl >= 0; lvl--)
+     {
+        next = x ? x->index[lvl].next : sd->index[lvl];
+        while ((next) && (_e_fm2_cb_icon_sort(ic, next) >= 0))
+          {
+             x = next;
+             next = x->index[lvl].next;
+          }
+        update[lvl] = x;
+     }
+   for (lvl = 0; lvl < level; lvl++)
+     {
+        x = update[lvl];
+        next = x ? x->index[lvl].next : sd->index[lvl];
+        ic->index[lvl].prev = x;
+        ic->index[lvl].next = next;
+        if (next) next->index[lvl].prev = ic;
+        if (x) x->index[lvl].next = ic;
+        else sd->index[lvl] = ic;
+     }
+   return ic->index[0].next;
+}
+
+static void
+_e_fm2_icon_index_del(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic)
+{
+   E_Fm2_Icon *prev, *next;
+   int lvl;
+
+   if (!ic->index) return;
+   for (lvl = 0; lvl < ic->index_level; lvl++)
+     {
+        prev = ic->index[lvl].prev;
+        next = ic->index[lvl].next;
+        if (prev) prev->index[lvl].next = next;
+        else sd->index[lvl] = next;
+        if (next) next->index[lvl].prev = prev;
+     }
+   E_FREE(ic->index);
+   ic->index_level = 0;
+}
+
+static void
+_e_fm2_icons_index_rebuild(E_Fm2_Smart_Data *sd)
+{
+   Eina_List *l;
+   E_Fm2_Icon *ic;
+
+   EINA_LIST_FOREACH(sd->icons, l, ic)
+     E_FREE(ic->index);
+   memset(sd->index, 0, sizeof(sd->index));
    EINA_LIST_FOREACH(sd->icons, l, ic)
      {
-        if (!strcmp(ic->info.file, file)) return ic;
+        ic->node = l;
+        _e_fm2_icon_index_add(sd, ic);
      }
-   return NULL;
+}
+
+/* Puts ic in sd->icons in front of or after rel, at the end without. */
+static void
+_e_fm2_icon_insert(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic, E_Fm2_Icon *rel, Eina_Bool after)
+{
+   if ((rel) && (rel->node))
+     _e_fm2_layout_changed(sd, rel->region);
+   else
+     _e_fm2_layout_changed(sd, eina_list_last_data_get(sd->regions.list));
+   if ((!rel) || (!rel->node))
+     {
+        sd->icons = eina_list_append(sd->icons, ic);
+        ic->node = eina_list_last(sd->icons);
+     }
+   else if (after)
+     {
+        sd->icons = eina_list_append_relative_list(sd->icons, ic, rel->node);
+        ic->node = eina_list_next(rel->node);
+     }
+   else
+     {
+        sd->icons = eina_list_prepend_relative_list(sd->icons, ic, rel->node);
+        ic->node = eina_list_prev(rel->node);
+     }
+   ic->inserted = EINA_TRUE;
+}
+
+static void
+_e_fm2_icon_remove(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic)
+{
+   if (!ic->inserted) abort();
+   _e_fm2_layout_changed(sd, ic->region);
+   sd->icons = eina_list_remove_list(sd->icons, ic->node);
+   ic->node = NULL;
+   _e_fm2_icon_index_del(sd, ic);
+   ic->inserted = EINA_FALSE;
 }
 
 /* Escape illegal caracters within an uri and return an eina_stringshare */
@@ -4668,11 +4951,17 @@ _e_fm2_icon_fill(E_Fm2_Icon *ic, E_Fm2_Finfo *finf)
    else
      ic->info.real_link = NULL;
    ic->info.broken_link = finf->broken_link;
+   ic->mime_cached = EINA_FALSE;
 
    if ((!ic->info.link) && (S_ISDIR(ic->info.statinfo.st_mode)))
      {
         ic->info.mime = eina_stringshare_ref(_e_fm2_mime_inode_directory);
      }
+   else if ((finf->mime) && (finf->mime[0]))
+     {
+        ic->info.mime = eina_stringshare_add(finf->mime);
+        ic->mime_cached = EINA_TRUE;
+     }
    else if (ic->info.real_link)
      {
         mime = _mime_get(ic->info.real_link);
@@ -4863,6 +5152,8 @@ _e_fm2_icon_free(E_Fm2_Icon *ic)
      ic->sd->selected_icons = eina_list_remove(ic->sd->selected_icons, ic);
    if (ic->drag.dnd_end_timer)
      ecore_timer_del(ic->drag.dnd_end_timer);
+   eina_hash_del(ic->sd->icons_hash, ic->info.file, ic);
+   free(ic->index);
    eina_stringshare_del(ic->info.file);
    eina_stringshare_del(ic->info.mime);
    eina_stringshare_del(ic->info.label);
@@ -4890,6 +5181,56 @@ _e_fm2_icon_label_click(void *data, Evas_Object *obj EINA_UNUSED, const char *em
    _e_fm2_file_rename(ic, NULL, NULL);
 }
 
+/* Icon objects are recycled: unrealized ones go to a per view pool,
+ * tagged with their theme group, and are taken from there before new
+ * ones are made. Objects with state that can't be reset are deleted.
+ */
+static Evas_Object *
+_e_fm2_icon_obj_get(E_Fm2_Smart_Data *sd, const char *category, const char *group)
+{
+   Evas_Object *o;
+   Eina_List *l;
+
+   EINA_LIST_FOREACH(sd->icon_pool, l, o)
+     {
+        if (!strcmp(evas_object_data_get(o, "e_fm2_group"), group))
+          {
+             sd->icon_pool = eina_list_remove_list(sd->icon_pool, l);
+             edje_object_freeze(o);
+             return o;
+          }
+     }
+   o = edje_object_add(evas_object_evas_get(sd->obj));
+   edje_object_freeze(o);
+   evas_object_smart_member_add(o, sd->obj);
+   _e_fm2_theme_edje_object_set(sd, o, category, group);
+   evas_object_data_set(o, "e_fm2_group", group);
+   return o;
+}
+
+static void
+_e_fm2_icon_obj_release(E_Fm2_Icon *ic)
+{
+   Evas_Object *o = ic->obj;
+
+   ic->obj = NULL;
+   if ((ic->obj_dirty) || (ic->selected) || (ic->entry_widget) ||
+       (eina_list_count(ic->sd->icon_pool) >= ICON_POOL_MAX))
+     {
+        ic->obj_dirty = EINA_FALSE;
+        evas_object_del(o);
+        return;
+     }
+   evas_object_hide(o);
+   ic->sd->icon_pool = eina_list_prepend(ic->sd->icon_pool, o);
+}
+
+static void
+_e_fm2_icon_pool_flush(E_Fm2_Smart_Data *sd)
+{
+   E_FREE_LIST(sd->icon_pool, evas_object_del);
+}
+
 static void
 _e_fm2_icon_realize(E_Fm2_Icon *ic)
 {
@@ -4897,10 +5238,6 @@ _e_fm2_icon_realize(E_Fm2_Icon *ic)
    /* actually create evas objects etc. */
    ic->realized = EINA_TRUE;
    evas_event_freeze(evas_object_evas_get(ic->sd->obj));
-   ic->obj = edje_object_add(evas_object_evas_get(ic->sd->obj));
-   edje_object_freeze(ic->obj);
-   evas_object_smart_member_add(ic->obj, ic->sd->obj);
-   evas_object_stack_below(ic->obj, ic->sd->drop);
    if (_e_fm2_view_mode_get(ic->sd) == E_FM2_VIEW_MODE_LIST)
      {
         const char *stacking;
@@ -4908,13 +5245,12 @@ _e_fm2_icon_realize(E_Fm2_Icon *ic)
 //        if (ic->sd->config->icon.fixed.w)
 //	  {
         if (ic->odd)
-          _e_fm2_theme_edje_object_set(ic->sd, ic->obj,
-                                       "base/theme/widgets",
-                                       "list_odd/fixed");
+          ic->obj = _e_fm2_icon_obj_get(ic->sd, "base/theme/widgets",
+                                        "list_odd/fixed");
         else
-          _e_fm2_theme_edje_object_set(ic->sd, ic->obj,
-                                       "base/theme/widgets",
-                                       "list/fixed");
+          ic->obj = _e_fm2_icon_obj_get(ic->sd, "base/theme/widgets",
+                                        "list/fixed");
+        evas_object_stack_below(ic->obj, ic->sd->drop);
         stacking = edje_object_data_get(ic->obj, "stacking");
         if (stacking)
           {
@@ -4938,13 +5274,12 @@ _e_fm2_icon_realize(E_Fm2_Icon *ic)
    else
      {
         if (ic->sd->config->icon.fixed.w)
-          _e_fm2_theme_edje_object_set(ic->sd, ic->obj,
-                                       "base/theme/fileman",
-                                       "icon/fixed");
+          ic->obj = _e_fm2_icon_obj_get(ic->sd, "base/theme/fileman",
+                                        "icon/fixed");
         else
-          _e_fm2_theme_edje_object_set(ic->sd, ic->obj,
-                                       "base/theme/fileman",
-                                       "icon/variable");
+          ic->obj = _e_fm2_icon_obj_get(ic->sd, "base/theme/fileman",
+                                        "icon/variable");
+        evas_object_stack_below(ic->obj, ic->sd->drop);
      }
    _e_fm2_icon_label_set(ic, ic->obj);
    evas_object_clip_set(ic->obj, ic->sd->clip);
@@ -5016,10 +5351,10 @@ _e_fm2_icon_unrealize(E_Fm2_Icon *ic)
    evas_object_event_callback_del_full(ic->obj, EVAS_CALLBACK_MOUSE_MOVE, _e_fm2_cb_icon_mouse_move, ic);
    evas_object_event_callback_del_full(ic->obj, EVAS_CALLBACK_MOUSE_IN, _e_fm2_cb_icon_mouse_in, ic);
    evas_object_event_callback_del_full(ic->obj, EVAS_CALLBACK_MOUSE_OUT, _e_fm2_cb_icon_mouse_out, ic);
-   evas_object_del(ic->obj);
-   ic->obj = NULL;
+   edje_object_signal_callback_del_full(ic->obj, "e,action,label,click", "e", _e_fm2_icon_label_click, ic);
    evas_object_del(ic->obj_icon);
    ic->obj_icon = NULL;
+   _e_fm2_icon_obj_release(ic);
 }
 
 static Eina_Bool
@@ -5110,7 +5445,15 @@ _e_fm2_icon_thumb(const E_Fm2_Icon *ic, Evas_Object *oic, int force)
         (!ic->sd->queue) &&
         (!ic->sd->sort_idler) &&
         (!ic->sd->listing)))
-     e_thumb_icon_begin(oic);
+     {
+        /* icons in view are thumbnailed before those in the overclip */
+        e_thumb_icon_priority_set(oic,
+          ((ic->x - ic->sd->pos.x) < ic->sd->w) &&
+          ((ic->x + ic->w - ic->sd->pos.x) > 0) &&
+          ((ic->y - ic->sd->pos.y) < ic->sd->h) &&
+          ((ic->y + ic->h - ic->sd->pos.y) > 0));
+        e_thumb_icon_begin(oic);
+     }
 }
 
 static void
@@ -7819,6 +8162,7 @@ _e_fm2_cb_icon_thumb_gen(void *data, Evas_Object *obj, void *event_info EINA_UNU
                 evas_object_size_hint_aspect_set(obj, EVAS_ASPECT_CONTROL_BOTH, w, h);
              }
              edje_object_part_swallow(ic->obj, "e.swallow.icon", obj);
+             ic->obj_dirty = EINA_TRUE;
              if (have_alpha)
                edje_object_signal_emit(ic->obj, "e,action,thumb,gen,alpha", "e");
              else
@@ -8277,6 +8621,7 @@ _e_fm2_cb_resize_job(void *data)
         break;
 
       case E_FM2_VIEW_MODE_GRID_ICONS:
+        if (_e_fm2_layout_incremental(sd)) break;
         _e_fm2_regions_free(sd->obj);
         _e_fm2_icons_place(sd->obj);
         _e_fm2_regions_populate(sd->obj);
@@ -8315,6 +8660,7 @@ _e_fm2_cb_resize_job(void *data)
         break;
 
       case E_FM2_VIEW_MODE_LIST:
+        if (_e_fm2_layout_incremental(sd)) break;
         if (sd->iconlist_changed)
           {
              E_Fm2_Icon *ic;
@@ -8334,6 +8680,10 @@ _e_fm2_cb_resize_job(void *data)
      }
    edje_thaw();
    evas_event_thaw(evas_object_evas_get(sd->obj));
+   sd->layout.from = NULL;
+   sd->layout.full = EINA_FALSE;
+   sd->layout.mode = _e_fm2_view_mode_get(sd);
+   sd->layout.w = sd->w;
    sd->iconlist_changed = EINA_FALSE;
    sd->pw = sd->w;
    sd->ph = sd->h;
@@ -8526,6 +8876,7 @@ _e_fm2_obj_icons_place(E_Fm2_Smart_Data *sd)
                    _e_fm2_theme_edje_object_set(ic->sd, ic->obj,
                                                 "base/theme/widgets",
                                                 th[ic->odd]);
+                   evas_object_data_set(ic->obj, "e_fm2_group", th[ic->odd]);
                    edje_object_part_swallow(ic->obj, "e.swallow.icon", prev);
                    _e_fm2_icon_label_set(ic, ic->obj);
                    if (ic->selected)
@@ -8549,6 +8900,8 @@ _e_fm2_smart_add(Evas_Object *obj)
 
    sd->view_mode = -1; /* unset */
    sd->icon_size = -1; /* unset */
+   sd->layout.mode = -1; /* no layout yet */
+   sd->icons_hash = eina_hash_string_superfast_new(NULL);
 
    sd->obj = obj;
    sd->clip = evas_object_rectangle_add(evas_object_evas_get(obj));
@@ -8623,6 +8976,7 @@ _e_fm2_smart_del(Evas_Object *obj)
    _e_fm2_queue_free(obj);
    _e_fm2_regions_free(obj);
    _e_fm2_icons_free(obj);
+   E_FREE_FUNC(sd->icons_hash, eina_hash_free);
    if (sd->selected_icons) eina_list_free(sd->selected_icons);
    if (sd->menu)
      {
@@ -8649,6 +9003,7 @@ _e_fm2_smart_del(Evas_Object *obj)
    sd->custom_theme = sd->custom_theme_content = NULL;
    eina_stringshare_del(sd->dev);
    eina_stringshare_del(sd->path);
+   _e_fm2_path_views_del(obj);
    eina_stringshare_del(sd->realpath);
    eina_stringshare_del(sd->new_file.filename);
    sd->dev = sd->path = sd->realpath = NULL;
@@ -10387,6 +10742,8 @@ _e_fm2_sort(void *data, E_Menu *m, E_Menu_Item *mi)
    sd = data;
    sd->icons = eina_list_sort(sd->icons, eina_list_count(sd->icons),
                               _e_fm2_cb_icon_sort);
+   _e_fm2_icons_index_rebuild(sd);
+   sd->layout.full = EINA_TRUE;
    _e_fm2_refresh(data, m, mi);
 }
 
@@ -11193,6 +11550,7 @@ _e_fm2_live_file_add(Evas_Object *obj, const char *file, const char *file_rel, i
    if (finf) memcpy(&(a->finf), finf, sizeof(E_Fm2_Finfo));
    a->finf.lnk = eina_stringshare_add(a->finf.lnk);
    a->finf.rlnk = eina_stringshare_add(a->finf.rlnk);
+   a->finf.mime = NULL;
    _e_fm2_live_process_begin(obj);
 }
 
@@ -11228,6 +11586,7 @@ _e_fm2_live_file_changed(Evas_Object *obj, const char *file, E_Fm2_Finfo *finf)
    if (finf) memcpy(&(a->finf), finf, sizeof(E_Fm2_Finfo));
    a->finf.lnk = eina_stringshare_add(a->finf.lnk);
    a->finf.rlnk = eina_stringshare_add(a->finf.rlnk);
+   a->finf.mime = NULL;
    _e_fm2_live_process_begin(obj);
 }
 
@@ -11242,7 +11601,6 @@ _e_fm2_live_process_begin(Evas_Object *obj)
        (sd->listing) || (sd->scan_timer)) return;
    sd->live.idler = ecore_idler_add(_e_fm2_cb_live_idler, obj);
    sd->live.timer = ecore_timer_loop_add(0.2, _e_fm2_cb_live_timer, obj);
-   sd->tmp.last_insert = NULL;
 }
 
 static void
@@ -11270,7 +11628,6 @@ _e_fm2_live_process_end(Evas_Object *obj)
         ecore_timer_del(sd->live.timer);
         sd->live.timer = NULL;
      }
-   sd->tmp.last_insert = NULL;
 }
 
 static void
@@ -11278,7 +11635,6 @@ _e_fm2_live_process(Evas_Object *obj)
 {
    E_Fm2_Smart_Data *sd;
    E_Fm2_Action *a;
-   Eina_List *l;
    E_Fm2_Icon *ic;
 
    sd = evas_object_smart_data_get(obj);
@@ -11324,33 +11680,34 @@ _e_fm2_live_process(Evas_Object *obj)
           {
              if (!((a->file[0] == '.') && (!sd->show_hidden_files)))
                {
-                  EINA_LIST_FOREACH(sd->icons, l, ic)
+                  ic = eina_hash_find(sd->icons_hash, a->file);
+                  if ((ic) && (ic->inserted))
                     {
-                       if (!strcmp(ic->info.file, a->file))
+                       /* the sort key may change, so re-index it */
+                       _e_fm2_icon_index_del(sd, ic);
+                       _e_fm2_layout_changed(sd, ic->region);
+                       if (ic->removable_state_change)
                          {
-                            if (ic->removable_state_change)
+                            _e_fm2_icon_unfill(ic);
+                            _e_fm2_icon_fill(ic, &(a->finf));
+                            ic->removable_state_change = EINA_FALSE;
+                            if ((ic->realized) && (ic->obj_icon))
                               {
-                                 _e_fm2_icon_unfill(ic);
-                                 _e_fm2_icon_fill(ic, &(a->finf));
-                                 ic->removable_state_change = EINA_FALSE;
-                                 if ((ic->realized) && (ic->obj_icon))
-                                   {
-                                      _e_fm2_icon_removable_update(ic);
-                                      _e_fm2_icon_label_set(ic, ic->obj);
-                                   }
+                                 _e_fm2_icon_removable_update(ic);
+                                 _e_fm2_icon_label_set(ic, ic->obj);
                               }
-                            else if (!eina_str_has_extension(ic->info.file, ".part"))
-                              {
-                                 int realized;
+                         }
+                       else if (!eina_str_has_extension(ic->info.file, ".part"))
+                         {
+                            int realized;
 
-                                 realized = ic->realized;
-                                 if (realized) _e_fm2_icon_unrealize(ic);
-                                 _e_fm2_icon_unfill(ic);
-                                 _e_fm2_icon_fill(ic, &(a->finf));
-                                 if (realized) _e_fm2_icon_realize(ic);
-                              }
-                            break;
+                            realized = ic->realized;
+                            if (realized) _e_fm2_icon_unrealize(ic);
+                            _e_fm2_icon_unfill(ic);
+                            _e_fm2_icon_fill(ic, &(a->finf));
+                            if (realized) _e_fm2_icon_realize(ic);
                          }
+                       _e_fm2_icon_index_add(sd, ic);
                     }
                }
           }
@@ -11525,6 +11882,7 @@ _update_volume_icon(E_Volume *v, E_Fm2_Icon *ic)
           e_icon_edje_emit(ic->obj_icon, "e,state,removable,empty", "e");
      }
 
+   ic->obj_dirty = EINA_TRUE;
    if (v)
      {
         if (v->mounted)
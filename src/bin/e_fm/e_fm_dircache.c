@@ -0,0 +1,385 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <Eina.h>
+#include <Ecore_File.h>
+
+#include "e_fm_main.h"
+#include "e_user.h"
+#include "e_sha1.h"
+#include "e_fm_dircache.h"
+
+/* A directory cache file holds what the lister found in a directory the
+ * last time it was listed, plus the mime types e_fm2 worked out for its
+ * files. It lives in fileman/dircache/ named by the sha1 of the directory
+ * path and is mmap()ed read only by the lister thread that uses it.
+ *
+ * header + entries, see E_Fm_Dircache_Entry for the entry format.
+ *
+ * The directory dev/ino must match for a cache to be used at all. If the
+ * directory mtime and ctime also match, no entries were added or removed
+ * since and the entries can be listed as they are. Otherwise the cache
+ * only supplies mime types of files whose stat info didn't change.
+ *
+ * Every so many writes the least recently used caches are deleted when
+ * there are more than DIRCACHE_MAX_FILES or they take more than
+ * DIRCACHE_MAX_SIZE. A cache file's mtime is its last use, opening it
+ * touches it if it is older than an hour.
+ */
+#define DIRCACHE_MAGIC   "EFMDIRC"
+#define DIRCACHE_VERSION 1
+
+#define DIRCACHE_MAX_FILES   4000
+#define DIRCACHE_MAX_SIZE    (64ULL * 1024 * 1024)
+#define DIRCACHE_PRUNE_EVERY 64
+
+typedef struct _E_Fm_Dircache_Header E_Fm_Dircache_Header;
+
+struct _E_Fm_Dircache_Header
+{
+   char               magic[8];
+   unsigned int       version;
+   unsigned int       stat_size;
+   unsigned int       count;
+   unsigned int       current;
+   unsigned long long dev;
+   unsigned long long ino;
+   long long          mtime;
+   long long          ctime;
+   unsigned long long size;
+};
+
+struct _E_Fm_Dircache
+{
+   void                       *map;
+   size_t                      map_size;
+   const E_Fm_Dircache_Header *hdr;
+   const unsigned char        *data;
+   size_t                      size;
+   Eina_Hash                  *names;
+   Eina_Bool                   current : 1;
+};
+
+typedef struct _E_Fm_Dircache_File E_Fm_Dircache_File;
+
+struct _E_Fm_Dircache_File
+{
+   time_t mtime;
+   off_t  size;
+   char   name[48]; // sha1 hex and a mkstemp() suffix
+};
+
+static char _e_fm_dircache_dir[PATH_MAX] = "";
+static Eina_Lock _e_fm_dircache_lock;
+static unsigned int _e_fm_dircache_writes = 0;
+
+static void
+_e_fm_dircache_file_get(const char *dir, char *buf, size_t size)
+{
+   static const char chmap[] = "0123456789abcdef";
+   unsigned char id[20];
+   char s[41];
+   int i;
+
+   e_sha1_sum((unsigned char *)dir, strlen(dir), id);
+   for (i = 0; i < 20; i++)
+     {
+        s[(i * 2) + 0] = chmap[(id[i] >> 4) & 0xf];
+        s[(i * 2) + 1] = chmap[(id[i]) & 0xf];
+     }
+   s[(i * 2)] = 0;
+   snprintf(buf, size, "%s/%s", _e_fm_dircache_dir, s);
+}
+
+/* called from the main loop before any lister runs so the threads only
+ * ever read the cache dir */
+void
+e_fm_dircache_init(void)
+{
+   e_user_dir_concat_static(_e_fm_dircache_dir, "fileman/dircache");
+   eina_lock_new(&_e_fm_dircache_lock);
+}
+
+static int
+_e_fm_dircache_file_sort_cb(const void *a, const void *b)
+{
+   const E_Fm_Dircache_File *f1 = a, *f2 = b;
+
+   if (f1->mtime < f2->mtime) return -1;
+   if (f1->mtime > f2->mtime) return 1;
+   return 0;
+}
+
+/* delete the least recently used caches down to 3/4 of the limits, so
+ * the next prune has some writes to go before it has work again */
+static void
+_e_fm_dircache_prune(void)
+{
+   E_Fm_Dircache_File *files = NULL, *f;
+   unsigned int num = 0, alloc = 0, i;
+   unsigned long long total = 0;
+   char path[PATH_MAX];
+   struct dirent *dp;
+   struct stat st;
+   DIR *dirp;
+
+   dirp = opendir(_e_fm_dircache_dir);
+   if (!dirp) return;
+   while ((dp = readdir(dirp)))
+     {
+        if ((dp->d_name[0] == '.') ||
+            (strlen(dp->d_name) >= sizeof(files->name)))
+          continue;
+        snprintf(path, sizeof(path), "%s/%s", _e_fm_dircache_dir, dp->d_name);
+        if ((stat(path, &st) == -1) || (!S_ISREG(st.st_mode))) continue;
+        if (num == alloc)
+          {
+             alloc = alloc ? alloc * 2 : 256;
+             f = realloc(files, alloc * sizeof(E_Fm_Dircache_File));
+             if (!f) break;
+             files = f;
+          }
+        f = &(files[num++]);
+        f->mtime = st.st_mtime;
+        f->size = st.st_size;
+        strcpy(f->name, dp->d_name);
+        total += st.st_size;
+     }
+   closedir(dirp);
+   if ((num > DIRCACHE_MAX_FILES) || (total > DIRCACHE_MAX_SIZE))
+     {
+        qsort(files, num, sizeof(E_Fm_Dircache_File), _e_fm_dircache_file_sort_cb);
+        for (i = 0; i < num; i++)
+          {
+             if ((num - i <= DIRCACHE_MAX_FILES / 4 * 3) &&
+                 (total <= DIRCACHE_MAX_SIZE / 4 * 3))
+               break;
+             snprintf(path, sizeof(path), "%s/%s", _e_fm_dircache_dir, files[i].name);
+             if (unlink(path) == 0) total -= files[i].size;
+          }
+     }
+   free(files);
+}
+
+E_Fm_Dircache *
+e_fm_dircache_open(const char *dir, const struct stat *dst)
+{
+   E_Fm_Dircache *dc;
+   const E_Fm_Dircache_Header *hdr;
+   struct stat st;
+   char path[PATH_MAX];
+   void *map;
+   int fd;
+
+   if ((!_e_fm_dircache_dir[0]) || (!dst->st_ino)) return NULL;
+   _e_fm_dircache_file_get(dir, path, sizeof(path));
+   fd = open(path, O_RDONLY | O_CLOEXEC);
+   if (fd < 0) return NULL;
+   if ((fstat(fd, &st) == -1) ||
+       (st.st_size < (off_t)sizeof(E_Fm_Dircache_Header)))
+     {
+        close(fd);
+        return NULL;
+     }
+   /* keep it from being pruned as unused */
+   if (st.st_mtime < time(NULL) - 3600) futimens(fd, NULL);
+   map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (map == MAP_FAILED) return NULL;
+
+   hdr = map;
+   if ((memcmp(hdr->magic, DIRCACHE_MAGIC, sizeof(DIRCACHE_MAGIC))) ||
+       (hdr->version != DIRCACHE_VERSION) ||
+       (hdr->stat_size != sizeof(struct stat)) ||
+       (hdr->size != (unsigned long long)st.st_size - sizeof(E_Fm_Dircache_Header)) ||
+       (hdr->dev != (unsigned long long)dst->st_dev) ||
+       (hdr->ino != (unsigned long long)dst->st_ino))
+     {
+        munmap(map, st.st_size);
+        return NULL;
+     }
+
+   dc = calloc(1, sizeof(E_Fm_Dircache));
+   if (!dc)
+     {
+        munmap(map, st.st_size);
+        return NULL;
+     }
+   dc->map = map;
+   dc->map_size = st.st_size;
+   dc->hdr = hdr;
+   dc->data = (const unsigned char *)map + sizeof(E_Fm_Dircache_Header);
+   dc->size = hdr->size;
+   dc->current = ((hdr->current) &&
+                  (hdr->mtime == (long long)dst->st_mtime) &&
+                  (hdr->ctime == (long long)dst->st_ctime));
+   return dc;
+}
+
+void
+e_fm_dircache_close(E_Fm_Dircache *dc)
+{
+   if (!dc) return;
+   if (dc->names) eina_hash_free(dc->names);
+   munmap(dc->map, dc->map_size);
+   free(dc);
+}
+
+/* EINA_TRUE if the set of entries in the directory is still the cached one */
+Eina_Bool
+e_fm_dircache_current(const E_Fm_Dircache *dc)
+{
+   return dc->current;
+}
+
+size_t
+e_fm_dircache_entry_parse(const unsigned char *p, size_t size, E_Fm_Dircache_Entry *ent)
+{
+   const char **strs[4] = { &ent->name, &ent->lnk, &ent->rlnk, &ent->mime };
+   size_t off, len;
+   int i;
+
+   if (size < sizeof(struct stat) + 1 + 4) return 0;
+   /* entries follow variable length strings so the stat is unaligned */
+   memcpy(&(ent->st), p, sizeof(struct stat));
+   ent->broken_link = p[sizeof(struct stat)];
+   off = sizeof(struct stat) + 1;
+   for (i = 0; i < 4; i++)
+     {
+        len = strnlen((const char *)p + off, size - off);
+        if (len == size - off) return 0;
+        *(strs[i]) = (const char *)p + off;
+        off += len + 1;
+     }
+   ent->data = p;
+   ent->size = off;
+   return off;
+}
+
+Eina_Bool
+e_fm_dircache_next(E_Fm_Dircache *dc, size_t *pos, E_Fm_Dircache_Entry *ent)
+{
+   size_t len;
+
+   if (*pos >= dc->size) return EINA_FALSE;
+   len = e_fm_dircache_entry_parse(dc->data + *pos, dc->size - *pos, ent);
+   if (!len) return EINA_FALSE;
+   *pos += len;
+   return EINA_TRUE;
+}
+
+/* the attributes that tell whether a file is still the one that was
+ * cached. atime changes on every read so the stat can't be compared as
+ * a whole */
+Eina_Bool
+e_fm_dircache_stat_same(const struct stat *a, const struct stat *b)
+{
+   return (a->st_ino == b->st_ino) && (a->st_dev == b->st_dev) &&
+          (a->st_mode == b->st_mode) && (a->st_size == b->st_size) &&
+          (a->st_mtime == b->st_mtime) && (a->st_ctime == b->st_ctime);
+}
+
+const char *
+e_fm_dircache_mime_find(E_Fm_Dircache *dc, const char *name, const struct stat *st)
+{
+   E_Fm_Dircache_Entry ent;
+   const unsigned char *p;
+   size_t pos = 0;
+
+   if (!dc->names)
+     {
+        dc->names = eina_hash_string_superfast_new(NULL);
+        if (!dc->names) return NULL;
+        while (e_fm_dircache_next(dc, &pos, &ent))
+          {
+             if (ent.mime[0])
+               eina_hash_direct_add(dc->names, ent.name, ent.data);
+          }
+     }
+   p = eina_hash_find(dc->names, name);
+   if (!p) return NULL;
+   if (!e_fm_dircache_entry_parse(p, dc->size - (p - dc->data), &ent))
+     return NULL;
+   if (!e_fm_dircache_stat_same(&(ent.st), st)) return NULL;
+   return ent.mime;
+}
+
+Eina_Bool
+e_fm_dircache_write(const char *dir, const struct stat *dst, Eina_Binbuf *entries, unsigned int count)
+{
+   E_Fm_Dircache_Header hdr;
+   char path[PATH_MAX], tmp[PATH_MAX + 8];
+   const unsigned char *p;
+   size_t size;
+   ssize_t len;
+   int fd;
+   Eina_Bool prune;
+
+   if ((!_e_fm_dircache_dir[0]) || (!dst->st_ino)) return EINA_FALSE;
+   if ((!ecore_file_is_dir(_e_fm_dircache_dir)) &&
+       (!ecore_file_mkpath(_e_fm_dircache_dir)))
+     return EINA_FALSE;
+
+   memset(&hdr, 0, sizeof(E_Fm_Dircache_Header));
+   memcpy(hdr.magic, DIRCACHE_MAGIC, sizeof(DIRCACHE_MAGIC));
+   hdr.version = DIRCACHE_VERSION;
+   hdr.stat_size = sizeof(struct stat);
+   hdr.count = count;
+   hdr.dev = dst->st_dev;
+   hdr.ino = dst->st_ino;
+   hdr.mtime = dst->st_mtime;
+   hdr.ctime = dst->st_ctime;
+   hdr.size = eina_binbuf_length_get(entries);
+   /* mtime has a granularity of a second on many filesystems, so a file
+    * added within the second the directory was read in may not change
+    * it. such a listing only serves mime types next time */
+   hdr.current = (dst->st_mtime < time(NULL) - 1);
+
+   _e_fm_dircache_file_get(dir, path, sizeof(path));
+   snprintf(tmp, sizeof(tmp), "%s.XXXXXX", path);
+   fd = mkstemp(tmp);
+   if (fd < 0) return EINA_FALSE;
+   if (write(fd, &hdr, sizeof(E_Fm_Dircache_Header)) != sizeof(E_Fm_Dircache_Header))
+     goto err;
+   p = eina_binbuf_string_get(entries);
+   size = eina_binbuf_length_get(entries);
+   while (size > 0)
+     {
+        len = write(fd, p, size);
+        if (len <= 0) goto err;
+        p += len;
+        size -= len;
+     }
+   close(fd);
+   if (rename(tmp, path) != 0)
+     {
+        unlink(tmp);
+        return EINA_FALSE;
+     }
+   /* listers write from their threads */
+   eina_lock_take(&_e_fm_dircache_lock);
+   prune = !(_e_fm_dircache_writes++ % DIRCACHE_PRUNE_EVERY);
+   eina_lock_release(&_e_fm_dircache_lock);
+   if (prune) _e_fm_dircache_prune();
+   return EINA_TRUE;
+err:
+   close(fd);
+   unlink(tmp);
+   return EINA_FALSE;
+}
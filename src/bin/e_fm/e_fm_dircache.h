@@ -0,0 +1,39 @@
+#ifndef E_FM_DIRCACHE_H
+#define E_FM_DIRCACHE_H
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <Eina.h>
+
+typedef struct _E_Fm_Dircache       E_Fm_Dircache;
+typedef struct _E_Fm_Dircache_Entry E_Fm_Dircache_Entry;
+
+/* one directory entry as laid out in the cache file and in listing
+ * batches:
+ *
+ * stat_info[stat size] + broken_link[1] + name[n]\0 + lnk[n]\0 +
+ * rlnk[n]\0 + mime[n]\0
+ */
+struct _E_Fm_Dircache_Entry
+{
+   struct stat          st;
+   int                  broken_link;
+   const char          *name;
+   const char          *lnk;
+   const char          *rlnk;
+   const char          *mime;
+   const unsigned char *data;
+   size_t               size;
+};
+
+void           e_fm_dircache_init(void);
+E_Fm_Dircache *e_fm_dircache_open(const char *dir, const struct stat *dst);
+void           e_fm_dircache_close(E_Fm_Dircache *dc);
+Eina_Bool      e_fm_dircache_current(const E_Fm_Dircache *dc);
+Eina_Bool      e_fm_dircache_next(E_Fm_Dircache *dc, size_t *pos, E_Fm_Dircache_Entry *ent);
+const char    *e_fm_dircache_mime_find(E_Fm_Dircache *dc, const char *name, const struct stat *st);
+size_t         e_fm_dircache_entry_parse(const unsigned char *p, size_t size, E_Fm_Dircache_Entry *ent);
+Eina_Bool      e_fm_dircache_stat_same(const struct stat *a, const struct stat *b);
+Eina_Bool      e_fm_dircache_write(const char *dir, const struct stat *dst, Eina_Binbuf *entries, unsigned int count);
+
+#endif
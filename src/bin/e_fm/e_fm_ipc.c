@@ -29,6 +29,7 @@
 #include <glob.h>
 #include <errno.h>
 #include <signal.h>
+#include <fcntl.h>
 #include <Ecore.h>
 #include <Ecore_Ipc.h>
 #include <Ecore_File.h>
@@ -41,13 +42,20 @@
 #undef E_TYPEDEFS
 #include "e_fm_main.h"
 #include "e_fm_shared_codec.h"
+#include "e_fm_dircache.h"
 #define DEF_MOD_BACKOFF          0.2
+/* a directory listing is sent in batches of at most this many entries
+ * or about this many bytes, whichever comes first */
+#define LIST_BATCH_FILES         256
+#define LIST_BATCH_SIZE          (64 * 1024)
 
 typedef struct _E_Dir          E_Dir;
 typedef struct _E_Fop          E_Fop;
 typedef struct _E_Mod          E_Mod;
 typedef struct _e_fm_ipc_slave E_Fm_Slave;
 typedef struct _E_Fm_Task      E_Fm_Task;
+typedef struct _E_Fm_List_Msg  E_Fm_List_Msg;
+typedef struct _E_Fm_Cache_Job E_Fm_Cache_Job;
 
 struct _E_Dir
 {
@@ -57,7 +65,12 @@ struct _E_Dir
    int                 mon_ref;
    E_Dir              *mon_real;
    Eina_List          *fq;
-   Eina_Iterator      *lister_iterator;
+   int                 lister_fd;
+   struct stat         lister_st;
+   Eina_Binbuf        *lister_batch;
+   Eina_Binbuf        *cache;
+   unsigned int        cache_count;
+   Eina_Binbuf        *cache_mimes;
    Ecore_Thread       *lister_thread;
    Eina_List          *recent_mods;
    Ecore_Timer        *recent_clean;
@@ -107,6 +120,22 @@ struct _E_Fm_Task
    int          x, y;
 };
 
+/* sent from the lister thread to the main loop */
+struct _E_Fm_List_Msg
+{
+   E_Fm_Op_Type op;
+   int          response;
+   Eina_Binbuf *buf;
+};
+
+struct _E_Fm_Cache_Job
+{
+   const char   *dir;
+   struct stat   st;
+   Eina_Binbuf  *entries;
+   unsigned int  count;
+};
+
 /* local subsystem globals */
 Ecore_Ipc_Server *_e_fm_ipc_server = NULL;
 
@@ -152,6 +181,7 @@ static void        _e_fm_ipc_file_mon_dir_del(E_Dir *ed, const char *path);
 static Eina_Bool   _e_fm_ipc_cb_fop_trash_idler(void *data);
 static void        _e_fm_ipc_reorder(const char *file, const char *dst, const char *relative, int after);
 static void        _e_fm_ipc_dir_del(E_Dir *ed);
+static void        _e_fm_ipc_mime_cache(E_Dir *ed, const unsigned char *data, size_t size);
 
 static char *_e_fm_ipc_prepare_command(E_Fm_Op_Type type, const char *args);
 
@@ -180,6 +210,7 @@ _e_fm_ipc_init(void)
    ecore_event_handler_add(ECORE_IPC_EVENT_SERVER_ADD, _e_fm_ipc_cb_server_add, NULL);
    ecore_event_handler_add(ECORE_IPC_EVENT_SERVER_DEL, _e_fm_ipc_cb_server_del, NULL);
    ecore_event_handler_add(ECORE_IPC_EVENT_SERVER_DATA, _e_fm_ipc_cb_server_data, NULL);
+   e_fm_dircache_init();
 
    return 1;
 }
@@ -227,93 +258,456 @@ _e_fm_ipc_monitor_start(int id, const char *path)
    _e_fm_ipc_monitor_start_try(task);
 }
 
+/* Listings are sent as E_FM_OP_FILE_ADD_BATCH messages in this format:
+ *
+ * dir[n]\0 + entries, each being
+ * stat_info[stat size] + broken_link[1] + name[n]\0 + lnk[n]\0 + rlnk[n]\0 +
+ * mime[n]\0
+ *
+ * which is also how entries are kept in the directory cache, see
+ * e_fm_dircache.h. mime is empty unless the cache knows it.
+ * the response is 1 for a batch with more to follow and 2 for the last one.
+ * like single file adds this assumes e and e_fm are built together.
+ */
 static void
-_e_fm_ipc_cb_list_result(void *data, Ecore_Thread *thread EINA_UNUSED, void *msg_data)
+_e_fm_ipc_list_batch_send(E_Dir *ed, Eina_Binbuf *buf, int response)
 {
-   E_Dir *ed = data;
-   Eina_List *files = msg_data;
-   const char *s;
+   ecore_ipc_server_send(_e_fm_ipc_server, 6 /*E_IPC_DOMAIN_FM*/,
+                         E_FM_OP_FILE_ADD_BATCH, 0, ed->id, response,
+                         (void *)eina_binbuf_string_get(buf),
+                         eina_binbuf_length_get(buf));
+}
+
+static Eina_Binbuf *
+_e_fm_ipc_list_batch_new(E_Dir *ed)
+{
+   Eina_Binbuf *buf;
+
+   buf = eina_binbuf_new();
+   if (!buf) return NULL;
+   eina_binbuf_append_length(buf, (void *)ed->dir, strlen(ed->dir) + 1);
+   return buf;
+}
+
+static Eina_Bool
+_e_fm_ipc_list_batch_full(Eina_Binbuf *buf, int n)
+{
+   return (n >= LIST_BATCH_FILES) ||
+          (eina_binbuf_length_get(buf) >= LIST_BATCH_SIZE);
+}
+
+static void
+_e_fm_ipc_list_msg_send(Ecore_Thread *thread, E_Fm_Op_Type op, int response, Eina_Binbuf *buf)
+{
+   E_Fm_List_Msg *msg;
+
+   msg = malloc(sizeof(E_Fm_List_Msg));
+   if (!msg)
+     {
+        eina_binbuf_free(buf);
+        return;
+     }
+   msg->op = op;
+   msg->response = response;
+   msg->buf = buf;
+   ecore_thread_feedback(thread, msg);
+}
+
+static void
+_e_fm_ipc_list_path_get(E_Dir *ed, const char *name, char *path, size_t size)
+{
+   if (!strcmp(ed->dir, "/")) snprintf(path, size, "/%s", name);
+   else snprintf(path, size, "%s/%s", ed->dir, name);
+}
 
-   if (!files) _e_fm_ipc_file_add(ed, "", 2);
+/* the same as _e_fm_ipc_file_add_mod() does for a single file, but
+ * relative to the directory fd so no path lookups are repeated */
+static Eina_Bool
+_e_fm_ipc_list_entry_add(E_Dir *ed, int dfd, const char *name, Eina_Bool maybe_link, Eina_Binbuf *buf, E_Fm_Dircache *dc)
+{
+   struct stat st;
+   char lnk[PATH_MAX], path[PATH_MAX], *rlnk = NULL;
+   const char *mime = NULL;
+   ssize_t len = 0;
+   int broken_lnk = 0;
+
+   if (maybe_link) len = readlinkat(dfd, name, lnk, sizeof(lnk) - 1);
+   if (len < 0) len = 0;
+   lnk[len] = 0;
+   memset(&st, 0, sizeof(struct stat));
+   if (fstatat(dfd, name, &st, 0) == -1)
+     {
+        if (!len) return EINA_FALSE;
+        memset(&st, 0, sizeof(struct stat));
+        broken_lnk = 1;
+     }
+   if ((len) && (lnk[0] != '/'))
+     {
+        _e_fm_ipc_list_path_get(ed, name, path, sizeof(path));
+        rlnk = realpath(path, NULL);
+        if ((!rlnk) || (!rlnk[0])) broken_lnk = 1;
+     }
+   if ((dc) && (!broken_lnk)) mime = e_fm_dircache_mime_find(dc, name, &st);
+
+   eina_binbuf_append_length(buf, (void *)&st, sizeof(struct stat));
+   eina_binbuf_append_char(buf, !!broken_lnk);
+   eina_binbuf_append_length(buf, (void *)name, strlen(name) + 1);
+   eina_binbuf_append_length(buf, (void *)lnk, len + 1);
+   if (rlnk)
+     eina_binbuf_append_length(buf, (void *)rlnk, strlen(rlnk) + 1);
+   else if ((len) && (lnk[0] == '/'))
+     eina_binbuf_append_length(buf, (void *)lnk, len + 1);
    else
+     eina_binbuf_append_char(buf, 0);
+   if (mime) eina_binbuf_append_length(buf, (void *)mime, strlen(mime) + 1);
+   else eina_binbuf_append_char(buf, 0);
+   free(rlnk);
+   return EINA_TRUE;
+}
+
+/* a file that changed or went away while the directory itself did not,
+ * sent like the file monitor would */
+static void
+_e_fm_ipc_list_live_send(E_Dir *ed, Ecore_Thread *thread, const E_Fm_Dircache_Entry *ent, Eina_Bool del)
+{
+   Eina_Binbuf *buf;
+   char path[PATH_MAX];
+
+   buf = eina_binbuf_new();
+   if (!buf) return;
+   _e_fm_ipc_list_path_get(ed, ent->name, path, sizeof(path));
+   if (del)
      {
-        EINA_LIST_FREE(files, s)
-          {
-             _e_fm_ipc_file_add(ed, s, 2);
-             eina_stringshare_del(s);
-          }
+        eina_binbuf_append_length(buf, (void *)path, strlen(path) + 1);
+        _e_fm_ipc_list_msg_send(thread, E_FM_OP_FILE_DEL, 0, buf);
+        return;
      }
+   /* see _e_fm_ipc_file_add_mod() for the format */
+   eina_binbuf_append_length(buf, (void *)&(ent->st), sizeof(struct stat));
+   eina_binbuf_append_char(buf, !!ent->broken_link);
+   eina_binbuf_append_length(buf, (void *)path, strlen(path) + 1);
+   eina_binbuf_append_length(buf, (void *)ent->lnk, strlen(ent->lnk) + 1);
+   eina_binbuf_append_length(buf, (void *)ent->rlnk, strlen(ent->rlnk) + 1);
+   _e_fm_ipc_list_msg_send(thread, E_FM_OP_FILE_CHANGE, 0, buf);
 }
 
+/* the directory has the entries it had when it was cached. they are sent
+ * straight from the cache and checked afterwards, so the listing doesn't
+ * wait for a stat of every file. */
 static void
-_e_fm_ipc_cb_list(void *data, Ecore_Thread *thread)
+_e_fm_ipc_list_cached(E_Dir *ed, Ecore_Thread *thread, E_Fm_Dircache *dc)
 {
-   E_Dir *ed = data;
-   Eina_List *files = NULL;
-   int i, total = 0;
-   Eina_File_Direct_Info *info;
-   Eina_Iterator *it = ed->lister_iterator;
-   char buf[4096];
-   const char *s;
-
-   if (!strcmp(ed->dir, "/")) snprintf(buf, sizeof(buf), "/.order");
-   else snprintf(buf, sizeof(buf), "%s/.order", ed->dir);
-   if (ecore_file_exists(buf))
+   E_Fm_Dircache_Entry ent, now;
+   Eina_Binbuf *buf, *cache, *ebuf;
+   Eina_Bool dirty = EINA_FALSE;
+   unsigned int count = 0;
+   size_t pos = 0;
+   int n = 0;
+
+   buf = _e_fm_ipc_list_batch_new(ed);
+   if (!buf) return;
+   while (e_fm_dircache_next(dc, &pos, &ent))
      {
-        s = eina_stringshare_add(buf);
-        files = eina_list_append(files, s);
+        eina_binbuf_append_length(buf, ent.data, ent.size);
+        n++;
+        if (_e_fm_ipc_list_batch_full(buf, n))
+          {
+             _e_fm_ipc_list_msg_send(thread, E_FM_OP_FILE_ADD_BATCH, 1, buf);
+             buf = _e_fm_ipc_list_batch_new(ed);
+             if (!buf) return;
+             n = 0;
+          }
      }
-   i = 0;
-   EINA_ITERATOR_FOREACH(it, info)
+   _e_fm_ipc_list_msg_send(thread, E_FM_OP_FILE_ADD_BATCH, 2, buf);
+
+   cache = eina_binbuf_new();
+   ebuf = eina_binbuf_new();
+   if ((!cache) || (!ebuf)) goto end;
+   pos = 0;
+   while (e_fm_dircache_next(dc, &pos, &ent))
      {
-        if (!strcmp(info->path + info->name_start, ".order")) continue;
-        if (ecore_thread_check(thread))
+        if (ecore_thread_check(thread)) goto end;
+        eina_binbuf_reset(ebuf);
+        /* gone without the directory changing, network mounts do that */
+        if (!_e_fm_ipc_list_entry_add(ed, ed->lister_fd, ent.name,
+                                      !!ent.lnk[0], ebuf, NULL))
           {
-             EINA_LIST_FREE(files, s) eina_stringshare_del(s);
-             break;
+             _e_fm_ipc_list_live_send(ed, thread, &ent, EINA_TRUE);
+             dirty = EINA_TRUE;
+             continue;
           }
-        s = eina_stringshare_add(info->path);
-        files = eina_list_append(files, s);
-        total++;
-        i++;
-        if (i >= 16)
+        count++;
+        e_fm_dircache_entry_parse(eina_binbuf_string_get(ebuf),
+                                  eina_binbuf_length_get(ebuf), &now);
+        if ((e_fm_dircache_stat_same(&(ent.st), &(now.st))) &&
+            (ent.broken_link == now.broken_link) &&
+            (!strcmp(ent.lnk, now.lnk)) && (!strcmp(ent.rlnk, now.rlnk)))
           {
-             i = 0;
-             ecore_thread_feedback(thread, files);
-             files = NULL;
+             eina_binbuf_append_length(cache, ent.data, ent.size);
+             continue;
           }
+        eina_binbuf_append_length(cache, now.data, now.size);
+        _e_fm_ipc_list_live_send(ed, thread, &now, EINA_FALSE);
+        dirty = EINA_TRUE;
      }
-   if (files) ecore_thread_feedback(thread, files);
-   if (total == 0) ecore_thread_feedback(thread, NULL);
+   if (dirty) e_fm_dircache_write(ed->dir, &(ed->lister_st), cache, count);
+   ed->cache = cache;
+   ed->cache_count = count;
+   cache = NULL;
+end:
+   if (cache) eina_binbuf_free(cache);
+   if (ebuf) eina_binbuf_free(ebuf);
+}
+
+/* adds an entry to the batch and keeps a copy for the cache */
+static Eina_Bool
+_e_fm_ipc_list_dir_entry_add(E_Dir *ed, int dfd, const char *name, Eina_Bool maybe_link, Eina_Binbuf *buf, E_Fm_Dircache *dc)
+{
+   size_t off;
+
+   off = eina_binbuf_length_get(buf);
+   if (!_e_fm_ipc_list_entry_add(ed, dfd, name, maybe_link, buf, dc))
+     return EINA_FALSE;
+   if (ed->cache)
+     eina_binbuf_append_length(ed->cache, eina_binbuf_string_get(buf) + off,
+                               eina_binbuf_length_get(buf) - off);
+   ed->cache_count++;
+   return EINA_TRUE;
 }
 
 static void
-_e_fm_ipc_cb_list_end(void *data, Ecore_Thread *thread EINA_UNUSED)
+_e_fm_ipc_list_dir(E_Dir *ed, Ecore_Thread *thread, E_Fm_Dircache *dc)
+{
+   Eina_Binbuf *buf;
+   DIR *dirp;
+   struct dirent *de;
+   int dfd, n = 0;
+
+   buf = _e_fm_ipc_list_batch_new(ed);
+   if (!buf) return;
+   ed->cache = eina_binbuf_new();
+   ed->cache_count = 0;
+   dfd = ed->lister_fd;
+   /* .order goes first so the view knows about it before any file */
+   if (_e_fm_ipc_list_dir_entry_add(ed, dfd, ".order", EINA_TRUE, buf, dc)) n++;
+   dirp = fdopendir(dfd);
+   if (dirp)
+     {
+        /* closedir() closes the fd */
+        ed->lister_fd = -1;
+        while ((de = readdir(dirp)))
+          {
+             if ((de->d_name[0] == '.') &&
+                 ((!de->d_name[1]) ||
+                  ((de->d_name[1] == '.') && (!de->d_name[2]))))
+               continue;
+             if (!strcmp(de->d_name, ".order")) continue;
+             if (ecore_thread_check(thread)) break;
+             /* d_type saves a readlink() per file where it is known */
+             if (!_e_fm_ipc_list_dir_entry_add(ed, dfd, de->d_name,
+                                               (de->d_type == DT_LNK) ||
+                                               (de->d_type == DT_UNKNOWN),
+                                               buf, dc))
+               continue;
+             n++;
+             if (_e_fm_ipc_list_batch_full(buf, n))
+               {
+                  _e_fm_ipc_list_msg_send(thread, E_FM_OP_FILE_ADD_BATCH, 1, buf);
+                  buf = _e_fm_ipc_list_batch_new(ed);
+                  if (!buf) break;
+                  n = 0;
+               }
+          }
+        closedir(dirp);
+     }
+   /* only a complete listing is worth caching */
+   if ((ed->cache) && ((!dirp) || (ecore_thread_check(thread))))
+     {
+        eina_binbuf_free(ed->cache);
+        ed->cache = NULL;
+     }
+   if (ed->cache)
+     e_fm_dircache_write(ed->dir, &(ed->lister_st), ed->cache, ed->cache_count);
+   /* the last batch, even if empty, ends the listing */
+   ed->lister_batch = buf;
+}
+
+static void
+_e_fm_ipc_cb_list_result(void *data, Ecore_Thread *thread EINA_UNUSED, void *msg_data)
 {
    E_Dir *ed = data;
+   E_Fm_List_Msg *msg = msg_data;
+
+   if ((!ed->delete_me) && (msg->op == E_FM_OP_FILE_ADD_BATCH))
+     _e_fm_ipc_list_batch_send(ed, msg->buf, msg->response);
+   else if (!ed->delete_me)
+     ecore_ipc_server_send(_e_fm_ipc_server, 6 /*E_IPC_DOMAIN_FM*/,
+                           msg->op, 0, ed->id, msg->response,
+                           (void *)eina_binbuf_string_get(msg->buf),
+                           eina_binbuf_length_get(msg->buf));
+   eina_binbuf_free(msg->buf);
+   free(msg);
+}
+
+static void
+_e_fm_ipc_cb_list(void *data, Ecore_Thread *thread)
+{
+   E_Dir *ed = data;
+   E_Fm_Dircache *dc;
+
+   dc = e_fm_dircache_open(ed->dir, &(ed->lister_st));
+   if ((dc) && (e_fm_dircache_current(dc)))
+     _e_fm_ipc_list_cached(ed, thread, dc);
+   else
+     _e_fm_ipc_list_dir(ed, thread, dc);
+   e_fm_dircache_close(dc);
+}
+
+static void
+_e_fm_ipc_list_free(E_Dir *ed)
+{
    ed->lister_thread = NULL;
-   eina_iterator_free(ed->lister_iterator);
-   ed->lister_iterator = NULL;
+   if (ed->lister_fd >= 0) close(ed->lister_fd);
+   ed->lister_fd = -1;
+   if (ed->lister_batch) eina_binbuf_free(ed->lister_batch);
+   ed->lister_batch = NULL;
+}
+
+static void
+_e_fm_ipc_cb_list_end(void *data, Ecore_Thread *thread EINA_UNUSED)
+{
+   E_Dir *ed = data;
+
+   if ((ed->lister_batch) && (!ed->delete_me))
+     _e_fm_ipc_list_batch_send(ed, ed->lister_batch, 2);
+   _e_fm_ipc_list_free(ed);
    if (ed->delete_me) _e_fm_ipc_dir_del(ed);
+   else if (ed->cache_mimes)
+     {
+        _e_fm_ipc_mime_cache(ed, eina_binbuf_string_get(ed->cache_mimes),
+                             eina_binbuf_length_get(ed->cache_mimes));
+        eina_binbuf_free(ed->cache_mimes);
+        ed->cache_mimes = NULL;
+     }
 }
 
 static void
 _e_fm_ipc_cb_list_cancel(void *data, Ecore_Thread *thread EINA_UNUSED)
 {
    E_Dir *ed = data;
-   ed->lister_thread = NULL;
-   eina_iterator_free(ed->lister_iterator);
-   ed->lister_iterator = NULL;
+
+   _e_fm_ipc_list_free(ed);
    if (ed->delete_me) _e_fm_ipc_dir_del(ed);
 }
 
+static void
+_e_fm_ipc_cb_cache_write(void *data, Ecore_Thread *thread EINA_UNUSED)
+{
+   E_Fm_Cache_Job *job = data;
+
+   e_fm_dircache_write(job->dir, &(job->st), job->entries, job->count);
+}
+
+static void
+_e_fm_ipc_cb_cache_write_end(void *data, Ecore_Thread *thread EINA_UNUSED)
+{
+   E_Fm_Cache_Job *job = data;
+
+   eina_stringshare_del(job->dir);
+   eina_binbuf_free(job->entries);
+   free(job);
+}
+
+/* e_fm2 sends the mime types it worked out for a listing as
+ *
+ * (name[n]\0 + mime[n]\0)*
+ *
+ * they are filled into the entries of the last listing that have none
+ * and the cache is written again off the main loop */
+static void
+_e_fm_ipc_mime_cache(E_Dir *ed, const unsigned char *data, size_t size)
+{
+   E_Fm_Dircache_Entry ent;
+   E_Fm_Cache_Job *job;
+   Eina_Binbuf *cache;
+   Eina_Hash *mimes;
+   const unsigned char *p, *end;
+   const char *name, *mime;
+   size_t len, pos = 0, csize;
+   Eina_Bool changed = EINA_FALSE;
+
+   if ((!ed->cache) || (!size) || (data[size - 1])) return;
+   mimes = eina_hash_string_superfast_new(NULL);
+   if (!mimes) return;
+   p = data;
+   end = data + size;
+   while (p < end)
+     {
+        name = (const char *)p;
+        p += strlen(name) + 1;
+        if (p >= end) break;
+        mime = (const char *)p;
+        p += strlen(mime) + 1;
+        if ((name[0]) && (mime[0])) eina_hash_set(mimes, name, mime);
+     }
+
+   cache = eina_binbuf_new();
+   if (!cache)
+     {
+        eina_hash_free(mimes);
+        return;
+     }
+   p = eina_binbuf_string_get(ed->cache);
+   csize = eina_binbuf_length_get(ed->cache);
+   while ((len = e_fm_dircache_entry_parse(p + pos, csize - pos, &ent)))
+     {
+        pos += len;
+        mime = NULL;
+        if ((!ent.mime[0]) && (!ent.broken_link))
+          mime = eina_hash_find(mimes, ent.name);
+        if (!mime)
+          {
+             eina_binbuf_append_length(cache, ent.data, ent.size);
+             continue;
+          }
+        /* an empty mime is the last byte of the entry */
+        eina_binbuf_append_length(cache, ent.data, ent.size - 1);
+        eina_binbuf_append_length(cache, (void *)mime, strlen(mime) + 1);
+        changed = EINA_TRUE;
+     }
+   eina_hash_free(mimes);
+   if (!changed)
+     {
+        eina_binbuf_free(cache);
+        return;
+     }
+   eina_binbuf_free(ed->cache);
+   ed->cache = cache;
+
+   job = malloc(sizeof(E_Fm_Cache_Job));
+   if (!job) return;
+   job->entries = eina_binbuf_new();
+   if (!job->entries)
+     {
+        free(job);
+        return;
+     }
+   eina_binbuf_append_length(job->entries, eina_binbuf_string_get(cache),
+                             eina_binbuf_length_get(cache));
+   job->dir = eina_stringshare_ref(ed->dir);
+   job->st = ed->lister_st;
+   job->count = ed->cache_count;
+   ecore_thread_run(_e_fm_ipc_cb_cache_write,
+                    _e_fm_ipc_cb_cache_write_end,
+                    _e_fm_ipc_cb_cache_write_end, job);
+}
+
 static void
 _e_fm_ipc_monitor_start_try(E_Fm_Task *task)
 {
    E_Dir *ed, *ped = NULL;
-   Eina_Iterator *it;
-
    Eina_List *l;
+   int fd;
 
    /* look for any previous dir entries monitoring this dir */
    EINA_LIST_FOREACH(_e_dirs, l, ed)
@@ -327,8 +721,8 @@ _e_fm_ipc_monitor_start_try(E_Fm_Task *task)
      }
 
    /* open the dir to list */
-   it = eina_file_direct_ls(task->src);
-   if (!it)
+   fd = open(task->src, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+   if (fd < 0)
      {
         char buf[PATH_MAX + 4096];
 
@@ -341,7 +735,9 @@ _e_fm_ipc_monitor_start_try(E_Fm_Task *task)
         ed = calloc(1, sizeof(E_Dir));
         ed->id = task->id;
         ed->dir = eina_stringshare_add(task->src);
-        ed->lister_iterator = it;
+        ed->lister_fd = fd;
+        if (fstat(fd, &(ed->lister_st)) == -1)
+          memset(&(ed->lister_st), 0, sizeof(struct stat));
         if (!ped)
           {
              /* if no previous monitoring dir exists - this one
@@ -702,6 +1098,29 @@ _e_fm_ipc_cb_server_data(void *data EINA_UNUSED, int type EINA_UNUSED, void *eve
       }
       break;
 
+      case E_FM_OP_MIME_CACHE: /* mime types of a listing for its cache */
+      {
+         Eina_List *l;
+         E_Dir *ed;
+
+         if ((!e->data) || (e->size <= 0)) break;
+         EINA_LIST_FOREACH(_e_dirs, l, ed)
+           {
+              if (ed->id != e->ref) continue;
+              /* the lister may still be checking the cached entries */
+              if (ed->lister_thread)
+                {
+                   if (!ed->cache_mimes) ed->cache_mimes = eina_binbuf_new();
+                   if (ed->cache_mimes)
+                     eina_binbuf_append_length(ed->cache_mimes, e->data, e->size);
+                }
+              else
+                _e_fm_ipc_mime_cache(ed, e->data, e->size);
+              break;
+           }
+      }
+      break;
+
       case E_FM_OP_REORDER:
       {
          const char *file, *dst, *relative;
@@ -1315,6 +1734,8 @@ _e_fm_ipc_dir_del(E_Dir *ed)
         free(m);
      }
    EINA_LIST_FREE(ed->fq, data) eina_stringshare_del(data);
+   if (ed->cache) eina_binbuf_free(ed->cache);
+   if (ed->cache_mimes) eina_binbuf_free(ed->cache_mimes);
    free(ed);
 }
 
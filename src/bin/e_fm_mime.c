@@ -8,13 +8,73 @@ struct _E_Fm2_Mime_Handler_Tuple
    const char *str;
 };
 
+/* glob handlers compiled for matching: literal globs are looked up
+ * whole, "*literal" globs by the suffix of the string being matched and
+ * only the rest is run through fnmatch() one by one */
+typedef struct _E_Fm2_Mime_Glob_Index E_Fm2_Mime_Glob_Index;
+struct _E_Fm2_Mime_Glob_Index
+{
+   Eina_Hash          *exact;
+   Eina_Hash          *suffix;
+   unsigned long long  suffix_lens; /* bit n set if a suffix n long exists */
+   Eina_List          *other;
+};
+
 /* local subsystem functions */
-static Eina_Bool _e_fm2_mime_handler_glob_match_foreach(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data, void *fdata);
+static void      _e_fm2_mime_handler_glob_append(E_Fm2_Mime_Handler_Tuple *tuple, const char *glob_);
+static E_Fm2_Mime_Glob_Index *_e_fm2_mime_glob_index_get(void);
 static Eina_Bool _e_fm_mime_icon_foreach(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED, void *data, void *fdata);
+static void      _e_fm2_mime_glob_index_free(void);
+static void      _e_fm_mime_icon_map_flush(void);
 
 static Eina_Hash *icon_map = NULL;
 static Eina_Hash *_mime_handlers = NULL;
 static Eina_Hash *_glob_handlers = NULL;
+static E_Fm2_Mime_Glob_Index *_glob_index = NULL;
+/* e_config->mime_icons by mime type, rebuilt when the list changes */
+static Eina_Hash *_mime_icon_index = NULL;
+static const Eina_List *_mime_icon_index_list = NULL;
+static unsigned int _mime_icon_index_count = 0;
+
+static Eina_Bool
+_e_fm_mime_glob_literal(const char *str)
+{
+   return !strpbrk(str, "*?[\\");
+}
+
+static void
+_e_fm_mime_icon_index_free(void)
+{
+   if (_mime_icon_index) eina_hash_free(_mime_icon_index);
+   _mime_icon_index = NULL;
+   _mime_icon_index_list = NULL;
+   _mime_icon_index_count = 0;
+}
+
+static Eina_Hash *
+_e_fm_mime_icon_index_get(void)
+{
+   const Eina_List *l;
+   E_Config_Mime_Icon *mi;
+
+   if ((_mime_icon_index) &&
+       (_mime_icon_index_list == e_config->mime_icons) &&
+       (_mime_icon_index_count == eina_list_count(e_config->mime_icons)))
+     return _mime_icon_index;
+   _e_fm_mime_icon_index_free();
+   _mime_icon_index = eina_hash_string_superfast_new(EINA_FREE_CB(eina_stringshare_del));
+   if (!_mime_icon_index) return NULL;
+   EINA_LIST_FOREACH(e_config->mime_icons, l, mi)
+     {
+        if ((!mi->mime) || (!mi->icon)) continue;
+        /* the first entry for a mime type wins, as in the list */
+        if (eina_hash_find(_mime_icon_index, mi->mime)) continue;
+        eina_hash_add(_mime_icon_index, mi->mime, eina_stringshare_add(mi->icon));
+     }
+   _mime_icon_index_list = e_config->mime_icons;
+   _mime_icon_index_count = eina_list_count(e_config->mime_icons);
+   return _mime_icon_index;
+}
 
 /* externally accessible functions */
 E_API const char *
@@ -36,10 +96,11 @@ e_fm_mime_icon_get(const char *mime)
    char buf[4096], buf2[4096], *val;
    Eina_List *l = NULL;
    E_Config_Mime_Icon *mi;
+   Eina_Hash *index;
    size_t len;
 
    /* 0.0 clean out hash cache once it has more than 512 entries in it */
-   if (eina_hash_population(icon_map) > 512) e_fm_mime_icon_cache_flush();
+   if (eina_hash_population(icon_map) > 512) _e_fm_mime_icon_map_flush();
 
    /* 0. look in mapping cache */
    val = eina_hash_find(icon_map, mime);
@@ -49,15 +110,32 @@ e_fm_mime_icon_get(const char *mime)
    val = strchr(buf2, '/');
    if (val) *val = 0;
 
-   /* 1. look up in mapping to file or thumb (thumb has flag)*/
-   EINA_LIST_FOREACH(e_config->mime_icons, l, mi)
+   /* 1. look up in mapping to file or thumb (thumb has flag).
+    * the mime type is the pattern here, so unless it has glob characters
+    * only an entry for exactly this mime type matches */
+   index = NULL;
+   if ((mime[0]) && (_e_fm_mime_glob_literal(mime)))
+     index = _e_fm_mime_icon_index_get();
+   if (index)
      {
-        if (e_util_glob_match(mi->mime, mime))
+        val = eina_hash_find(index, mime);
+        if (val)
           {
-             eina_strlcpy(buf, mi->icon, sizeof(buf));
+             eina_strlcpy(buf, val, sizeof(buf));
              goto ok;
           }
      }
+   else
+     {
+        EINA_LIST_FOREACH(e_config->mime_icons, l, mi)
+          {
+             if (e_util_glob_match(mi->mime, mime))
+               {
+                  eina_strlcpy(buf, mi->icon, sizeof(buf));
+                  goto ok;
+               }
+          }
+     }
 
    /* 2. look up in ~/.e/e/icons */
    len = e_user_dir_snprintf(buf, sizeof(buf), "icons/%s.edj", mime);
@@ -125,8 +203,8 @@ ok:
    return val;
 }
 
-E_API void
-e_fm_mime_icon_cache_flush(void)
+static void
+_e_fm_mime_icon_map_flush(void)
 {
    Eina_List *freelist = NULL;
 
@@ -136,6 +214,14 @@ e_fm_mime_icon_cache_flush(void)
    icon_map = NULL;
 }
 
+/* called when e_config->mime_icons changed */
+E_API void
+e_fm_mime_icon_cache_flush(void)
+{
+   _e_fm_mime_icon_map_flush();
+   _e_fm_mime_icon_index_free();
+}
+
 /* create (allocate), set properties, and return a new mime handler */
 E_API E_Fm2_Mime_Handler *
 e_fm2_mime_handler_new(const char *label, const char *icon_group, void (*action_func)(void *data, Evas_Object *obj, const char *path), void *action_data, int(test_func) (void *data, Evas_Object * obj, const char *path), void *test_data)
@@ -212,6 +298,7 @@ e_fm2_mime_handler_glob_add(E_Fm2_Mime_Handler *handler, const char *glob_)
         handlers = eina_list_append(handlers, handler);
         if (!_glob_handlers) _glob_handlers = eina_hash_string_superfast_new(NULL);
         eina_hash_add(_glob_handlers, glob_, handlers);
+        _e_fm2_mime_glob_index_free();
      }
 
    return 1;
@@ -260,6 +347,7 @@ e_fm2_mime_handler_glob_del(E_Fm2_Mime_Handler *handler, const char *glob_)
         else
           {
              eina_hash_del(_glob_handlers, glob_, handlers);
+             _e_fm2_mime_glob_index_free();
              if (!eina_hash_population(_glob_handlers))
                {
                   eina_hash_free(_glob_handlers);
@@ -281,18 +369,33 @@ e_fm2_mime_handler_mime_handlers_get(const char *mime)
 E_API Eina_List *
 e_fm2_mime_handler_glob_handlers_get(const char *glob_)
 {
-   E_Fm2_Mime_Handler_Tuple *tuple = NULL;
-   Eina_List *handlers = NULL;
+   E_Fm2_Mime_Handler_Tuple tuple;
+   E_Fm2_Mime_Glob_Index *gi;
+   Eina_List *l;
+   const char *key;
+   size_t len, n;
 
    if ((!glob_) || (!_glob_handlers)) return NULL;
 
-   tuple = E_NEW(E_Fm2_Mime_Handler_Tuple, 1);
-   tuple->list = NULL;
-   tuple->str = glob_;
-   eina_hash_foreach(_glob_handlers, _e_fm2_mime_handler_glob_match_foreach, tuple);
-   handlers = tuple->list;
-   E_FREE(tuple);
-   return handlers;
+   gi = _e_fm2_mime_glob_index_get();
+   if (!gi) return NULL;
+   tuple.list = NULL;
+   tuple.str = glob_;
+   key = eina_hash_find(gi->exact, glob_);
+   if (key) _e_fm2_mime_handler_glob_append(&tuple, key);
+   len = strlen(glob_);
+   for (n = 1; (n <= len) && (n < 64); n++)
+     {
+        if (!(gi->suffix_lens & (1ULL << n))) continue;
+        key = eina_hash_find(gi->suffix, glob_ + len - n);
+        if (key) _e_fm2_mime_handler_glob_append(&tuple, key);
+     }
+   EINA_LIST_FOREACH(gi->other, l, key)
+     {
+        if (e_util_glob_match(glob_, key))
+          _e_fm2_mime_handler_glob_append(&tuple, key);
+     }
+   return tuple.list;
 }
 
 /* call a certain handler */
@@ -369,29 +472,67 @@ e_fm2_mime_handler_test(E_Fm2_Mime_Handler *handler, Evas_Object *obj, const cha
 }
 
 /* local subsystem functions */
-/* used to loop a glob hash and determine if the glob handler matches the filename */
-static Eina_Bool
-_e_fm2_mime_handler_glob_match_foreach(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data, void *fdata)
+static void
+_e_fm2_mime_handler_glob_append(E_Fm2_Mime_Handler_Tuple *tuple, const char *glob_)
 {
-   E_Fm2_Mime_Handler_Tuple *tuple;
-   Eina_List *handlers = NULL;
-   Eina_List *l = NULL;
-   void *handler = NULL;
+   Eina_List *handlers, *l;
+   void *handler;
 
-   tuple = fdata;
-   if (e_util_glob_match(tuple->str, key))
+   handlers = eina_hash_find(_glob_handlers, glob_);
+   EINA_LIST_FOREACH(handlers, l, handler)
      {
-        handlers = data;
-        EINA_LIST_FOREACH(handlers, l, handler)
-          {
-             if (handler)
-               tuple->list = eina_list_append(tuple->list, handler);
-          }
+        if (handler)
+          tuple->list = eina_list_append(tuple->list, handler);
      }
+}
+
+/* used to loop the glob hash and sort each glob into the index */
+static Eina_Bool
+_e_fm2_mime_handler_glob_index_foreach(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data EINA_UNUSED, void *fdata)
+{
+   E_Fm2_Mime_Glob_Index *gi = fdata;
+   const char *glob_ = key;
+   size_t len;
 
+   len = strlen(glob_);
+   if ((len > 0) && (_e_fm_mime_glob_literal(glob_)))
+     eina_hash_add(gi->exact, glob_, eina_stringshare_add(glob_));
+   else if ((len > 1) && (len <= 64) && (glob_[0] == '*') &&
+            (_e_fm_mime_glob_literal(glob_ + 1)))
+     {
+        eina_hash_add(gi->suffix, glob_ + 1, eina_stringshare_add(glob_));
+        gi->suffix_lens |= 1ULL << (len - 1);
+     }
+   else
+     gi->other = eina_list_append(gi->other, eina_stringshare_add(glob_));
    return 1;
 }
 
+static E_Fm2_Mime_Glob_Index *
+_e_fm2_mime_glob_index_get(void)
+{
+   E_Fm2_Mime_Glob_Index *gi;
+
+   if (_glob_index) return _glob_index;
+   gi = E_NEW(E_Fm2_Mime_Glob_Index, 1);
+   if (!gi) return NULL;
+   gi->exact = eina_hash_string_superfast_new(EINA_FREE_CB(eina_stringshare_del));
+   gi->suffix = eina_hash_string_superfast_new(EINA_FREE_CB(eina_stringshare_del));
+   _glob_index = gi;
+   eina_hash_foreach(_glob_handlers, _e_fm2_mime_handler_glob_index_foreach, gi);
+   return gi;
+}
+
+static void
+_e_fm2_mime_glob_index_free(void)
+{
+   if (!_glob_index) return;
+   eina_hash_free(_glob_index->exact);
+   eina_hash_free(_glob_index->suffix);
+   E_FREE_LIST(_glob_index->other, eina_stringshare_del);
+   E_FREE(_glob_index);
+}
+
 static Eina_Bool
 _e_fm_mime_icon_foreach(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED, void *data, void *fdata)
 {
@@ -402,3 +543,86 @@ _e_fm_mime_icon_foreach(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_
    return 1;
 }
 
+
+#ifdef FM_MIME_BENCH
+/* build with -DFM_MIME_BENCH to have e_test() time glob handler lookups
+ * through the index against matching every glob like before */
+static Eina_Bool
+_e_fm_mime_bench_match_foreach(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data EINA_UNUSED, void *fdata)
+{
+   E_Fm2_Mime_Handler_Tuple *tuple = fdata;
+
+   if (e_util_glob_match(tuple->str, key))
+     _e_fm2_mime_handler_glob_append(tuple, key);
+   return 1;
+}
+
+static void
+_e_fm_mime_bench_action(void *data EINA_UNUSED, Evas_Object *obj EINA_UNUSED, const char *path EINA_UNUSED)
+{
+}
+
+E_API void
+e_fm_mime_bench(void)
+{
+   E_Fm2_Mime_Handler *handler;
+   E_Fm2_Mime_Handler_Tuple tuple;
+   Eina_List *globs = NULL;
+   char buf[64], **names;
+   const char *g;
+   double t0, t_index, t_all;
+   unsigned int i, found_index = 0, found_all = 0;
+   const unsigned int nglobs = 200, nnames = 5000, rounds = 20;
+
+   handler = e_fm2_mime_handler_new("bench", NULL, _e_fm_mime_bench_action,
+                                    NULL, NULL, NULL);
+   for (i = 0; i < nglobs; i++)
+     {
+        if (i % 10 == 0) snprintf(buf, sizeof(buf), "file%u*", i);
+        else if (i % 10 == 1) snprintf(buf, sizeof(buf), "Makefile%u", i);
+        else snprintf(buf, sizeof(buf), "*.ext%u", i);
+        g = eina_stringshare_add(buf);
+        e_fm2_mime_handler_glob_add(handler, g);
+        globs = eina_list_append(globs, g);
+     }
+   names = malloc(nnames * sizeof(char *));
+   for (i = 0; i < nnames; i++)
+     {
+        snprintf(buf, sizeof(buf), "file%u.ext%u", i, (i * 7) % (nglobs * 2));
+        names[i] = strdup(buf);
+     }
+
+   t0 = ecore_time_get();
+   for (i = 0; i < nnames * rounds; i++)
+     {
+        tuple.list = e_fm2_mime_handler_glob_handlers_get(names[i % nnames]);
+        found_index += eina_list_count(tuple.list);
+        eina_list_free(tuple.list);
+     }
+   t_index = ecore_time_get() - t0;
+
+   t0 = ecore_time_get();
+   for (i = 0; i < nnames * rounds; i++)
+     {
+        tuple.list = NULL;
+        tuple.str = names[i % nnames];
+        eina_hash_foreach(_glob_handlers, _e_fm_mime_bench_match_foreach, &tuple);
+        found_all += eina_list_count(tuple.list);
+        eina_list_free(tuple.list);
+     }
+   t_all = ecore_time_get() - t0;
+
+   printf("FM MIME BENCH: %u globs, %u lookups: index %1.4fs, all globs %1.4fs, "
+          "matches %u/%u\n", nglobs, nnames * rounds, t_index, t_all,
+          found_index, found_all);
+
+   EINA_LIST_FREE(globs, g)
+     {
+        e_fm2_mime_handler_glob_del(handler, g);
+        eina_stringshare_del(g);
+     }
+   for (i = 0; i < nnames; i++) free(names[i]);
+   free(names);
+   e_fm2_mime_handler_free(handler);
+}
+#endif
@@ -31,6 +31,9 @@ E_API void e_fm2_mime_handler_mime_del(E_Fm2_Mime_Handler *handler, const char *
 E_API void e_fm2_mime_handler_glob_del(E_Fm2_Mime_Handler *handler, const char *glob);
 E_API const Eina_List *e_fm2_mime_handler_mime_handlers_get(const char *mime);
 E_API Eina_List *e_fm2_mime_handler_glob_handlers_get(const char *glob);
+#ifdef FM_MIME_BENCH
+E_API void e_fm_mime_bench(void);
+#endif
 
 #endif
 #endif
@@ -29,10 +29,18 @@ void *alloca(size_t);
 #include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/sysmacros.h>
 #include <utime.h>
 #include <errno.h>
 #include <limits.h>
 #include <fcntl.h>
+#ifdef HAVE_SYS_SENDFILE_H
+# include <sys/sendfile.h>
+#endif
+#ifdef HAVE_FICLONE
+# include <sys/ioctl.h>
+# include <linux/fs.h>
+#endif
 
 #include <Ecore.h>
 #include <Ecore_File.h>
@@ -45,10 +53,22 @@ void *alloca(size_t);
 #include "e_fm_op.h"
 
 #define READBUFSIZE     65536
-#define COPYBUFSIZE     16384
 #define REMOVECHUNKSIZE 4096
 #define NB_PASS         3
 
+/* regular files are copied in chunks sized so that one work idler call
+ * takes about COPYCHUNKTIME, keeping abort and progress responsive */
+#define COPYCHUNKMIN    (64 * 1024)
+#define COPYCHUNKMAX    (64 * 1024 * 1024)
+#define COPYCHUNKTIME   0.02
+#define COPYBUFSIZE     (1024 * 1024) // read/write fallback buffer
+#define COPYBUFALIGN    4096
+
+/* regular files may be copied by worker threads, at most COPYTHREADSMAX
+ * at once and one at a time to or from a rotational disk */
+#define COPYTHREADSMAX  8
+#define COPYTHREADCHUNK (8 * 1024 * 1024)
+
 #define E_FREE(p) do { free(p); p = NULL; } while (0)
 
 #define _E_FM_OP_ERROR_SEND_SCAN(_task, _e_fm_op_error_type, _fmt, ...)                      \
@@ -73,6 +93,17 @@ void *alloca(size_t);
 
 typedef struct _E_Fm_Op_Task      E_Fm_Op_Task;
 typedef struct _E_Fm_Op_Copy_Data E_Fm_Op_Copy_Data;
+typedef struct _E_Fm_Op_Device    E_Fm_Op_Device;
+
+/* ways of copying file data, tried in this order; a copy falls back to the
+ * next one when the kernel or filesystem doesn't support the current one */
+typedef enum _E_Fm_Op_Copy_Method
+{
+   E_FM_OP_COPY_METHOD_CLONE, // FICLONE: share extents on CoW filesystems
+   E_FM_OP_COPY_METHOD_RANGE, // copy_file_range(): in kernel, may offload
+   E_FM_OP_COPY_METHOD_SENDFILE, // sendfile(): in kernel
+   E_FM_OP_COPY_METHOD_RW // pread()/pwrite() through an aligned buffer
+} E_Fm_Op_Copy_Method;
 
 static E_Fm_Op_Task *_e_fm_op_task_new(void);
 static void          _e_fm_op_task_free(void *t);
@@ -97,7 +128,10 @@ static int           _e_fm_op_copy_dir(E_Fm_Op_Task *task);
 static int           _e_fm_op_copy_link(E_Fm_Op_Task *task);
 static int           _e_fm_op_copy_fifo(E_Fm_Op_Task *task);
 static int           _e_fm_op_open_files(E_Fm_Op_Task *task);
+static void          _e_fm_op_close_files(E_Fm_Op_Copy_Data *data);
 static int           _e_fm_op_copy_chunk(E_Fm_Op_Task *task);
+static int           _e_fm_op_copy_schedule(E_Fm_Op_Task *task);
+static void          _e_fm_op_copy_threads_cancel(void);
 
 static int           _e_fm_op_copy_atom(E_Fm_Op_Task *task);
 static int           _e_fm_op_scan_atom(E_Fm_Op_Task *task);
@@ -124,6 +158,9 @@ int _e_fm_op_overwrite_response = E_FM_OP_NONE;
 
 Eina_List *_e_fm_op_separator = NULL;
 
+Eina_List *_e_fm_op_devices = NULL;
+int _e_fm_op_copy_threads = 0; /* Copies running in worker threads. */
+
 char *_e_fm_op_stdin_buffer = NULL;
 
 struct _E_Fm_Op_Task
@@ -151,12 +188,27 @@ struct _E_Fm_Op_Task
    E_Fm_Op_Type  overwrite;
 
    Eina_List    *link;
+
+   Ecore_Thread   *thread; /* Copying in a worker thread. */
+   E_Fm_Op_Device *dev[2]; /* Source and destination device of the thread. */
+   int             thread_error;
+   int             no_thread; /* Copy on the main loop, e.g. after an error. */
 };
 
 struct _E_Fm_Op_Copy_Data
 {
-   FILE *from;
-   FILE *to;
+   int                 from, to; // -1 when not open
+   E_Fm_Op_Copy_Method method;
+   off_t               pos; // bytes copied so far
+   size_t              chunk; // bytes to copy in the next step
+   char               *buf; // for E_FM_OP_COPY_METHOD_RW
+};
+
+struct _E_Fm_Op_Device
+{
+   dev_t dev;
+   int   max; /* Copies allowed at once. */
+   int   busy;
 };
 
 int
@@ -425,6 +477,11 @@ skip_arg:
    ecore_main_loop_begin();
 
 quit:
+   while (_e_fm_op_devices)
+     {
+        free(eina_list_data_get(_e_fm_op_devices));
+        _e_fm_op_devices = eina_list_remove_list(_e_fm_op_devices, _e_fm_op_devices);
+     }
    ecore_shutdown();
 
    E_FREE(_e_fm_op_stdin_buffer);
@@ -453,6 +510,10 @@ _e_fm_op_task_new()
    t->overwrite = E_FM_OP_NONE;
    t->link = NULL;
    t->pos = t->passes = 0;
+   t->thread = NULL;
+   t->dev[0] = t->dev[1] = NULL;
+   t->thread_error = 0;
+   t->no_thread = 0;
 
    return t;
 }
@@ -473,10 +534,7 @@ _e_fm_op_task_free(void *t)
      {
         data = task->data;
         if (task->type == E_FM_OP_COPY)
-          {
-             if (data->from) fclose(data->from);
-             if (data->to) fclose(data->to);
-          }
+          _e_fm_op_close_files(data);
         E_FREE(task->data);
      }
    E_FREE(task);
@@ -740,9 +798,28 @@ _e_fm_op_work_idler(void *data EINA_UNUSED)
     */
    static Eina_List *node = NULL;
    E_Fm_Op_Task *task = NULL;
+   int r;
+
+   if ((_e_fm_op_abort) && (_e_fm_op_copy_threads))
+     {
+        /* Wait for running copies to be cancelled before quitting. */
+        _e_fm_op_copy_threads_cancel();
+        _e_fm_op_delete_idler(&_e_fm_op_work_error);
+        return ECORE_CALLBACK_RENEW;
+     }
 
    if (!node) node = _e_fm_op_work_queue;
+   /* Skip copies running in worker threads. */
+   while ((node) && (task = eina_list_data_get(node)) && (task->thread))
+     node = eina_list_next(node);
    task = eina_list_data_get(node);
+   if ((!task) && (_e_fm_op_copy_threads))
+     {
+        /* The separator and quitting wait for them. */
+        node = NULL;
+        _e_fm_op_delete_idler(&_e_fm_op_work_error);
+        return ECORE_CALLBACK_RENEW;
+     }
    if (!task)
      {
         node = _e_fm_op_work_queue;
@@ -779,20 +856,31 @@ _e_fm_op_work_idler(void *data EINA_UNUSED)
    if (_e_fm_op_idler_handle_error(&_e_fm_op_work_error, &_e_fm_op_work_queue, &node, task))
      return ECORE_CALLBACK_RENEW;
 
-   task->started = 1;
+   r = _e_fm_op_copy_schedule(task);
+   if (r == 2)
+     {
+        node = NULL;
+        return ECORE_CALLBACK_RENEW;
+     }
 
-   if (task->type == E_FM_OP_COPY)
-     _e_fm_op_copy_atom(task);
-   else if (task->type == E_FM_OP_REMOVE)
-     _e_fm_op_remove_atom(task);
-   else if (task->type == E_FM_OP_DESTROY)
-     _e_fm_op_destroy_atom(task);
-   else if (task->type == E_FM_OP_COPY_STAT_INFO)
-     _e_fm_op_copy_stat_info_atom(task);
-   else if (task->type == E_FM_OP_SYMLINK)
-     _e_fm_op_symlink_atom(task);
-   else if (task->type == E_FM_OP_RENAME)
-     _e_fm_op_rename_atom(task);
+   /* r == 1: waiting for threads or for an overwrite response. */
+   if (r == 0)
+     {
+        task->started = 1;
+
+        if (task->type == E_FM_OP_COPY)
+          _e_fm_op_copy_atom(task);
+        else if (task->type == E_FM_OP_REMOVE)
+          _e_fm_op_remove_atom(task);
+        else if (task->type == E_FM_OP_DESTROY)
+          _e_fm_op_destroy_atom(task);
+        else if (task->type == E_FM_OP_COPY_STAT_INFO)
+          _e_fm_op_copy_stat_info_atom(task);
+        else if (task->type == E_FM_OP_SYMLINK)
+          _e_fm_op_symlink_atom(task);
+        else if (task->type == E_FM_OP_RENAME)
+          _e_fm_op_rename_atom(task);
+     }
 
    if (task->finished)
      {
@@ -1012,6 +1100,8 @@ _e_fm_op_rollback(E_Fm_Op_Task *task)
      {
         if (t == task) continue;
         if (t->parent != task) continue;
+        /* A running copy is left to finish. */
+        if (t->thread) continue;
         _e_fm_op_work_queue = eina_list_remove_list(_e_fm_op_work_queue, l);
         _e_fm_op_task_free(t);
      }
@@ -1019,19 +1109,7 @@ _e_fm_op_rollback(E_Fm_Op_Task *task)
    if (task->type == E_FM_OP_COPY)
      {
         data = task->data;
-        if (data)
-          {
-             if (data->from)
-               {
-                  fclose(data->from);
-                  data->from = NULL;
-               }
-             if (data->to)
-               {
-                  fclose(data->to);
-                  data->to = NULL;
-               }
-          }
+        if (data) _e_fm_op_close_files(data);
         E_FREE(task->data);
         _e_fm_op_update_progress(task, -task->dst.done,
                                  -task->src.st.st_size - (task->link ? REMOVECHUNKSIZE : 0));
@@ -1361,36 +1439,150 @@ _e_fm_op_open_files(E_Fm_Op_Task *task)
    /* Ordinary file. */
    if (!data)
      {
-        data = malloc(sizeof(E_Fm_Op_Copy_Data));
+        data = calloc(1, sizeof(E_Fm_Op_Copy_Data));
         task->data = data;
-        data->to = NULL;
-        data->from = NULL;
+        data->to = -1;
+        data->from = -1;
+        data->chunk = COPYCHUNKMIN;
      }
 
-   if (!data->from)
+   if (data->from < 0)
      {
-        data->from = fopen(task->src.name, "rb");
-        if (!data->from)
+        data->from = open(task->src.name, O_RDONLY | O_CLOEXEC);
+        if (data->from < 0)
           _E_FM_OP_ERROR_SEND_WORK(task, E_FM_OP_ERROR, "Cannot open file '%s' for reading: %s.", task->src.name);
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(data->from, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
      }
 
-   if (!data->to)
+   if (data->to < 0)
      {
-        data->to = fopen(task->dst.name, "wb");
-        if (!data->to)
+        data->to = open(task->dst.name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        if (data->to < 0)
           _E_FM_OP_ERROR_SEND_WORK(task, E_FM_OP_ERROR, "Cannot open file '%s' for writing: %s.", task->dst.name);
         _e_fm_op_copy_stat_info(task);
+        data->method = E_FM_OP_COPY_METHOD_CLONE;
+        data->pos = 0;
      }
 
    return 0;
 }
 
+static void
+_e_fm_op_close_files(E_Fm_Op_Copy_Data *data)
+{
+   if (data->from >= 0) close(data->from);
+   if (data->to >= 0) close(data->to);
+   data->from = data->to = -1;
+   free(data->buf);
+   data->buf = NULL;
+}
+
+/* errors meaning "not supported here" rather than a failed copy */
+static Eina_Bool
+_e_fm_op_copy_unsupported(int err)
+{
+   return (err == ENOSYS) || (err == EINVAL) || (err == EXDEV) ||
+          (err == EOPNOTSUPP) || (err == ENOTTY) || (err == EBADF);
+}
+
+/* Copies the next chunk of data->from to data->to with data->method.
+ * Returns the number of bytes copied, 0 at end of file, or -1 with errno
+ * set. Falls back to the next method where the current one is not
+ * supported, so -1 is a real error.
+ */
+static ssize_t
+_e_fm_op_copy_data(E_Fm_Op_Copy_Data *data, const struct stat *st)
+{
+   ssize_t done = -1;
+
+   switch (data->method)
+     {
+      case E_FM_OP_COPY_METHOD_CLONE:
+        data->method = E_FM_OP_COPY_METHOD_RANGE;
+#ifdef HAVE_FICLONE
+        /* only whole files can be cloned, i.e. before anything was copied */
+        if ((data->pos == 0) && (st->st_size > 0) &&
+            (ioctl(data->to, FICLONE, data->from) == 0))
+          {
+             struct stat st2;
+
+             if (fstat(data->from, &st2) < 0) return -1;
+             data->pos = st2.st_size;
+             return st2.st_size;
+          }
+#else
+        (void)st;
+#endif
+        EINA_FALLTHROUGH;
+      case E_FM_OP_COPY_METHOD_RANGE:
+#ifdef HAVE_COPY_FILE_RANGE
+        {
+           loff_t in = data->pos, out = data->pos;
+
+           done = copy_file_range(data->from, &in, data->to, &out, data->chunk, 0);
+           /* some kernels return 0 instead of an error across filesystems,
+            * so only trust 0 from a copy that has already made progress */
+           if ((done > 0) || ((done == 0) && (data->pos > 0))) break;
+           if ((done < 0) && (!_e_fm_op_copy_unsupported(errno))) break;
+        }
+#endif
+        data->method = E_FM_OP_COPY_METHOD_SENDFILE;
+        EINA_FALLTHROUGH;
+      case E_FM_OP_COPY_METHOD_SENDFILE:
+#ifdef HAVE_SYS_SENDFILE_H
+        {
+           off_t in = data->pos;
+
+           if (lseek(data->to, data->pos, SEEK_SET) < 0) return -1;
+           done = sendfile(data->to, data->from, &in, data->chunk);
+           if (done >= 0) break;
+           if (!_e_fm_op_copy_unsupported(errno)) break;
+        }
+#endif
+        data->method = E_FM_OP_COPY_METHOD_RW;
+        EINA_FALLTHROUGH;
+      case E_FM_OP_COPY_METHOD_RW:
+        {
+           size_t len = data->chunk;
+           ssize_t w, dw;
+
+           if ((!data->buf) &&
+               (posix_memalign((void **)&data->buf, COPYBUFALIGN, COPYBUFSIZE)))
+             {
+                data->buf = NULL;
+                errno = ENOMEM;
+                return -1;
+             }
+           if (len > COPYBUFSIZE) len = COPYBUFSIZE;
+           do
+             done = pread(data->from, data->buf, len, data->pos);
+           while ((done < 0) && (errno == EINTR));
+           if (done <= 0) break;
+           for (w = 0; w < done; w += dw)
+             {
+                dw = pwrite(data->to, data->buf + w, done - w, data->pos + w);
+                if ((dw < 0) && (errno == EINTR)) dw = 0;
+                else if (dw <= 0)
+                  {
+                     if (dw == 0) errno = ENOSPC;
+                     return -1;
+                  }
+             }
+        }
+        break;
+     }
+   if (done > 0) data->pos += done;
+   return done;
+}
+
 static int
 _e_fm_op_copy_chunk(E_Fm_Op_Task *task)
 {
    E_Fm_Op_Copy_Data *data;
-   size_t dread, dwrite;
-   char buf[COPYBUFSIZE];
+   ssize_t done;
+   double t;
 
    data = task->data;
 
@@ -1402,16 +1594,13 @@ _e_fm_op_copy_chunk(E_Fm_Op_Task *task)
         return 1;
      }
 
-   dread = fread(buf, 1, sizeof(buf), data->from);
-   if (dread == 0)
+   t = ecore_time_get();
+   done = _e_fm_op_copy_data(data, &task->src.st);
+   if (done < 0)
+     _E_FM_OP_ERROR_SEND_WORK(task, E_FM_OP_ERROR, "Cannot copy data from '%s': %s.", task->src.name);
+   if (done == 0)
      {
-        if (!feof(data->from))
-          _E_FM_OP_ERROR_SEND_WORK(task, E_FM_OP_ERROR, "Cannot read data from '%s': %s.", task->dst.name);
-
-        fclose(data->from);
-        fclose(data->to);
-        data->to = NULL;
-        data->from = NULL;
+        _e_fm_op_close_files(data);
 
         _e_fm_op_copy_stat_info(task);
 
@@ -1424,17 +1613,248 @@ _e_fm_op_copy_chunk(E_Fm_Op_Task *task)
         return 1;
      }
 
-   dwrite = fwrite(buf, 1, dread, data->to);
-
-   if (dwrite < dread)
-     _E_FM_OP_ERROR_SEND_WORK(task, E_FM_OP_ERROR, "Cannot write data to '%s': %s.", task->dst.name);
+   /* adapt the chunk size to the measured throughput */
+   t = ecore_time_get() - t;
+   if ((t < (COPYCHUNKTIME / 2)) && ((size_t)done >= data->chunk) &&
+       (data->chunk < COPYCHUNKMAX))
+     data->chunk *= 2;
+   else if ((t > (COPYCHUNKTIME * 2)) && (data->chunk > COPYCHUNKMIN))
+     data->chunk /= 2;
 
-   task->dst.done += dread;
-   _e_fm_op_update_progress(task, dwrite, 0);
+   task->dst.done += done;
+   _e_fm_op_update_progress(task, done, 0);
 
    return 0;
 }
 
+/* Copies allowed at once on a device: one for rotational disks, where
+ * parallel copies would only add seeks. Devices without a block queue
+ * (network and virtual filesystems) are treated as non-rotational.
+ */
+static E_Fm_Op_Device *
+_e_fm_op_device_get(dev_t dev)
+{
+   E_Fm_Op_Device *d;
+   Eina_List *l;
+   char buf[PATH_MAX];
+   FILE *f;
+   int rot = 0;
+
+   EINA_LIST_FOREACH(_e_fm_op_devices, l, d)
+     if (d->dev == dev) return d;
+
+   snprintf(buf, sizeof(buf), "/sys/dev/block/%u:%u/queue/rotational",
+            major(dev), minor(dev));
+   f = fopen(buf, "r");
+   if (!f)
+     {
+        /* A partition, the queue belongs to its disk. */
+        snprintf(buf, sizeof(buf), "/sys/dev/block/%u:%u/../queue/rotational",
+                 major(dev), minor(dev));
+        f = fopen(buf, "r");
+     }
+   if (f)
+     {
+        if (fscanf(f, "%i", &rot) != 1) rot = 0;
+        fclose(f);
+     }
+
+   d = calloc(1, sizeof(E_Fm_Op_Device));
+   if (!d) return NULL;
+   d->dev = dev;
+   d->max = rot ? 1 : COPYTHREADSMAX;
+   _e_fm_op_devices = eina_list_append(_e_fm_op_devices, d);
+   return d;
+}
+
+/* Only regular files whose destination directory already exists are
+ * copied in threads, everything else keeps its order in the queue.
+ */
+static Eina_Bool
+_e_fm_op_copy_threadable(E_Fm_Op_Task *task, E_Fm_Op_Device **sdev, E_Fm_Op_Device **ddev)
+{
+   char buf[PATH_MAX], *p;
+   struct stat st;
+
+   if ((task->type != E_FM_OP_COPY) || (task->data) || (task->no_thread) ||
+       (!task->dst.name) || (!S_ISREG(task->src.st.st_mode)))
+     return EINA_FALSE;
+
+   if (eina_strlcpy(buf, task->dst.name, sizeof(buf)) >= sizeof(buf))
+     return EINA_FALSE;
+   p = strrchr(buf, '/');
+   if ((!p) || (p == buf)) return EINA_FALSE;
+   *p = 0;
+   if (stat(buf, &st) < 0) return EINA_FALSE;
+
+   *sdev = _e_fm_op_device_get(task->src.st.st_dev);
+   *ddev = _e_fm_op_device_get(st.st_dev);
+   return (*sdev) && (*ddev);
+}
+
+static void
+_e_fm_op_copy_thread(void *data, Ecore_Thread *th)
+{
+   E_Fm_Op_Task *task = data;
+   E_Fm_Op_Copy_Data cdata;
+   ssize_t done = 0;
+   off_t *bytes;
+
+   memset(&cdata, 0, sizeof(cdata));
+   cdata.method = E_FM_OP_COPY_METHOD_CLONE;
+   cdata.chunk = COPYTHREADCHUNK;
+   cdata.from = open(task->src.name, O_RDONLY | O_CLOEXEC);
+   cdata.to = -1;
+   if (cdata.from >= 0)
+     cdata.to = open(task->dst.name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+   if ((cdata.from < 0) || (cdata.to < 0))
+     done = -1;
+   else
+     {
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(cdata.from, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        _e_fm_op_copy_stat_info(task);
+        while ((!ecore_thread_check(th)) &&
+               ((done = _e_fm_op_copy_data(&cdata, &task->src.st)) > 0))
+          {
+             bytes = malloc(sizeof(off_t));
+             if (!bytes) continue;
+             *bytes = done;
+             ecore_thread_feedback(th, bytes);
+          }
+     }
+   if (done < 0) task->thread_error = errno ? errno : EIO;
+   _e_fm_op_close_files(&cdata);
+   if ((done == 0) && (!ecore_thread_check(th)))
+     _e_fm_op_copy_stat_info(task);
+}
+
+static void
+_e_fm_op_copy_thread_notify(void *data, Ecore_Thread *th EINA_UNUSED, void *msg)
+{
+   E_Fm_Op_Task *task = data;
+   off_t *bytes = msg;
+
+   task->dst.done += *bytes;
+   _e_fm_op_update_progress(task, *bytes, 0);
+   free(bytes);
+}
+
+static void
+_e_fm_op_copy_thread_release(E_Fm_Op_Task *task)
+{
+   task->thread = NULL;
+   task->dev[0]->busy--;
+   if (task->dev[1] != task->dev[0]) task->dev[1]->busy--;
+   task->dev[0] = task->dev[1] = NULL;
+   _e_fm_op_copy_threads--;
+   /* The work idler may be waiting for a free slot. */
+   _e_fm_op_set_up_idlers();
+}
+
+static void
+_e_fm_op_copy_thread_end(void *data, Ecore_Thread *th EINA_UNUSED)
+{
+   E_Fm_Op_Task *task = data;
+
+   _e_fm_op_copy_thread_release(task);
+   if ((task->thread_error) && (!_e_fm_op_abort))
+     {
+        /* Copy it again on the main loop, which reports the error and
+         * handles the response as usual. The destination may be left
+         * partly written by the thread, overwriting it was settled before
+         * the thread started. */
+        _e_fm_op_update_progress(task, -task->dst.done, 0);
+        task->dst.done = 0;
+        task->thread_error = 0;
+        task->no_thread = 1;
+        task->overwrite = E_FM_OP_OVERWRITE_RESPONSE_YES;
+        return;
+     }
+   if (task->thread_error)
+     _e_fm_op_rollback(task);
+   else
+     _e_fm_op_update_progress(task, 0, 0);
+   _e_fm_op_work_queue = eina_list_remove(_e_fm_op_work_queue, task);
+   _e_fm_op_task_free(task);
+}
+
+static void
+_e_fm_op_copy_thread_cancel(void *data, Ecore_Thread *th EINA_UNUSED)
+{
+   E_Fm_Op_Task *task = data;
+
+   /* Called right away when the thread couldn't be started, the task is
+    * then copied on the main loop. */
+   if (!task->dev[0]) return;
+   _e_fm_op_copy_thread_release(task);
+   _e_fm_op_rollback(task);
+   _e_fm_op_work_queue = eina_list_remove(_e_fm_op_work_queue, task);
+   _e_fm_op_task_free(task);
+}
+
+static void
+_e_fm_op_copy_threads_cancel(void)
+{
+   Eina_List *l, *ll;
+   E_Fm_Op_Task *task;
+
+   EINA_LIST_FOREACH_SAFE(_e_fm_op_work_queue, l, ll, task)
+     {
+        if ((task) && (task->thread))
+          ecore_thread_cancel(task->thread);
+     }
+}
+
+/* Decides how the work idler handles the task:
+ * 0 - run it on the main loop now,
+ * 1 - leave it for now, it waits for threads or an overwrite response,
+ * 2 - it was handed to a worker thread.
+ * Anything that isn't copied in a thread is ordered after the copies
+ * already running.
+ */
+static int
+_e_fm_op_copy_schedule(E_Fm_Op_Task *task)
+{
+   E_Fm_Op_Device *sdev = NULL, *ddev = NULL;
+
+   if ((_e_fm_op_abort) ||
+       (!_e_fm_op_copy_threadable(task, &sdev, &ddev)))
+     {
+        if (!_e_fm_op_copy_threads) return 0;
+        _e_fm_op_delete_idler(&_e_fm_op_work_error);
+        return 1;
+     }
+   if ((_e_fm_op_copy_threads >= COPYTHREADSMAX) ||
+       (sdev->busy >= sdev->max) ||
+       ((ddev != sdev) && (ddev->busy >= ddev->max)))
+     {
+        _e_fm_op_delete_idler(&_e_fm_op_work_error);
+        return 1;
+     }
+   if (_e_fm_op_handle_overwrite(task)) return 1;
+
+   E_FM_OP_DEBUG("Copy (thread): %s --> %s\n", task->src.name, task->dst.name);
+   task->started = 1;
+   task->thread = ecore_thread_feedback_run(_e_fm_op_copy_thread,
+                                            _e_fm_op_copy_thread_notify,
+                                            _e_fm_op_copy_thread_end,
+                                            _e_fm_op_copy_thread_cancel,
+                                            task, EINA_FALSE);
+   if (!task->thread)
+     {
+        task->no_thread = 1;
+        return 0;
+     }
+   task->dev[0] = sdev;
+   task->dev[1] = ddev;
+   sdev->busy++;
+   if (ddev != sdev) ddev->busy++;
+   _e_fm_op_copy_threads++;
+   return 2;
+}
+
 /*
  * _e_fm_op_copy_atom(), _e_fm_op_remove_atom() and _e_fm_op_scan_atom() are functions that
  * perform very small operations.
@@ -1464,7 +1884,7 @@ _e_fm_op_copy_atom(E_Fm_Op_Task *task)
 
    data = task->data;
 
-   if ((!data) || (!data->to) || (!data->from)) /* Did not touch the files yet. */
+   if ((!data) || (data->to < 0) || (data->from < 0)) /* Did not touch the files yet. */
      {
         E_FM_OP_DEBUG("Copy: %s --> %s\n", task->src.name, task->dst.name);
 
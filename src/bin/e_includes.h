@@ -14,6 +14,7 @@
 #include "e_pixmap.h"
 #include "e_comp_object.h"
 #include "e_client.h"
+#include "e_client_index.h"
 #include "e_client_volume.h"
 #include "e_pointer.h"
 #include "e_config.h"
@@ -121,6 +122,7 @@
 #include "e_widget_font_preview.h"
 #include "e_fm_custom.h"
 #include "e_msgbus.h"
+#include "e_startup_trace.h"
 #include "e_toolbar.h"
 #include "e_int_toolbar_config.h"
 #include "e_powersave.h"
@@ -148,6 +150,7 @@
 #include "e_comp.h"
 #include "e_comp_cfdata.h"
 #include "e_comp_canvas.h"
+#include "e_comp_profiler.h"
 #include "e_utils.h"
 #include "e_hints.h"
 #include "e_comp_x_randr.h"
@@ -403,7 +403,7 @@ _check_matches(E_Remember *rem, int update)
 
         if (update)
           {
-             ec->changed = 1;
+             EC_CHANGED(ec);
              ec->changes.icon = 1;
           }
         else if (n > 1)
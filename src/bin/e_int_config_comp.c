@@ -39,6 +39,9 @@ struct _E_Config_Dialog_Data
    int          fps_corner;
    int          fps_average_range;
    double       first_draw_delay;
+   int          damage_coalesce;
+   int          damage_rect_cost;
+   int          damage_rects_max;
    int disable_screen_effects;
    int enable_advanced_features;
    // the following options add the "/fast" suffix to the normal groups
@@ -141,6 +144,10 @@ _create_data(E_Config_Dialog *cfd EINA_UNUSED)
      cfdata->fps_average_range = 120;
    cfdata->first_draw_delay = conf->first_draw_delay;
 
+   cfdata->damage_coalesce = conf->damage_coalesce;
+   cfdata->damage_rect_cost = conf->damage_rect_cost;
+   cfdata->damage_rects_max = conf->damage_rects_max;
+
    return cfdata;
 }
 
@@ -299,6 +306,21 @@ _advanced_create_widgets(E_Config_Dialog *cfd, Evas *evas, E_Config_Dialog_Data
           }
      }
    e_widget_list_object_append(ol, of, 1, 1, 0.5);
+
+   of = e_widget_framelist_add(evas, _("Damage"), 0);
+   ob = e_widget_check_add(evas, _("Coalesce window updates adaptively"), &(cfdata->damage_coalesce));
+   e_widget_framelist_object_append(of, ob);
+   ob = e_widget_label_add(evas, _("Cost of an extra update region"));
+   e_widget_framelist_object_append(of, ob);
+   ob = e_widget_slider_add(evas, 1, 0, _("%1.0f Pixels"), 256, 65536, 256, 0,
+                            NULL, &(cfdata->damage_rect_cost), 150);
+   e_widget_framelist_object_append(of, ob);
+   ob = e_widget_label_add(evas, _("Updates per frame before full redraw"));
+   e_widget_framelist_object_append(of, ob);
+   ob = e_widget_slider_add(evas, 1, 0, _("%1.0f Updates"), 16, 2048, 16, 0,
+                            NULL, &(cfdata->damage_rects_max), 150);
+   e_widget_framelist_object_append(of, ob);
+   e_widget_list_object_append(ol, of, 1, 1, 0.5);
    e_widget_toolbook_page_append(otb, NULL, _("Rendering"), ol, 0, 0, 0, 0, 0.5, 0.0);
 
    ///////////////////////////////////////////
@@ -474,6 +496,9 @@ _advanced_apply_data(E_Config_Dialog *cfd  EINA_UNUSED,
         conf->shadow_style = eina_stringshare_ref(cfdata->shadow_style);
         e_comp_shadows_reset();
      }
+   conf->damage_coalesce = cfdata->damage_coalesce;
+   conf->damage_rect_cost = cfdata->damage_rect_cost;
+   conf->damage_rects_max = cfdata->damage_rects_max;
    if ((cfdata->engine != conf->engine) ||
        (cfdata->indirect != conf->indirect) ||
        (cfdata->texture_from_pixmap != conf->texture_from_pixmap) ||
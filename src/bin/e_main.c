@@ -14,10 +14,11 @@
      t1 = ecore_time_unix_get();                                  \
      printf("ESTART: %1.5f [%1.5f] - %s\n", t1 - t0, t1 - t2, x); \
      t2 = t1;                                                     \
+     e_startup_trace_mark(x);                                     \
   }
 static double t0, t1, t2;
 #else
-# define TS(x)
+# define TS(x) e_startup_trace_mark(x)
 #endif
 
 /*
@@ -304,6 +305,7 @@ main(int argc, char **argv)
      t1 = ecore_time_unix_get();                                  \
      printf("ESTART: %1.5f [%1.5f] - %s\n", t1 - t0, t1 - t2, x); \
      t2 = t1;                                                     \
+     e_startup_trace_mark(x);                                     \
   }
 #endif
    TS("Eina Init Done");
@@ -1088,6 +1090,8 @@ main(int argc, char **argv)
      ecore_timer_add(2.0, _e_main_cb_startup_fake_end, NULL);
 
    TS("MAIN LOOP AT LAST");
+   e_startup_trace_loop_begin();
+   _e_main_shutdown_push(e_startup_trace_shutdown);
    if (!setjmp(x_fatal_buff))
      ecore_main_loop_begin();
    else
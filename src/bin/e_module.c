@@ -17,6 +17,9 @@ static int       _e_module_sort_name(const void *d1, const void *d2);
 static int       _e_module_sort_priority(const void *d1, const void *d2);
 static void      _e_module_whitelist_check(void);
 static Eina_Bool _e_module_desktop_list_cb(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data, void *fdata);
+static void      _e_module_preload_add(const char *name);
+static void      _e_module_preload_free(void *data);
+static void      _e_module_preload_threads_stop(void);
 
 /* local subsystem globals */
 static Eina_List *_e_modules = NULL;
@@ -36,6 +39,34 @@ E_API int E_EVENT_MODULE_INIT_END = 0;
 
 static Eina_Stringshare *mod_src_path = NULL;
 
+/* Modules about to be loaded are dlopen()ed by workers ahead of time, with
+ * their module.so and edj read into the page cache first, so disk io and
+ * relocation overlap with the e_modapi_init() of the modules before them.
+ * e_module_new() waits for a preload that has started, after which its
+ * own dlopen() only takes a reference on the handle the worker opened.
+ * One that has not started is called off so a busy thread pool can't
+ * stall the load.
+ */
+typedef struct _E_Module_Preload E_Module_Preload;
+
+struct _E_Module_Preload
+{
+   Eina_Stringshare *file;
+   char             *edj;
+   void             *handle;
+   Ecore_Thread     *thread;
+   int               ref; // the hash and the thread
+   /* under _e_module_preload_lock */
+   Eina_Bool         started;
+   Eina_Bool         claimed;
+   Eina_Bool         done; // the thread no longer touches it
+};
+
+static Eina_Hash *_e_module_preloads = NULL;
+static Eina_List *_e_module_preload_threads = NULL;
+static Eina_Lock _e_module_preload_lock;
+static Eina_Condition _e_module_preload_cond;
+
 static Eina_Bool
 _module_filter_cb(void *d EINA_UNUSED, Eio_File *ls EINA_UNUSED, const Eina_File_Direct_Info *info)
 {
@@ -185,6 +216,9 @@ e_module_init(void)
    E_EVENT_MODULE_INIT_END = ecore_event_type_new();
    _e_module_path_hash = eina_hash_string_superfast_new((Eina_Free_Cb)eina_stringshare_del);
    _e_modules_hash = eina_hash_string_superfast_new(NULL);
+   _e_module_preloads = eina_hash_string_superfast_new(_e_module_preload_free);
+   eina_lock_new(&_e_module_preload_lock);
+   eina_condition_new(&_e_module_preload_cond, &_e_module_preload_lock);
 
    if (!mod_src_path)
      mod_src_path = eina_stringshare_add(getenv("E_MODULE_SRC_PATH"));
@@ -255,6 +289,10 @@ e_module_shutdown(void)
 
    E_FREE_FUNC(_e_module_path_hash, eina_hash_free);
    E_FREE_FUNC(_e_modules_hash, eina_hash_free);
+   _e_module_preload_threads_stop();
+   E_FREE_FUNC(_e_module_preloads, eina_hash_free);
+   eina_condition_free(&_e_module_preload_cond);
+   eina_lock_free(&_e_module_preload_lock);
    E_FREE_LIST(handlers, ecore_event_handler_del);
    E_FREE_LIST(_e_module_path_monitors, eio_monitor_del);
    E_FREE_LIST(_e_module_path_lists, eio_file_cancel);
@@ -291,6 +329,24 @@ e_module_all_load(void)
    e_config->modules =
      eina_list_sort(e_config->modules, 0, _e_module_sort_priority);
 
+   /* start loading modules in the order they will be initialized */
+   EINA_LIST_FOREACH(e_config->modules, l, em)
+     {
+        if ((!em) || (!em->name) || (!em->enabled)) continue;
+        if ((em->delayed) && (!e_config->no_module_delay)) continue;
+        if (_module_is_nosave(em->name)) continue;
+        if (eina_hash_find(_e_modules_hash, em->name)) continue;
+        _e_module_preload_add(em->name);
+     }
+   EINA_LIST_FOREACH(e_config->modules, l, em)
+     {
+        if ((!em) || (!em->name) || (!em->enabled)) continue;
+        if ((!em->delayed) || (e_config->no_module_delay)) continue;
+        if (_module_is_nosave(em->name)) continue;
+        if (eina_hash_find(_e_modules_hash, em->name)) continue;
+        _e_module_preload_add(em->name);
+     }
+
    EINA_LIST_FOREACH_SAFE(e_config->modules, l, ll, em)
      {
         if ((!em) || (!em->name)) continue;
@@ -342,20 +398,11 @@ e_module_loading_get(void)
    return !_e_modules_init_end;
 }
 
-E_API E_Module *
-e_module_new(const char *name)
+static Eina_Stringshare *
+_e_module_path_find(const char *name, char *buf, size_t size)
 {
-   E_Module *m;
-   char buf[PATH_MAX];
-   char body[4096], title[1024];
    const char *modpath = NULL;
-   char *s;
-   int in_list = 0;
-
-   if (!name) return NULL;
-   if (eina_hash_find(_e_modules_hash, name)) return NULL;
 
-   m = E_OBJECT_ALLOC(E_Module, E_MODULE_TYPE, _e_module_free);
    if (name[0] != '/')
      {
         Eina_Stringshare *path = NULL;
@@ -364,24 +411,193 @@ e_module_new(const char *name)
           mod_src_path = eina_stringshare_add(getenv("E_MODULE_SRC_PATH"));
         if (mod_src_path)
           {
-             snprintf(buf, sizeof(buf), "%s/%s/.libs/module.so", mod_src_path, name);
+             snprintf(buf, size, "%s/%s/.libs/module.so", mod_src_path, name);
              modpath = eina_stringshare_add(buf);
           }
         if (!modpath)
           path = eina_hash_find(_e_module_path_hash, name);
         if (path)
           {
-             snprintf(buf, sizeof(buf), "%s/%s/module.so", path, MODULE_ARCH);
+             snprintf(buf, size, "%s/%s/module.so", path, MODULE_ARCH);
              modpath = eina_stringshare_add(buf);
           }
         else if (!modpath)
           {
-             snprintf(buf, sizeof(buf), "%s/%s/module.so", name, MODULE_ARCH);
+             snprintf(buf, size, "%s/%s/module.so", name, MODULE_ARCH);
              modpath = e_path_find(path_modules, buf);
           }
      }
    else if (eina_str_has_extension(name, ".so"))
      modpath = eina_stringshare_add(name);
+   return modpath;
+}
+
+/* fault a file into the page cache */
+static void
+_e_module_preload_file(const char *file)
+{
+   Eina_File *f;
+   void *map;
+
+   f = eina_file_open(file, EINA_FALSE);
+   if (!f) return;
+   map = eina_file_map_all(f, EINA_FILE_POPULATE);
+   if (map) eina_file_map_free(f, map);
+   eina_file_close(f);
+}
+
+static void
+_e_module_preload_unref(E_Module_Preload *mp)
+{
+   if (--mp->ref > 0) return;
+   if (mp->handle) dlclose(mp->handle);
+   eina_stringshare_del(mp->file);
+   free(mp->edj);
+   free(mp);
+}
+
+static void
+_e_module_preload_cb(void *data, Ecore_Thread *th EINA_UNUSED)
+{
+   E_Module_Preload *mp = data;
+
+   eina_lock_take(&_e_module_preload_lock);
+   if (!mp->claimed) mp->started = EINA_TRUE;
+   eina_lock_release(&_e_module_preload_lock);
+
+   if (mp->started)
+     {
+        _e_module_preload_file(mp->file);
+        mp->handle = dlopen(mp->file, (RTLD_NOW | RTLD_LOCAL));
+        if (mp->edj) _e_module_preload_file(mp->edj);
+     }
+
+   eina_lock_take(&_e_module_preload_lock);
+   mp->done = EINA_TRUE;
+   eina_condition_broadcast(&_e_module_preload_cond);
+   eina_lock_release(&_e_module_preload_lock);
+}
+
+static void
+_e_module_preload_end_cb(void *data, Ecore_Thread *th EINA_UNUSED)
+{
+   E_Module_Preload *mp = data;
+
+   _e_module_preload_threads = eina_list_remove(_e_module_preload_threads, mp);
+   _e_module_preload_unref(mp);
+}
+
+/* queued preloads are dropped and running ones waited for, so none
+ * takes the lock once it is freed. the threads that ran keep their
+ * reference until their end callback, whether it still comes or not.
+ */
+static void
+_e_module_preload_threads_stop(void)
+{
+   Eina_List *l, *ll;
+   E_Module_Preload *mp;
+
+   EINA_LIST_FOREACH_SAFE(_e_module_preload_threads, l, ll, mp)
+     {
+        if (mp->thread) ecore_thread_cancel(mp->thread);
+     }
+   eina_lock_take(&_e_module_preload_lock);
+   EINA_LIST_FOREACH(_e_module_preload_threads, l, mp)
+     {
+        mp->claimed = EINA_TRUE;
+        while (!mp->done)
+          eina_condition_wait(&_e_module_preload_cond);
+     }
+   eina_lock_release(&_e_module_preload_lock);
+   _e_module_preload_threads = eina_list_free(_e_module_preload_threads);
+}
+
+static void
+_e_module_preload_add(const char *name)
+{
+   E_Module_Preload *mp;
+   char buf[PATH_MAX], *dir, *moddir;
+
+   if (eina_hash_find(_e_module_preloads, name)) return;
+   mp = E_NEW(E_Module_Preload, 1);
+   if (!mp) return;
+   mp->file = _e_module_path_find(name, buf, sizeof(buf));
+   if (!mp->file)
+     {
+        free(mp);
+        return;
+     }
+   /* module.so is in <module dir>/<arch>/, the edj in <module dir> */
+   dir = ecore_file_dir_get(mp->file);
+   moddir = dir ? ecore_file_dir_get(dir) : NULL;
+   if (moddir)
+     {
+        snprintf(buf, sizeof(buf), "%s/e-module-%s.edj", moddir, name);
+        if (ecore_file_exists(buf)) mp->edj = strdup(buf);
+     }
+   free(moddir);
+   free(dir);
+   mp->ref = 2;
+   eina_hash_add(_e_module_preloads, name, mp);
+   _e_module_preload_threads = eina_list_append(_e_module_preload_threads, mp);
+   mp->thread = ecore_thread_run(_e_module_preload_cb, _e_module_preload_end_cb,
+                                 _e_module_preload_end_cb, mp);
+}
+
+static void
+_e_module_preload_claim(E_Module_Preload *mp)
+{
+   eina_lock_take(&_e_module_preload_lock);
+   if (!mp->started)
+     mp->claimed = EINA_TRUE;
+   else
+     {
+        while (!mp->done)
+          eina_condition_wait(&_e_module_preload_cond);
+     }
+   eina_lock_release(&_e_module_preload_lock);
+}
+
+static void
+_e_module_preload_wait(const char *name)
+{
+   E_Module_Preload *mp;
+
+   if (!_e_module_preloads) return;
+   mp = eina_hash_find(_e_module_preloads, name);
+   if (mp) _e_module_preload_claim(mp);
+}
+
+static void
+_e_module_preload_free(void *data)
+{
+   _e_module_preload_claim(data);
+   _e_module_preload_unref(data);
+}
+
+/* drop the preload's reference once the module has its own handle */
+static void
+_e_module_preload_del(const char *name)
+{
+   if (!_e_module_preloads) return;
+   eina_hash_del_by_key(_e_module_preloads, name);
+}
+
+E_API E_Module *
+e_module_new(const char *name)
+{
+   E_Module *m;
+   char buf[PATH_MAX];
+   char body[4096], title[1024];
+   const char *modpath = NULL;
+   char *s;
+   int in_list = 0;
+
+   if (!name) return NULL;
+   if (eina_hash_find(_e_modules_hash, name)) return NULL;
+
+   m = E_OBJECT_ALLOC(E_Module, E_MODULE_TYPE, _e_module_free);
+   modpath = _e_module_path_find(name, buf, sizeof(buf));
    if (!modpath)
      {
         snprintf(body, sizeof(body),
@@ -392,7 +608,9 @@ e_module_new(const char *name)
         m->error = 1;
         goto init_done;
      }
+   _e_module_preload_wait(name);
    m->handle = dlopen(modpath, (RTLD_NOW | RTLD_LOCAL));
+   _e_module_preload_del(name);
    if (!m->handle)
      {
         snprintf(body, sizeof(body),
@@ -517,11 +735,14 @@ e_module_enable(E_Module *m)
    Eina_List *l;
    E_Event_Module_Update *ev;
    E_Config_Module *em;
+   double t;
 
    E_OBJECT_CHECK_RETURN(m, 0);
    E_OBJECT_TYPE_CHECK_RETURN(m, E_MODULE_TYPE, 0);
    if ((m->enabled) || (m->error)) return 0;
+   t = e_startup_trace_time_get();
    m->data = m->func.init(m);
+   e_startup_trace_span_add("module", m->name, t, e_startup_trace_time_get());
    if (m->data)
      {
         m->enabled = 1;
@@ -82,77 +82,205 @@ ignore_client(const E_Client *ec, const Eina_List *skiplist)
    return EINA_FALSE;
 }
 
+/* coverage of the desk by client (and obstacle) rectangles as a summed-area
+ * table over the compressed grid of rectangle edges: cell (i, j) spans
+ * x[i]..x[i + 1], y[j]..y[j + 1] and is covered by d rectangles.
+ * sat, row and col are the integrals of d up to each grid corner, which
+ * makes the overlap of any rectangle a constant number of lookups
+ */
+typedef struct _E_Place_Coverage
+{
+   Eina_Rectangle *rects;
+   int             rects_num, rects_alloc;
+   int            *x, *y;
+   int             nx, ny;
+   long long      *d; // rectangles covering each cell
+   long long      *sat; // integral of d over [x[0], x[i]] x [y[0], y[j]]
+   long long      *row; // integral of d along row j up to x[i]
+   long long      *col; // integral of d along column i up to y[j]
+} E_Place_Coverage;
+
+static void
+_e_place_coverage_rect_add(E_Place_Coverage *cov, int x, int y, int w, int h)
+{
+   if ((w <= 0) || (h <= 0)) return;
+   if (cov->rects_num == cov->rects_alloc)
+     {
+        cov->rects_alloc += 32;
+        E_REALLOC(cov->rects, Eina_Rectangle, cov->rects_alloc);
+     }
+   EINA_RECTANGLE_SET(&cov->rects[cov->rects_num], x, y, w, h);
+   cov->rects_num++;
+}
+
 static int
-_e_place_coverage_client_add(Eina_List *skiplist, int ar, int x, int y, int w, int h)
+_e_place_edges_unique(int *e, int n)
 {
-   E_Client *ec;
-   int x2, y2, w2, h2;
-   int iw, ih;
-   int x0, x00, yy0, y00;
+   int i, u = 0;
 
-   E_CLIENT_REVERSE_FOREACH(ec)
+   qsort(e, n, sizeof(int), _e_place_cb_sort_cmp);
+   for (i = 0; i < n; i++)
+     if ((!u) || (e[u - 1] != e[i])) e[u++] = e[i];
+   return u;
+}
+
+/* index of the grid cell containing v; v must be inside the grid */
+static int
+_e_place_edge_find(const int *e, int n, int v)
+{
+   int lo = 0, hi = n - 2;
+
+   while (lo < hi)
      {
-        if (ignore_client(ec, skiplist)) continue;
-        if (ignore_client_and_break(ec)) break;
-        x2 = ec->x; y2 = ec->y; w2 = ec->w; h2 = ec->h;
-        if (E_INTERSECTS(x, y, w, h, x2, y2, w2, h2))
+        int mid = (lo + hi + 1) / 2;
+
+        if (e[mid] <= v) lo = mid;
+        else hi = mid - 1;
+     }
+   return lo;
+}
+
+/* clip the collected rectangles to the region candidates can cover and
+ * build the tables
+ */
+static void
+_e_place_coverage_build(E_Place_Coverage *cov, int bx, int by, int bw, int bh)
+{
+   int i, j, n, nx, ny;
+   Eina_Rectangle *r, clip;
+
+   EINA_RECTANGLE_SET(&clip, bx, by, bw, bh);
+   for (i = n = 0; i < cov->rects_num; i++)
+     {
+        r = &cov->rects[i];
+        if (!eina_rectangle_intersection(r, &clip)) continue;
+        cov->rects[n++] = *r;
+     }
+   cov->rects_num = n;
+   if (!n) return;
+
+   cov->x = malloc(sizeof(int) * n * 2);
+   cov->y = malloc(sizeof(int) * n * 2);
+   if ((!cov->x) || (!cov->y)) goto err;
+   for (i = 0; i < n; i++)
+     {
+        r = &cov->rects[i];
+        cov->x[i * 2] = r->x;
+        cov->x[i * 2 + 1] = r->x + r->w;
+        cov->y[i * 2] = r->y;
+        cov->y[i * 2 + 1] = r->y + r->h;
+     }
+   nx = cov->nx = _e_place_edges_unique(cov->x, n * 2);
+   ny = cov->ny = _e_place_edges_unique(cov->y, n * 2);
+
+   cov->d = calloc((size_t)nx * ny * 4, sizeof(long long));
+   if (!cov->d) goto err;
+   cov->sat = cov->d + (nx * ny);
+   cov->row = cov->sat + (nx * ny);
+   cov->col = cov->row + (nx * ny);
+
+   /* 2d difference array of the rectangles, then prefix sums into counts */
+   for (i = 0; i < n; i++)
+     {
+        int x1, y1, x2, y2;
+
+        r = &cov->rects[i];
+        x1 = _e_place_edge_find(cov->x, nx, r->x);
+        y1 = _e_place_edge_find(cov->y, ny, r->y);
+        x2 = _e_place_edge_find(cov->x, nx, r->x + r->w - 1) + 1;
+        y2 = _e_place_edge_find(cov->y, ny, r->y + r->h - 1) + 1;
+        cov->d[y1 * nx + x1]++;
+        cov->d[y1 * nx + x2]--;
+        cov->d[y2 * nx + x1]--;
+        cov->d[y2 * nx + x2]++;
+     }
+   for (j = 0; j < ny; j++)
+     for (i = 1; i < nx; i++)
+       cov->d[j * nx + i] += cov->d[j * nx + i - 1];
+   for (j = 1; j < ny; j++)
+     for (i = 0; i < nx; i++)
+       cov->d[j * nx + i] += cov->d[(j - 1) * nx + i];
+
+   for (j = 0; j < ny - 1; j++)
+     {
+        long long ch = cov->y[j + 1] - cov->y[j];
+
+        for (i = 0; i < nx - 1; i++)
           {
-             x0 = x;
-             if (x < x2) x0 = x2;
-             x00 = (x + w);
-             if ((x2 + w2) < (x + w)) x00 = (x2 + w2);
-             yy0 = y;
-             if (y < y2) yy0 = y2;
-             y00 = (y + h);
-             if ((y2 + h2) < (y + h)) y00 = (y2 + h2);
-             iw = x00 - x0;
-             ih = y00 - yy0;
-             ar += (iw * ih);
+             long long cw = cov->x[i + 1] - cov->x[i];
+             long long d = cov->d[j * nx + i];
+
+             cov->row[j * nx + i + 1] = cov->row[j * nx + i] + (d * cw);
+             cov->col[(j + 1) * nx + i] = cov->col[j * nx + i] + (d * ch);
+             cov->sat[(j + 1) * nx + i + 1] = cov->sat[(j + 1) * nx + i] +
+               cov->sat[j * nx + i + 1] - cov->sat[j * nx + i] + (d * cw * ch);
           }
      }
-   return ar;
+   return;
+err:
+   E_FREE(cov->x);
+   E_FREE(cov->y);
+   cov->nx = cov->ny = 0;
 }
 
-static int
-_e_place_coverage_zone_obstacles_add_single(E_Zone_Obstacle *obs, int ar, int x, int y, int w, int h)
+static void
+_e_place_coverage_free(E_Place_Coverage *cov)
 {
-   int x2, y2, w2, h2;
-   int x0, x00, yy0, y00;
-   int iw, ih;
+   free(cov->rects);
+   free(cov->x);
+   free(cov->y);
+   free(cov->d);
+}
 
-   x2 = obs->x; y2 = obs->y; w2 = obs->w; h2 = obs->h;
-   if (!E_INTERSECTS(x, y, w, h, x2, y2, w2, h2)) return ar;
+/* integral of the coverage over [x[0], px] x [y[0], py] */
+static long long
+_e_place_coverage_integral(const E_Place_Coverage *cov, int px, int py)
+{
+   int i, j, nx = cov->nx;
+   long long dx, dy;
+
+   if ((px <= cov->x[0]) || (py <= cov->y[0])) return 0;
+   if (px > cov->x[nx - 1]) px = cov->x[nx - 1];
+   if (py > cov->y[cov->ny - 1]) py = cov->y[cov->ny - 1];
+   i = _e_place_edge_find(cov->x, nx, px);
+   j = _e_place_edge_find(cov->y, cov->ny, py);
+   dx = px - cov->x[i];
+   dy = py - cov->y[j];
+   return cov->sat[j * nx + i] + (dy * cov->row[j * nx + i]) +
+          (dx * cov->col[j * nx + i]) + (dx * dy * cov->d[j * nx + i]);
+}
 
-   /* FIXME: this option implies that windows should be resized when
-    * an autohide shelf toggles its visibility, but it is not used correctly
-    * and is instead used to determine whether shelves can be overlapped
-    */
-   if (!e_config->border_fix_on_shelf_toggle) return 0x7fffffff;
-
-   x0 = x;
-   if (x < x2) x0 = x2;
-   x00 = (x + w);
-   if ((x2 + w2) < (x + w)) x00 = (x2 + w2);
-   yy0 = y;
-   if (y < y2) yy0 = y2;
-   y00 = (y + h);
-   if ((y2 + h2) < (y + h)) y00 = (y2 + h2);
-   iw = x00 - x0;
-   ih = y00 - yy0;
-   ar += (iw * ih);
+static int
+_e_place_coverage_get(const E_Place_Coverage *cov, int x, int y, int w, int h)
+{
+   long long ar;
+
+   if (cov->nx < 2) return 0;
+   ar = _e_place_coverage_integral(cov, x + w, y + h) -
+        _e_place_coverage_integral(cov, x, y + h) -
+        _e_place_coverage_integral(cov, x + w, y) +
+        _e_place_coverage_integral(cov, x, y);
+   /* 0x7fffffff is reserved for blocked placements */
+   if (ar >= 0x7fffffff) ar = 0x7ffffffe;
    return ar;
 }
 
-static int
-_e_place_coverage_zone_obstacles_add(E_Desk *desk, int ar, int x, int y, int w, int h)
+/* obstacles which must not be overlapped at all */
+static Eina_Bool
+_e_place_coverage_zone_obstacles_block(E_Desk *desk, int x, int y, int w, int h)
 {
    E_Zone_Obstacle *obs;
 
+   /* FIXME: this option implies that windows should be resized when
+    * an autohide shelf toggles its visibility, but it is not used correctly
+    * and is instead used to determine whether shelves can be overlapped
+    */
+   if (e_config->border_fix_on_shelf_toggle) return EINA_FALSE;
    EINA_INLIST_FOREACH(desk->obstacles, obs)
-     ar = _e_place_coverage_zone_obstacles_add_single(obs, ar, x, y, w, h);
+     if (E_INTERSECTS(x, y, w, h, obs->x, obs->y, obs->w, obs->h)) return EINA_TRUE;
    EINA_INLIST_FOREACH(desk->zone->obstacles, obs)
-     ar = _e_place_coverage_zone_obstacles_add_single(obs, ar, x, y, w, h);
-   return ar;
+     if (E_INTERSECTS(x, y, w, h, obs->x, obs->y, obs->w, obs->h)) return EINA_TRUE;
+   return EINA_FALSE;
 }
 
 static int *
@@ -216,14 +344,14 @@ _e_place_desk_region_smart_obstacle_add(char *u_x, char *u_y, int **a_x, int **a
  * geometry to use
  */
 static int
-_e_place_desk_region_smart_area_check(Eina_List *skiplist, int x, int y, int w, int h, E_Desk *desk, int area, int *rx, int *ry)
+_e_place_desk_region_smart_area_check(const E_Place_Coverage *cov, int x, int y, int w, int h, E_Desk *desk, int area, int *rx, int *ry)
 {
-   int ar = 0;
-
-   ar = _e_place_coverage_client_add(skiplist, ar, x, y, w, h);
+   int ar;
 
-   if (e_config->window_placement_policy == E_WINDOW_PLACEMENT_SMART)
-     ar = _e_place_coverage_zone_obstacles_add(desk, ar, x, y, w, h);
+   if ((e_config->window_placement_policy == E_WINDOW_PLACEMENT_SMART) &&
+       _e_place_coverage_zone_obstacles_block(desk, x, y, w, h))
+     return 0x7fffffff;
+   ar = _e_place_coverage_get(cov, x, y, w, h);
 
    if (ar < area)
      {
@@ -236,40 +364,40 @@ _e_place_desk_region_smart_area_check(Eina_List *skiplist, int x, int y, int w,
 
 /* calculate optimal placement based on "overlapping" area using:
  * - an obstacle's top-left and bottom-right points
- * - list of clients to skip
+ * - coverage of the desk
  * - current desk
  * - current least overlapping area
  * - pointers to current coords to use for placement
  * and then return the new least overlapping area
  */
 static int
-_e_place_desk_region_smart_area_calc(int x, int y, int xx, int yy, int zx, int zy, int zw, int zh, int w, int h, Eina_List *skiplist, E_Desk *desk, int area, int *rx, int *ry)
+_e_place_desk_region_smart_area_calc(int x, int y, int xx, int yy, int zx, int zy, int zw, int zh, int w, int h, const E_Place_Coverage *cov, E_Desk *desk, int area, int *rx, int *ry)
 {
    /* check top-left corner placement */
    if ((x <= MAX(zx, zx + (zw - w))) && (y <= MAX(zy, zy + (zh - h))))
      {
-        int ar = _e_place_desk_region_smart_area_check(skiplist, x, y, w, h, desk, area, rx, ry);
+        int ar = _e_place_desk_region_smart_area_check(cov, x, y, w, h, desk, area, rx, ry);
         if (!ar) return ar;
         if (ar < area) area = ar;
      }
    /* check top-right corner placement */
    if ((MAX(zx, xx - w) > zx) && (y <= MAX(zy, zy + (zh - h))))
      {
-        int ar = _e_place_desk_region_smart_area_check(skiplist, xx - w, y, w, h, desk, area, rx, ry);
+        int ar = _e_place_desk_region_smart_area_check(cov, xx - w, y, w, h, desk, area, rx, ry);
         if (!ar) return ar;
         if (ar < area) area = ar;
      }
    /* check bottom-right corner placement */
    if ((MAX(zx, xx - w) > zx) && (MAX(zy, yy - h) > zy))
      {
-        int ar = _e_place_desk_region_smart_area_check(skiplist, xx - w, yy - h, w, h, desk, area, rx, ry);
+        int ar = _e_place_desk_region_smart_area_check(cov, xx - w, yy - h, w, h, desk, area, rx, ry);
         if (!ar) return ar;
         if (ar < area) area = ar;
      }
    /* check bottom-left corner placement */
    if ((x <= MAX(zx, zx + (zw - w))) && (MAX(zy, yy - h) > zy))
      {
-        int ar = _e_place_desk_region_smart_area_check(skiplist, x, yy - h, w, h, desk, area, rx, ry);
+        int ar = _e_place_desk_region_smart_area_check(cov, x, yy - h, w, h, desk, area, rx, ry);
         if (!ar) return ar;
         if (ar < area) area = ar;
      }
@@ -283,6 +411,7 @@ e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w
    int *a_x = NULL, *a_y = NULL;
    int zx, zy, zw, zh;
    char *u_x = NULL, *u_y = NULL;
+   E_Place_Coverage cov = { 0 };
    E_Client *ec;
 
    *rx = x;
@@ -339,6 +468,8 @@ e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w
              if (E_INTERSECTS(bx, by, bw, bh, zx, zy, zw, zh))
                _e_place_desk_region_smart_obstacle_add(u_x, u_y, &a_x, &a_y,
                  &a_w, &a_h, &a_alloc_w, &a_alloc_h, zx, zy, zw, zh, bx, by, bw, bh);
+             if (e_config->border_fix_on_shelf_toggle)
+               _e_place_coverage_rect_add(&cov, bx, by, bw, bh);
           }
         EINA_INLIST_FOREACH(desk->zone->obstacles, obs)
           {
@@ -351,9 +482,13 @@ e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w
              if (E_INTERSECTS(bx, by, bw, bh, zx, zy, zw, zh))
                _e_place_desk_region_smart_obstacle_add(u_x, u_y, &a_x, &a_y,
                  &a_w, &a_h, &a_alloc_w, &a_alloc_h, zx, zy, zw, zh, bx, by, bw, bh);
+             if (e_config->border_fix_on_shelf_toggle)
+               _e_place_coverage_rect_add(&cov, bx, by, bw, bh);
           }
      }
 
+   /* clients above the topmost fullscreen/maximized client are
+    * what a new window can overlap */
    E_CLIENT_REVERSE_FOREACH(ec)
      {
         int bx, by, bw, bh;
@@ -366,6 +501,8 @@ e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w
         bw = ec->w;
         bh = ec->h;
 
+        _e_place_coverage_rect_add(&cov, bx, by, bw, bh);
+
         if (E_INTERSECTS(bx, by, bw, bh, zx, zy, zw, zh))
           _e_place_desk_region_smart_obstacle_add(u_x, u_y, &a_x, &a_y,
             &a_w, &a_h, &a_alloc_w, &a_alloc_h, zx, zy, zw, zh, bx, by, bw, bh);
@@ -375,6 +512,18 @@ e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w
    free(u_x);
    free(u_y);
 
+   /* every candidate lies within the zone, extended right/down when the
+    * window is larger than it, or at the requested position */
+   {
+      int cx1, cy1, cx2, cy2;
+
+      cx1 = MIN(zx, x);
+      cy1 = MIN(zy, y);
+      cx2 = MAX(zx + MAX(zw, w), x + w);
+      cy2 = MAX(zy + MAX(zh, h), y + h);
+      _e_place_coverage_build(&cov, cx1, cy1, cx2 - cx1, cy2 - cy1);
+   }
+
    {
       int i, j;
       int area = 0x7fffffff;
@@ -382,24 +531,8 @@ e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w
       if ((x <= zx + (zw - w)) &&
           (y <= zy + (zh - h)))
         {
-           int ar = 0;
-
-           ar = _e_place_coverage_client_add(skiplist, ar,
-                                             x, y,
-                                             w, h);
-
-           if (e_config->window_placement_policy == E_WINDOW_PLACEMENT_SMART)
-             ar = _e_place_coverage_zone_obstacles_add(desk, ar,
-                                              x, y,
-                                              w, h);
-
-           if (ar < area)
-             {
-                area = ar;
-                *rx = x;
-                *ry = y;
-                if (ar == 0) goto done;
-             }
+           area = _e_place_desk_region_smart_area_check(&cov, x, y, w, h, desk, area, rx, ry);
+           if (!area) goto done;
         }
 
       /* loop through all the obstacles in the arrays of coords
@@ -410,11 +543,12 @@ e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w
         for (i = 0; i < a_w - 1; i++)
           {
              area = _e_place_desk_region_smart_area_calc(a_x[i], a_y[j], a_x[i + 1], a_y[j + 1],
-                                                         zx, zy, zw, zh, w, h, skiplist, desk, area, rx, ry);
+                                                         zx, zy, zw, zh, w, h, &cov, desk, area, rx, ry);
              if (!area) goto done;
           }
    }
 done:
+   _e_place_coverage_free(&cov);
    E_FREE(a_x);
    E_FREE(a_y);
 
@@ -163,6 +163,18 @@ e_powersave_sleeper_free(E_Powersave_Sleeper *sleeper)
    eina_freeq_ptr_add(eina_freeq_main_get(), sleeper, free, sizeof(*sleeper));
 }
 
+/* make a thread sleeping on sleeper return now, e.g. when what it
+ * polls for changed */
+E_API void
+e_powersave_sleeper_wake(E_Powersave_Sleeper *sleeper)
+{
+   char buf[1] = { 1 };
+
+   if (!sleeper) return;
+   if (write(ecore_pipe_write_fd(sleeper->pipe), buf, 1) < 0)
+     fprintf(stderr, "%s: ERROR WRITING TO FD\n", __func__);
+}
+
 E_API void
 e_powersave_sleeper_sleep(E_Powersave_Sleeper *sleeper, int poll_interval)
 {
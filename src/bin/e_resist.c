@@ -17,7 +17,7 @@ e_resist_client_position(Eina_List *skiplist,
                                    int x, int y, int w, int h,
                                    int *rx, int *ry, int *rw, int *rh)
 {
-   Eina_List *l, *rects = NULL;
+   Eina_List *l, *clients, *rects = NULL;
    E_Resist_Rect *r;
    E_Client *ec;
    E_Desk *desk;
@@ -55,7 +55,12 @@ e_resist_client_position(Eina_List *skiplist,
    /* FIXME: need to add resist or complete BLOCKS for things like ibar */
    /* can add code here to add more fake obstacles with custom resist values */
    /* here if need be - ie xinerama middle between screens and panels etc. */
-   E_CLIENT_FOREACH(ec)
+   /* only windows near the area swept by the move can offer resistance */
+   clients = e_client_index_clients_get(MIN(px, x) - e_config->window_resist,
+                                        MIN(py, y) - e_config->window_resist,
+                                        MAX(px + pw, x + w) - MIN(px, x) + (2 * e_config->window_resist),
+                                        MAX(py + ph, y + h) - MIN(py, y) + (2 * e_config->window_resist));
+   EINA_LIST_FREE(clients, ec)
      {
         if (e_client_util_ignored_get(ec) || (!evas_object_visible_get(ec->frame))) continue;
         if (ec->offer_resistance && (!eina_list_data_find(skiplist, ec)))
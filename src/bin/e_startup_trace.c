@@ -0,0 +1,331 @@
+#include "e.h"
+
+/* Startup timeline. The TS() markers in e_main.c, the e_modapi_init() of
+ * every module and the first milestones of the main loop are kept with
+ * monotonic timestamps and written in the chrome trace event format
+ * (chrome://tracing, perfetto) once startup has settled, to the file in
+ * $E_STARTUP_TRACE or <user dir>/startup-trace.json. Setting
+ * E_STARTUP_TRACE to an empty string turns the file off. A marker "X Done"
+ * closes the phase opened by the marker "X". Markers start before eina is
+ * up so the event array only uses libc.
+ */
+
+#define STARTUP_TRACE_TIMEOUT 60.0
+
+typedef struct _E_Startup_Trace_Event E_Startup_Trace_Event;
+
+struct _E_Startup_Trace_Event
+{
+   const char *cat;
+   const char *name;
+   double      t;
+   double      dur; // < 0 for an instant
+   Eina_Bool   copy E_BITFIELD;
+};
+
+static E_Startup_Trace_Event *_events = NULL;
+static unsigned int _events_num = 0;
+static unsigned int _events_size = 0;
+static double _t0 = -1.0;
+static Eina_Bool _done = EINA_FALSE;
+
+static Eina_List *_handlers = NULL;
+static Ecore_Timer *_timeout = NULL;
+static Eina_Bool _frame = EINA_FALSE;
+static Eina_Bool _client = EINA_FALSE;
+static Eina_Bool _modules = EINA_FALSE;
+
+static void
+_e_startup_trace_event_add(const char *cat, const char *name, Eina_Bool copy, double t, double dur)
+{
+   E_Startup_Trace_Event *ev;
+
+   if (_done) return;
+   if (_events_num == _events_size)
+     {
+        unsigned int size = _events_size ? _events_size * 2 : 256;
+
+        ev = realloc(_events, size * sizeof(E_Startup_Trace_Event));
+        if (!ev) return;
+        _events = ev;
+        _events_size = size;
+     }
+   if (copy)
+     {
+        name = strdup(name);
+        if (!name) return;
+     }
+   if (_t0 < 0.0) _t0 = t;
+   ev = &_events[_events_num++];
+   ev->cat = cat;
+   ev->name = name;
+   ev->t = t;
+   ev->dur = dur;
+   ev->copy = copy;
+}
+
+static void
+_e_startup_trace_json_str(FILE *f, const char *s)
+{
+   fputc('"', f);
+   for (; *s; s++)
+     {
+        if ((*s == '"') || (*s == '\\'))
+          fprintf(f, "\\%c", *s);
+        else if ((unsigned char)*s < 0x20)
+          fprintf(f, "\\u%04x", (unsigned char)*s);
+        else
+          fputc(*s, f);
+     }
+   fputc('"', f);
+}
+
+static void
+_e_startup_trace_write(void)
+{
+   E_Startup_Trace_Event *ev;
+   const char *file;
+   char buf[PATH_MAX], tmp[PATH_MAX + 8];
+   unsigned int i;
+   FILE *f;
+   int pid = getpid();
+
+   file = getenv("E_STARTUP_TRACE");
+   if (!file)
+     {
+        e_user_dir_concat_static(buf, "/startup-trace.json");
+        file = buf;
+     }
+   if (!file[0]) return;
+   snprintf(tmp, sizeof(tmp), "%s.tmp", file);
+   f = fopen(tmp, "w");
+   if (!f)
+     {
+        ERR("Cannot write startup trace %s", tmp);
+        return;
+     }
+   fprintf(f, "{\"traceEvents\":[\n"
+           "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%i,\"tid\":%i,"
+           "\"args\":{\"name\":\"enlightenment\"}}", pid, pid);
+   for (i = 0; i < _events_num; i++)
+     {
+        ev = &_events[i];
+        fprintf(f, ",\n{\"name\":");
+        _e_startup_trace_json_str(f, ev->name);
+        fprintf(f, ",\"cat\":\"%s\",\"ts\":%.3f,\"pid\":%i,\"tid\":%i,",
+                ev->cat, (ev->t - _t0) * 1000000.0, pid, pid);
+        if (ev->dur >= 0.0)
+          fprintf(f, "\"ph\":\"X\",\"dur\":%.3f}", ev->dur * 1000000.0);
+        else
+          fprintf(f, "\"ph\":\"i\",\"s\":\"g\"}");
+     }
+   fprintf(f, "\n],\n\"displayTimeUnit\":\"ms\",\n"
+           "\"otherData\":{\"version\":\"%s\"}}\n", VERSION);
+   if ((fclose(f)) || (rename(tmp, file)))
+     {
+        ERR("Cannot write startup trace %s", file);
+        unlink(tmp);
+     }
+}
+
+static void _e_startup_trace_cb_render_post(void *data, Evas *e, void *event_info);
+
+static void
+_e_startup_trace_finish(void)
+{
+   if (_done) return;
+   _e_startup_trace_write();
+   _done = EINA_TRUE;
+   if (!_frame)
+     evas_event_callback_del(e_comp->evas, EVAS_CALLBACK_RENDER_POST,
+                             _e_startup_trace_cb_render_post);
+   E_FREE_LIST(_handlers, ecore_event_handler_del);
+   E_FREE_FUNC(_timeout, ecore_timer_del);
+}
+
+static void
+_e_startup_trace_milestone(const char *name)
+{
+   if (_done) return;
+   _e_startup_trace_event_add("milestone", name, EINA_FALSE,
+                              e_startup_trace_time_get(), -1.0);
+   /* the trace is written when the desktop is up and again if a client
+    * maps after that */
+   if ((!_frame) || (!_modules)) return;
+   if (_client)
+     _e_startup_trace_finish();
+   else
+     _e_startup_trace_write();
+}
+
+static void
+_e_startup_trace_cb_render_post(void *data EINA_UNUSED, Evas *e, void *event_info EINA_UNUSED)
+{
+   evas_event_callback_del(e, EVAS_CALLBACK_RENDER_POST,
+                           _e_startup_trace_cb_render_post);
+   if (_frame) return;
+   _frame = EINA_TRUE;
+   _e_startup_trace_milestone("first frame");
+}
+
+static Eina_Bool
+_e_startup_trace_cb_client_show(void *data EINA_UNUSED, int type EINA_UNUSED, void *event EINA_UNUSED)
+{
+   if (!_client)
+     {
+        _client = EINA_TRUE;
+        _e_startup_trace_milestone("first client mapped");
+     }
+   return ECORE_CALLBACK_PASS_ON;
+}
+
+static Eina_Bool
+_e_startup_trace_cb_module_init_end(void *data EINA_UNUSED, int type EINA_UNUSED, void *event EINA_UNUSED)
+{
+   if (!_modules)
+     {
+        _modules = EINA_TRUE;
+        _e_startup_trace_milestone("modules loaded");
+     }
+   return ECORE_CALLBACK_PASS_ON;
+}
+
+static Eina_Bool
+_e_startup_trace_cb_timeout(void *data EINA_UNUSED)
+{
+   _timeout = NULL;
+   _e_startup_trace_finish();
+   return EINA_FALSE;
+}
+
+static int
+_e_startup_trace_sort_dur(const void *d1, const void *d2)
+{
+   const E_Startup_Trace_Event *ev1 = *(const E_Startup_Trace_Event **)d1;
+   const E_Startup_Trace_Event *ev2 = *(const E_Startup_Trace_Event **)d2;
+
+   if (ev1->dur > ev2->dur) return -1;
+   if (ev1->dur < ev2->dur) return 1;
+   return 0;
+}
+
+static void
+_e_startup_trace_slowest_append(Eina_Strbuf *buf, const char *title, const char *cat, unsigned int max)
+{
+   E_Startup_Trace_Event **evs;
+   unsigned int i, num = 0;
+
+   evs = malloc(_events_num * sizeof(E_Startup_Trace_Event *));
+   if (!evs) return;
+   for (i = 0; i < _events_num; i++)
+     {
+        if ((_events[i].dur >= 0.0) && (!strcmp(_events[i].cat, cat)))
+          evs[num++] = &_events[i];
+     }
+   if (num)
+     {
+        qsort(evs, num, sizeof(E_Startup_Trace_Event *), _e_startup_trace_sort_dur);
+        eina_strbuf_append_printf(buf, "%s:\n", title);
+        for (i = 0; (i < num) && (i < max); i++)
+          eina_strbuf_append_printf(buf, "  %8.3fs  %s\n", evs[i]->dur, evs[i]->name);
+     }
+   free(evs);
+}
+
+EINTERN double
+e_startup_trace_time_get(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (double)ts.tv_sec + ((double)ts.tv_nsec / 1000000000.0);
+}
+
+/* name must stay valid for the life of the process, as TS() literals do */
+EINTERN void
+e_startup_trace_mark(const char *name)
+{
+   E_Startup_Trace_Event *ev;
+   double t = e_startup_trace_time_get();
+   size_t len;
+   int i;
+
+   while (isspace((unsigned char)*name)) name++;
+   len = strlen(name);
+   if ((len > 5) && (!strcmp(name + len - 5, " Done")))
+     {
+        for (i = (int)_events_num - 1; i >= 0; i--)
+          {
+             ev = &_events[i];
+             if ((ev->dur >= 0.0) || (ev->copy) || (strcmp(ev->cat, "startup"))) continue;
+             if ((strlen(ev->name) != len - 5) || (strncmp(ev->name, name, len - 5))) continue;
+             ev->dur = t - ev->t;
+             return;
+          }
+     }
+   _e_startup_trace_event_add("startup", name, EINA_FALSE, t, -1.0);
+}
+
+EINTERN void
+e_startup_trace_span_add(const char *cat, const char *name, double start, double end)
+{
+   _e_startup_trace_event_add(cat, name, EINA_TRUE, start, end - start);
+}
+
+/* called just before the main loop begins, when the compositor exists */
+EINTERN void
+e_startup_trace_loop_begin(void)
+{
+   _e_startup_trace_milestone("main loop");
+   evas_event_callback_add(e_comp->evas, EVAS_CALLBACK_RENDER_POST,
+                           _e_startup_trace_cb_render_post, NULL);
+   E_LIST_HANDLER_APPEND(_handlers, E_EVENT_CLIENT_SHOW,
+                         _e_startup_trace_cb_client_show, NULL);
+   E_LIST_HANDLER_APPEND(_handlers, E_EVENT_MODULE_INIT_END,
+                         _e_startup_trace_cb_module_init_end, NULL);
+   _timeout = ecore_timer_loop_add(STARTUP_TRACE_TIMEOUT,
+                                   _e_startup_trace_cb_timeout, NULL);
+   if (!e_module_loading_get())
+     {
+        _modules = EINA_TRUE;
+        _e_startup_trace_milestone("modules loaded");
+     }
+}
+
+EINTERN int
+e_startup_trace_shutdown(void)
+{
+   unsigned int i;
+
+   _e_startup_trace_finish();
+   for (i = 0; i < _events_num; i++)
+     {
+        if (_events[i].copy) free((char *)_events[i].name);
+     }
+   E_FREE(_events);
+   _events_num = _events_size = 0;
+   return 1;
+}
+
+/* a readable summary of the trace, to be freed */
+E_API char *
+e_startup_trace_summary_get(void)
+{
+   Eina_Strbuf *buf;
+   char *s;
+   unsigned int i;
+
+   buf = eina_strbuf_new();
+   eina_strbuf_append_printf(buf, "Enlightenment %s startup\n", VERSION);
+   for (i = 0; i < _events_num; i++)
+     {
+        if (strcmp(_events[i].cat, "milestone")) continue;
+        eina_strbuf_append_printf(buf, "  %8.3fs  %s\n",
+                                  _events[i].t - _t0, _events[i].name);
+     }
+   _e_startup_trace_slowest_append(buf, "slowest phases", "startup", 10);
+   _e_startup_trace_slowest_append(buf, "slowest modules", "module", 10);
+   s = eina_strbuf_string_steal(buf);
+   eina_strbuf_free(buf);
+   return s;
+}
@@ -0,0 +1,14 @@
+#ifdef E_TYPEDEFS
+#else
+#ifndef E_STARTUP_TRACE_H
+#define E_STARTUP_TRACE_H
+
+EINTERN double e_startup_trace_time_get(void);
+EINTERN void   e_startup_trace_mark(const char *name);
+EINTERN void   e_startup_trace_span_add(const char *cat, const char *name, double start, double end);
+EINTERN void   e_startup_trace_loop_begin(void);
+EINTERN int    e_startup_trace_shutdown(void);
+E_API char    *e_startup_trace_summary_get(void);
+
+#endif
+#endif
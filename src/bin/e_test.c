@@ -35,6 +35,9 @@ e_test(void)
 #ifdef DESKMIRROR_TEST
    ecore_timer_loop_add(2.0, deskmirror_test, NULL);
 #endif
+#ifdef FM_MIME_BENCH
+   e_fm_mime_bench();
+#endif
 }
 
 #if 0
@@ -1,11 +1,27 @@
 #include "e.h"
 
-typedef struct _E_Thumb E_Thumb;
+/* each thumbnailer process is handed at most this many requests at a time,
+ * the rest wait in _thumb_queue where they are ordered by priority and can
+ * be dropped without a round trip
+ */
+#define THUMB_WORKER_INFLIGHT 2
+#define THUMB_WORKERS_MAX     16
+
+typedef struct _E_Thumb        E_Thumb;
+typedef struct _E_Thumb_Worker E_Thumb_Worker;
+
+struct _E_Thumb_Worker
+{
+   Ecore_Ipc_Client *cli;
+   Eina_List        *busy; // E_Thumb being generated by this thumbnailer
+};
 
 struct _E_Thumb
 {
    int           objid;
    int           w, h;
+   int           priority;
+   E_Thumb_Worker *worker;
    const char   *file;
    const char   *key;
    char         *sort_id;
@@ -19,8 +35,13 @@ struct _E_Thumb
 };
 
 /* local subsystem functions */
-static void         _e_thumb_gen_begin(int objid, const char *file, const char *key, int w, int h, int desk_x, int desk_y, int desk_x_count, int desk_y_count, Eina_List *sigsrc);
-static void         _e_thumb_gen_end(int objid);
+static void         _e_thumb_gen_begin(E_Thumb_Worker *tw, E_Thumb *eth);
+static void         _e_thumb_gen_end(E_Thumb_Worker *tw, int objid);
+static void         _e_thumb_queue_add(E_Thumb *eth);
+static void         _e_thumb_dispatch(void);
+static void         _e_thumb_cancel(E_Thumb *eth);
+static int          _e_thumb_thumbnailers_num(void);
+static void         _e_thumb_thumbnailers_spawn(void);
 static void         _e_thumb_del_hook(void *data, Evas *e, Evas_Object *obj, void *event_info);
 static void         _e_thumb_hash_add(int objid, Evas_Object *obj);
 static void         _e_thumb_hash_del(int objid);
@@ -37,7 +58,6 @@ static Eina_List *_thumb_queue = NULL;
 static int _objid = 0;
 static Eina_Hash *_thumbs = NULL;
 static int _pending = 0;
-static int _num_thumbnailers = 1;
 static Ecore_Event_Handler *_exe_del_handler = NULL;
 static Ecore_Timer *_kill_timer = NULL;
 
@@ -55,13 +75,25 @@ e_thumb_init(void)
 EINTERN int
 e_thumb_shutdown(void)
 {
+   E_Thumb_Worker *tw;
+   E_Thumb *eth;
+
    _e_thumb_thumbnailers_kill_cancel();
    _e_thumb_cb_kill(NULL);
    if (_exe_del_handler) ecore_event_handler_del(_exe_del_handler);
    _exe_del_handler = NULL;
-   _thumbnailers = eina_list_free(_thumbnailers);
+   EINA_LIST_FREE(_thumbnailers, tw)
+     {
+        EINA_LIST_FREE(tw->busy, eth)
+          {
+             eth->busy = 0;
+             eth->worker = NULL;
+          }
+        free(tw);
+     }
+   EINA_LIST_FREE(_thumb_queue, eth)
+     eth->queued = 0;
    E_FREE_LIST(_thumbnailers_exe, ecore_exe_free);
-   _thumb_queue = eina_list_free(_thumb_queue);
    _objid = 0;
    eina_hash_free(_thumbs);
    _thumbs = NULL;
@@ -122,8 +154,7 @@ e_thumb_icon_size_set(Evas_Object *obj, int w, int h)
 E_API void
 e_thumb_icon_begin(Evas_Object *obj)
 {
-   E_Thumb *eth, *eth2;
-   char buf[4096];
+   E_Thumb *eth;
 
    eth = evas_object_data_get(obj, "e_thumbdata");
    if (!eth) return;
@@ -131,41 +162,11 @@ e_thumb_icon_begin(Evas_Object *obj)
    if (eth->busy) return;
    if (eth->done) return;
    if (!eth->file) return;
-   if (!_thumbnailers)
-     {
-        while ((int)eina_list_count(_thumbnailers_exe) < _num_thumbnailers)
-          {
-             Ecore_Exe *exe;
-
-             snprintf(buf, sizeof(buf), "%s/enlightenment/utils/enlightenment_thumb --nice=%d", e_prefix_lib_get(),
-                      e_config->thumb_nice);
-             exe = e_util_exe_safe_run(buf, NULL);
-             _thumbnailers_exe = eina_list_append(_thumbnailers_exe, exe);
-          }
-        _thumb_queue = eina_list_append(_thumb_queue, eth);
-        eth->queued = 1;
-        return;
-     }
-   EINA_LIST_FREE(_thumb_queue, eth2)
-     {
-        eth2->queued = 0;
-        eth2->busy = 1;
-        _pending++;
-        if (_pending == 1) _e_thumb_thumbnailers_kill_cancel();
-        _e_thumb_gen_begin(eth2->objid, eth2->file, eth2->key,
-                           eth2->w, eth2->h,
-                           eth2->desk_pan.x, eth2->desk_pan.y,
-                           eth2->desk_pan.x_count, eth2->desk_pan.y_count,
-                           eth2->sigsrc);
-     }
-   eth->busy = 1;
    _pending++;
    if (_pending == 1) _e_thumb_thumbnailers_kill_cancel();
-   _e_thumb_gen_begin(eth->objid, eth->file, eth->key,
-                      eth->w, eth->h,
-                      eth->desk_pan.x, eth->desk_pan.y,
-                      eth->desk_pan.x_count, eth->desk_pan.y_count,
-                      eth->sigsrc);
+   _e_thumb_queue_add(eth);
+   _e_thumb_thumbnailers_spawn();
+   _e_thumb_dispatch();
 }
 
 E_API void
@@ -175,18 +176,24 @@ e_thumb_icon_end(Evas_Object *obj)
 
    eth = evas_object_data_get(obj, "e_thumbdata");
    if (!eth) return;
-   if (eth->queued)
-     {
-        _thumb_queue = eina_list_remove(_thumb_queue, eth);
-        eth->queued = 0;
-     }
-   if (eth->busy)
-     {
-        _e_thumb_gen_end(eth->objid);
-        eth->busy = 0;
-        _pending--;
-        if (_pending == 0) _e_thumb_thumbnailers_kill();
-     }
+   _e_thumb_cancel(eth);
+}
+
+/* requests with a higher priority are generated first, those of equal
+ * priority in the order they were begun. 0 is the default
+ */
+E_API void
+e_thumb_icon_priority_set(Evas_Object *obj, int priority)
+{
+   E_Thumb *eth;
+
+   eth = evas_object_data_get(obj, "e_thumbdata");
+   if (!eth) return;
+   if (eth->priority == priority) return;
+   eth->priority = priority;
+   if (!eth->queued) return;
+   _thumb_queue = eina_list_remove(_thumb_queue, eth);
+   _e_thumb_queue_add(eth);
 }
 
 E_API void
@@ -262,16 +269,33 @@ e_thumb_sort_id_get(Evas_Object *obj)
    return eth->sort_id;
 }
 
+static E_Thumb_Worker *
+_e_thumb_worker_find(Ecore_Ipc_Client *cli)
+{
+   Eina_List *l;
+   E_Thumb_Worker *tw;
+
+   EINA_LIST_FOREACH(_thumbnailers, l, tw)
+     if (tw->cli == cli) return tw;
+   return NULL;
+}
+
 E_API void
 e_thumb_client_data(Ecore_Ipc_Event_Client_Data *e)
 {
    int objid;
    char *icon;
    E_Thumb *eth;
+   E_Thumb_Worker *tw;
    Evas_Object *obj;
 
-   if (!eina_list_data_find(_thumbnailers, e->client))
-     _thumbnailers = eina_list_prepend(_thumbnailers, e->client);
+   tw = _e_thumb_worker_find(e->client);
+   if (!tw)
+     {
+        tw = E_NEW(E_Thumb_Worker, 1);
+        tw->cli = e->client;
+        _thumbnailers = eina_list_append(_thumbnailers, tw);
+     }
    if (e->minor == 2)
      {
         objid = e->ref;
@@ -282,8 +306,11 @@ e_thumb_client_data(Ecore_Ipc_Event_Client_Data *e)
              if (obj)
                {
                   eth = evas_object_data_get(obj, "e_thumbdata");
-                  if (eth)
+                  /* a reply to a request that was cancelled meanwhile */
+                  if ((eth) && (eth->busy) && (eth->worker == tw))
                     {
+                       tw->busy = eina_list_remove(tw->busy, eth);
+                       eth->worker = NULL;
                        eth->busy = 0;
                        _pending--;
                        eth->done = 1;
@@ -299,43 +326,45 @@ e_thumb_client_data(Ecore_Ipc_Event_Client_Data *e)
                }
           }
      }
-   if (e->minor == 1)
-     {
-        /* hello message */
-        EINA_LIST_FREE(_thumb_queue, eth)
-          {
-             eth->queued = 0;
-             eth->busy = 1;
-             _pending++;
-             if (_pending == 1) _e_thumb_thumbnailers_kill_cancel();
-             _e_thumb_gen_begin(eth->objid, eth->file, eth->key,
-                                eth->w, eth->h,
-                                eth->desk_pan.x, eth->desk_pan.y,
-                                eth->desk_pan.x_count, eth->desk_pan.y_count,
-                                eth->sigsrc);
-          }
-     }
+   /* minor 1 is the hello message; either way this thumbnailer may
+    * have room for more work now */
+   _e_thumb_dispatch();
 }
 
 E_API void
 e_thumb_client_del(Ecore_Ipc_Event_Client_Del *e)
 {
-   if (!eina_list_data_find(_thumbnailers, e->client)) return;
-   _thumbnailers = eina_list_remove(_thumbnailers, e->client);
+   E_Thumb_Worker *tw;
+   E_Thumb *eth;
+
+   tw = _e_thumb_worker_find(e->client);
+   if (!tw) return;
+   _thumbnailers = eina_list_remove(_thumbnailers, tw);
+   /* whatever it was working on is given up: a file that crashed one
+    * thumbnailer would crash the next one too */
+   EINA_LIST_FREE(tw->busy, eth)
+     {
+        eth->busy = 0;
+        eth->worker = NULL;
+        eth->done = 1;
+        _pending--;
+     }
+   free(tw);
    if ((!_thumbs) && (!_thumbnailers)) _objid = 0;
+   if (_pending == 0) _e_thumb_thumbnailers_kill();
+   else _e_thumb_dispatch();
 }
 
 /* local subsystem functions */
 static void
-_e_thumb_gen_begin(int objid, const char *file, const char *key, int w, int h,
-                   int desk_x, int desk_y, int desk_x_count, int desk_y_count,
-                   Eina_List *sigsrc)
+_e_thumb_gen_begin(E_Thumb_Worker *tw, E_Thumb *eth)
 {
    char *buf, *p;
    int l1, l2, size, *desk;
-   Ecore_Ipc_Client *cli;
    Eina_List *l;
    const char *s;
+   const char *file = eth->file, *key = eth->key;
+   Eina_List *sigsrc = eth->sigsrc;
 
    /* send thumb req */
    // figure out buffer size needed
@@ -367,10 +396,10 @@ _e_thumb_gen_begin(int objid, const char *file, const char *key, int w, int h,
    //  [char[]]src2
    //  ...
    desk = (int *)(void *)buf;
-   desk[0] = desk_x;
-   desk[1] = desk_y;
-   desk[2] = desk_x_count;
-   desk[3] = desk_y_count;
+   desk[0] = eth->desk_pan.x;
+   desk[1] = eth->desk_pan.y;
+   desk[2] = eth->desk_pan.x_count;
+   desk[3] = eth->desk_pan.y_count;
    p += (4 * sizeof(int));
    strcpy(p, file);
    p += l1 + 1;
@@ -391,23 +420,114 @@ _e_thumb_gen_begin(int objid, const char *file, const char *key, int w, int h,
      }
 
    // actually send it off
-   cli = eina_list_data_get(_thumbnailers);
-   if (!cli) return;
-   _thumbnailers = eina_list_remove_list(_thumbnailers, _thumbnailers);
-   _thumbnailers = eina_list_append(_thumbnailers, cli);
-   ecore_ipc_client_send(cli, E_IPC_DOMAIN_THUMB, 1, objid, w, h, buf, size);
+   ecore_ipc_client_send(tw->cli, E_IPC_DOMAIN_THUMB, 1, eth->objid,
+                         eth->w, eth->h, buf, size);
 }
 
 static void
-_e_thumb_gen_end(int objid)
+_e_thumb_gen_end(E_Thumb_Worker *tw, int objid)
+{
+   /* send thumb cancel */
+   ecore_ipc_client_send(tw->cli, E_IPC_DOMAIN_THUMB, 2, objid, 0, 0, NULL, 0);
+}
+
+/* insert behind the requests of the same or higher priority */
+static void
+_e_thumb_queue_add(E_Thumb *eth)
 {
    Eina_List *l;
-   Ecore_Ipc_Client *cli;
+   E_Thumb *eth2;
 
-   /* send thumb cancel */
-   EINA_LIST_FOREACH(_thumbnailers, l, cli)
+   eth->queued = 1;
+   EINA_LIST_REVERSE_FOREACH(_thumb_queue, l, eth2)
+     {
+        if (eth2->priority >= eth->priority)
+          {
+             _thumb_queue = eina_list_append_relative_list(_thumb_queue, eth, l);
+             return;
+          }
+     }
+   _thumb_queue = eina_list_prepend(_thumb_queue, eth);
+}
+
+/* hand queued requests to the least loaded thumbnailers with room */
+static void
+_e_thumb_dispatch(void)
+{
+   while (_thumb_queue)
      {
-        ecore_ipc_client_send(cli, E_IPC_DOMAIN_THUMB, 2, objid, 0, 0, NULL, 0);
+        E_Thumb_Worker *tw, *best = NULL;
+        E_Thumb *eth;
+        Eina_List *l;
+        unsigned int n, best_n = THUMB_WORKER_INFLIGHT;
+
+        EINA_LIST_FOREACH(_thumbnailers, l, tw)
+          {
+             n = eina_list_count(tw->busy);
+             if (n < best_n)
+               {
+                  best = tw;
+                  best_n = n;
+               }
+          }
+        if (!best) return;
+        eth = eina_list_data_get(_thumb_queue);
+        _thumb_queue = eina_list_remove_list(_thumb_queue, _thumb_queue);
+        eth->queued = 0;
+        eth->busy = 1;
+        eth->worker = best;
+        best->busy = eina_list_append(best->busy, eth);
+        _e_thumb_gen_begin(best, eth);
+     }
+}
+
+static void
+_e_thumb_cancel(E_Thumb *eth)
+{
+   if (eth->queued)
+     {
+        _thumb_queue = eina_list_remove(_thumb_queue, eth);
+        eth->queued = 0;
+     }
+   else if (eth->busy)
+     {
+        _e_thumb_gen_end(eth->worker, eth->objid);
+        eth->worker->busy = eina_list_remove(eth->worker->busy, eth);
+        eth->worker = NULL;
+        eth->busy = 0;
+     }
+   else return;
+   _pending--;
+   if (_pending == 0) _e_thumb_thumbnailers_kill();
+   else _e_thumb_dispatch();
+}
+
+static int
+_e_thumb_thumbnailers_num(void)
+{
+   int num = e_config->thumb_workers;
+
+   if (num <= 0) num = eina_cpu_count();
+   return MAX(1, MIN(num, THUMB_WORKERS_MAX));
+}
+
+static void
+_e_thumb_thumbnailers_spawn(void)
+{
+   char buf[4096];
+   int num = _e_thumb_thumbnailers_num();
+
+   /* grow the pool with the backlog */
+   num = MIN(num, (int)eina_list_count(_thumb_queue) / THUMB_WORKER_INFLIGHT + 1);
+   while ((int)eina_list_count(_thumbnailers_exe) < num)
+     {
+        Ecore_Exe *exe;
+
+        snprintf(buf, sizeof(buf), "%s/enlightenment/utils/enlightenment_thumb --nice=%d", e_prefix_lib_get(),
+                 e_config->thumb_nice);
+        exe = e_util_exe_safe_run(buf, NULL);
+        if (!exe) break;
+        _thumbnailers_exe = eina_list_append(_thumbnailers_exe, exe);
      }
 }
 
@@ -421,15 +541,7 @@ _e_thumb_del_hook(void *data EINA_UNUSED, Evas *e EINA_UNUSED, Evas_Object *obj,
    if (!eth) return;
    evas_object_data_del(obj, "e_thumbdata");
    _e_thumb_hash_del(eth->objid);
-   if (eth->busy)
-     {
-        _e_thumb_gen_end(eth->objid);
-        eth->busy = 0;
-        _pending--;
-        if (_pending == 0) _e_thumb_thumbnailers_kill();
-     }
-   if (eth->queued)
-     _thumb_queue = eina_list_remove(_thumb_queue, eth);
+   _e_thumb_cancel(eth);
    if (eth->file) eina_stringshare_del(eth->file);
    if (eth->key) eina_stringshare_del(eth->key);
    free(eth->sort_id);
@@ -507,19 +619,7 @@ _e_thumb_cb_exe_event_del(void *data EINA_UNUSED, int type EINA_UNUSED, void *ev
              break;
           }
      }
-   if ((!_thumbnailers_exe) && (_thumb_queue))
-     {
-        while ((int)eina_list_count(_thumbnailers_exe) < _num_thumbnailers)
-          {
-             Ecore_Exe *exe_thumb;
-             char buf[4096];
-
-             snprintf(buf, sizeof(buf), "%s/enlightenment/utils/enlightenment_thumb --nice=%d", e_prefix_lib_get(),
-                      e_config->thumb_nice);
-             exe_thumb = e_util_exe_safe_run(buf, NULL);
-             _thumbnailers_exe = eina_list_append(_thumbnailers_exe, exe_thumb);
-          }
-     }
+   if (_thumb_queue) _e_thumb_thumbnailers_spawn();
    return ECORE_CALLBACK_PASS_ON;
 }
 
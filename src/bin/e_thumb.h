@@ -14,6 +14,7 @@ E_API void                  e_thumb_icon_size_set(Evas_Object *obj, int w, int h
 E_API void                  e_thumb_icon_begin(Evas_Object *obj);
 E_API void                  e_thumb_icon_end(Evas_Object *obj);
 E_API void                  e_thumb_icon_rethumb(Evas_Object *obj);
+E_API void                  e_thumb_icon_priority_set(Evas_Object *obj, int priority);
 E_API void                  e_thumb_desk_pan_set(Evas_Object *obj, int x, int y, int x_count, int y_count);
 E_API void                  e_thumb_signal_add(Evas_Object *obj, const char *sig, const char *src);
 E_API const char           *e_thumb_sort_id_get(Evas_Object *obj);
@@ -55,8 +55,10 @@ static Eina_Bool _e_ipc_cb_server_del(void *data,
 static Eina_Bool _e_ipc_cb_server_data(void *data,
                                        int type,
                                        void *event);
-static Eina_Bool _e_cb_timer(void *data);
+static Eina_Bool _e_cb_idler(void *data);
 static void      _e_thumb_generate(E_Thumb *eth);
+static void      _e_thumb_free(E_Thumb *eth);
+static int       _e_thumb_bench(const char *dir, int w, int h);
 static char     *_e_thumb_file_id(char *file,
                                   char *key,
                                   int desk_x,
@@ -68,7 +70,8 @@ static char     *_e_thumb_file_id(char *file,
 /* local subsystem globals */
 static Ecore_Ipc_Server *_e_ipc_server = NULL;
 static Eina_List *_thumblist = NULL;
-static Ecore_Timer *_timer = NULL;
+static Ecore_Idler *_idler = NULL;
+static Ecore_Evas *_ee = NULL; // canvas shared by all thumbnails
 static char _thumbdir[4096] = "";
 
 /* externally accessible functions */
@@ -76,7 +79,8 @@ int
 main(int argc,
      char **argv)
 {
-   int i;
+   const char *bench = NULL;
+   int i, bench_w = 128, bench_h = 128, ret = 0;
 
    for (i = 1; i < argc; i++)
      {
@@ -100,6 +104,15 @@ main(int argc,
                   if (nice(atoi(val)) < 0) perror("nice");
                }
           }
+        /* thumbnail every file in a directory into a scratch cache and
+         * report the rate, without talking to enlightenment */
+        else if (!strncmp(argv[i], "--bench=", 8))
+          bench = argv[i] + 8;
+        else if (!strncmp(argv[i], "--size=", 7))
+          {
+             if (sscanf(argv[i] + 7, "%ix%i", &bench_w, &bench_h) != 2)
+               bench_w = bench_h = 128;
+          }
      }
 
    ecore_app_no_system_modules();
@@ -113,16 +126,28 @@ main(int argc,
    ecore_ipc_init();
    emotion_init();
 
-   e_user_dir_concat_static(_thumbdir, "fileman/thumbnails");
-   ecore_file_mkpath(_thumbdir);
+   edje_file_cache_set(0);
+   edje_collection_cache_set(0);
 
-   if (_e_ipc_init()) ecore_main_loop_begin();
+   if (bench)
+     ret = _e_thumb_bench(bench, bench_w, bench_h);
+   else
+     {
+        e_user_dir_concat_static(_thumbdir, "fileman/thumbnails");
+        ecore_file_mkpath(_thumbdir);
+
+        if (_e_ipc_init()) ecore_main_loop_begin();
+     }
 
    if (_e_ipc_server)
      {
         ecore_ipc_server_del(_e_ipc_server);
         _e_ipc_server = NULL;
      }
+   if (_idler) ecore_idler_del(_idler);
+   _idler = NULL;
+   if (_ee) ecore_evas_free(_ee);
+   _ee = NULL;
 
    emotion_shutdown();
    ecore_ipc_shutdown();
@@ -133,7 +158,7 @@ main(int argc,
    eet_shutdown();
    ecore_shutdown();
 
-   return 0;
+   return ret;
 }
 
 /* local subsystem functions */
@@ -240,7 +265,7 @@ _e_ipc_cb_server_data(void *data EINA_UNUSED,
                   eth->sigsrc = sigsrc;
                   if (key) eth->key = strdup(key);
                   _thumblist = eina_list_append(_thumblist, eth);
-                  if (!_timer) _timer = ecore_timer_loop_add(0.001, _e_cb_timer, NULL);
+                  if (!_idler) _idler = ecore_idler_add(_e_cb_idler, NULL);
                }
           }
         break;
@@ -252,9 +277,7 @@ _e_ipc_cb_server_data(void *data EINA_UNUSED,
              if (eth->objid == e->ref)
                {
                   _thumblist = eina_list_remove_list(_thumblist, l);
-                  free(eth->file);
-                  free(eth->key);
-                  free(eth);
+                  _e_thumb_free(eth);
                   break;
                }
           }
@@ -271,35 +294,80 @@ _e_ipc_cb_server_data(void *data EINA_UNUSED,
    return ECORE_CALLBACK_PASS_ON;
 }
 
+static void
+_e_thumb_free(E_Thumb *eth)
+{
+   const char *s;
+
+   EINA_LIST_FREE(eth->sigsrc, s) eina_stringshare_del(s);
+   free(eth->file);
+   free(eth->key);
+   free(eth);
+}
+
+/* one thumb per idle so cancels arriving meanwhile are seen */
 static Eina_Bool
-_e_cb_timer(void *data EINA_UNUSED)
+_e_cb_idler(void *data EINA_UNUSED)
 {
    E_Thumb *eth;
-   /*
-      Eina_List *del_list = NULL, *l;
-    */
 
    /* take thumb at head of list */
    if (_thumblist)
      {
-        const char *s;
-
         eth = eina_list_data_get(_thumblist);
         _thumblist = eina_list_remove_list(_thumblist, _thumblist);
         _e_thumb_generate(eth);
-        EINA_LIST_FREE(eth->sigsrc, s) eina_stringshare_del(s);
-        free(eth->file);
-        free(eth->key);
-        free(eth);
-
-        if (_thumblist) _timer = ecore_timer_loop_add(0.01, _e_cb_timer, NULL);
-        else _timer = NULL;
+        _e_thumb_free(eth);
      }
-   else
-     _timer = NULL;
+   if (_thumblist) return ECORE_CALLBACK_RENEW;
+   _idler = NULL;
    return ECORE_CALLBACK_CANCEL;
 }
 
+static int
+_e_thumb_bench(const char *dir, int w, int h)
+{
+   Eina_Iterator *it;
+   const Eina_File_Direct_Info *info;
+   E_Thumb *eth;
+   char tmp[] = "/tmp/enlightenment_thumb_bench-XXXXXX";
+   double t0, t;
+   int count = 0;
+
+   if (!mkdtemp(tmp))
+     {
+        perror("mkdtemp");
+        return 1;
+     }
+   eina_strlcpy(_thumbdir, tmp, sizeof(_thumbdir));
+   it = eina_file_stat_ls(dir);
+   if (!it)
+     {
+        fprintf(stderr, "cannot list %s\n", dir);
+        ecore_file_recursive_rm(tmp);
+        return 1;
+     }
+   t0 = ecore_time_get();
+   EINA_ITERATOR_FOREACH(it, info)
+     {
+        if (info->type != EINA_FILE_REG) continue;
+        eth = calloc(1, sizeof(E_Thumb));
+        if (!eth) break;
+        eth->objid = count++;
+        eth->w = w;
+        eth->h = h;
+        eth->file = strdup(info->path);
+        _e_thumb_generate(eth);
+        _e_thumb_free(eth);
+     }
+   eina_iterator_free(it);
+   t = ecore_time_get() - t0;
+   printf("%i files at %ix%i in %1.3fs (%1.1f/s)\n", count, w, h, t,
+          (t > 0.0) ? count / t : 0.0);
+   ecore_file_recursive_rm(tmp);
+   return 0;
+}
+
 typedef struct _Color Color;
 
 struct _Color
@@ -353,12 +421,17 @@ _e_thumb_generate(E_Thumb *eth)
 
         ecore_file_mkdir(dbuf);
 
-        edje_file_cache_set(0);
-        edje_collection_cache_set(0);
-        ee = ecore_evas_buffer_new(1, 1);
+        /* sources are rarely loaded twice, so caches stay off, but the
+         * canvas and its engine are set up only once */
+        if (!_ee)
+          {
+             _ee = ecore_evas_buffer_new(1, 1);
+             if (!_ee) break;
+             evas_image_cache_set(ecore_evas_get(_ee), 0);
+             evas_font_cache_set(ecore_evas_get(_ee), 0);
+          }
+        ee = _ee;
         evas = ecore_evas_get(ee);
-        evas_image_cache_set(evas, 0);
-        evas_font_cache_set(evas, 0);
         ww = 0;
         hh = 0;
         alpha = 1;
@@ -682,12 +755,12 @@ end:
         else if (im) evas_object_del(im);
         if (im2) evas_object_del(im2);
         if (bg) evas_object_del(bg);
-        ecore_evas_free(ee);
         eet_clearcache();
         break;
      }
    /* send back path to thumb */
-   ecore_ipc_server_send(_e_ipc_server, 5, 2, eth->objid, 0, 0, buf, strlen(buf) + 1);
+   if (_e_ipc_server)
+     ecore_ipc_server_send(_e_ipc_server, 5, 2, eth->objid, 0, 0, buf, strlen(buf) + 1);
 }
 
 static char *
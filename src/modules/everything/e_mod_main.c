@@ -117,6 +117,10 @@ e_modapi_init(E_Module *m)
    SET(history_types_get);
    SET(history_item_usage_set);
    SET(event_handler_add);
+   SET(fuzzy_new);
+   SET(fuzzy_free);
+   SET(fuzzy_query);
+   SET(fuzzy_next);
 #undef SET
 
    evry_history_init();
@@ -144,6 +148,10 @@ e_modapi_init(E_Module *m)
    /* cleanup every hour :) */
    cleanup_timer = ecore_timer_loop_add(3600, _cleanup_history, NULL);
 
+#ifdef EVRY_FUZZY_BENCH
+   evry_fuzzy_bench();
+#endif
+
    return m;
 }
 
@@ -230,6 +230,13 @@ void  evry_clear_input(Evry_Plugin *p);
 Evas_Object *evry_icon_theme_get(const char *icon, Evas *e);
 int   evry_fuzzy_match(const char *str, const char *match);
 Eina_List *evry_fuzzy_match_sort(Eina_List *items);
+Evry_Fuzzy *evry_fuzzy_new(void);
+void  evry_fuzzy_free(Evry_Fuzzy *fz);
+void  evry_fuzzy_query(Evry_Fuzzy *fz, Eina_List *items, const char *input);
+Evry_Item *evry_fuzzy_next(Evry_Fuzzy *fz);
+#ifdef EVRY_FUZZY_BENCH
+void  evry_fuzzy_bench(void);
+#endif
 int   evry_util_exec_app(const Evry_Item *it_app, const Evry_Item *it_file);
 char *evry_util_url_escape(const char *string, int inlength);
 char *evry_util_url_unescape(const char *string, int length);
@@ -1328,6 +1328,8 @@ _evry_selector_thumb(Evry_Selector *sel, const Evry_Item *it)
         else
           e_thumb_icon_file_set(sel->o_thumb, file->path, NULL);
 
+        /* the selection preview goes before thumbs in the item list */
+        e_thumb_icon_priority_set(sel->o_thumb, 1);
         e_thumb_icon_begin(sel->o_thumb);
         sel->do_thumb = EINA_TRUE;
         return 1;
@@ -3,7 +3,7 @@
 
 #include "evry_types.h"
 
-#define EVRY_API_VERSION     31
+#define EVRY_API_VERSION     32
 
 #define EVRY_ACTION_OTHER    0
 #define EVRY_ACTION_FINISHED 1
@@ -120,6 +120,12 @@ struct _Evry_API
   int  (*history_item_usage_set)(Evry_Item *it, const char *input, const char *ctxt);
 
   Ecore_Event_Handler *(*event_handler_add)(int type, Eina_Bool (*func) (void *data, int type, void *event), const void *data);
+
+  /* incremental fuzzy matching of a list of items, see evry_util.c */
+  Evry_Fuzzy *(*fuzzy_new)(void);
+  void        (*fuzzy_free)(Evry_Fuzzy *fz);
+  void        (*fuzzy_query)(Evry_Fuzzy *fz, Eina_List *items, const char *input);
+  Evry_Item  *(*fuzzy_next)(Evry_Fuzzy *fz);
 };
 
 struct _Evry_Event_Item_Changed
@@ -32,6 +32,7 @@ struct _Plugin
    Eina_List     *apps_all;
    Eina_List     *apps_hist;
    Eina_List     *menu_items;
+   Evry_Fuzzy    *fuzzy;
 
    Eina_Hash     *added;
    Efreet_Menu   *menu;
@@ -601,6 +602,9 @@ _finish(Evry_Plugin *plugin)
    EINA_LIST_FREE (p->apps_mime, desktop)
      efreet_desktop_free(desktop);
 
+   if (p->fuzzy)
+     evry->fuzzy_free(p->fuzzy);
+
    EINA_LIST_FREE (p->menu_items, it)
      EVRY_ITEM_FREE(it);
 
@@ -670,15 +674,16 @@ _fetch(Evry_Plugin *plugin, const char *input)
           }
      }
 
-   EINA_LIST_FOREACH (p->menu_items, l, it)
+   if (!input)
      {
-        if (!input)
-          {
-             EVRY_PLUGIN_ITEM_APPEND(p, it);
-             continue;
-          }
-
-        if ((it->fuzzy_match = evry->fuzzy_match(it->label, input)))
+        EINA_LIST_FOREACH (p->menu_items, l, it)
+          EVRY_PLUGIN_ITEM_APPEND(p, it);
+     }
+   else if (p->menu_items)
+     {
+        if (!p->fuzzy) p->fuzzy = evry->fuzzy_new();
+        evry->fuzzy_query(p->fuzzy, p->menu_items, input);
+        while ((it = evry->fuzzy_next(p->fuzzy)))
           EVRY_PLUGIN_ITEM_APPEND(p, it);
      }
 
@@ -58,6 +58,7 @@ struct _Plugin
 
    Ecore_Thread       *thread;
    Ecore_File_Monitor *dir_mon;
+   Evry_Fuzzy         *fuzzy;
    int                 waiting_to_finish;
 };
 
@@ -219,7 +220,6 @@ _scan_mime_func(void *data, Ecore_Thread *thread)
 static int
 _files_filter(Plugin *p)
 {
-   int match;
    int cnt = 0;
    Evry_Item *it;
    Eina_List *l;
@@ -235,28 +235,36 @@ _files_filter(Plugin *p)
           return 0;
      }
 
-   EINA_LIST_FOREACH (p->files, l, it)
+   if (len)
      {
-        if (cnt >= MAX_SHOWN) break;
-
-        if (p->dirs_only && !it->browseable)
-          continue;
-
-        if (len && (match = evry->fuzzy_match(it->label, p->input)))
-          {
-             it->fuzzy_match = match;
-             if (!it->browseable)
-               it->priority = 1;
-             EVRY_PLUGIN_ITEM_APPEND(p, it);
-             cnt++;
-          }
-        else if (len == 0)
+        /* keeps the matches of the last input, so typing on only
+         * looks at those again */
+        if (!p->fuzzy) p->fuzzy = evry->fuzzy_new();
+        evry->fuzzy_query(p->fuzzy, p->files, p->input);
+        while ((cnt < MAX_SHOWN) && (it = evry->fuzzy_next(p->fuzzy)))
           {
+             if (p->dirs_only && !it->browseable)
+               continue;
+
              if (!it->browseable)
                it->priority = 1;
              EVRY_PLUGIN_ITEM_APPEND(p, it);
              cnt++;
           }
+        return cnt;
+     }
+
+   EINA_LIST_FOREACH (p->files, l, it)
+     {
+        if (cnt >= MAX_SHOWN) break;
+
+        if (p->dirs_only && !it->browseable)
+          continue;
+
+        if (!it->browseable)
+          it->priority = 1;
+        EVRY_PLUGIN_ITEM_APPEND(p, it);
+        cnt++;
      }
    return cnt;
 }
@@ -618,6 +626,10 @@ _free_files(Plugin *p)
    EINA_LIST_FREE (p->files, file)
      EVRY_ITEM_FREE(file);
 
+   if (p->fuzzy)
+     evry->fuzzy_free(p->fuzzy);
+   p->fuzzy = NULL;
+
    if (p->dir_mon)
      ecore_file_monitor_del(p->dir_mon);
    p->dir_mon = NULL;
@@ -12,6 +12,7 @@ typedef struct _History_Entry		History_Entry;
 typedef struct _History_Types		History_Types;
 typedef struct _Evry_State	        Evry_State;
 typedef struct _Evry_View	        Evry_View;
+typedef struct _Evry_Fuzzy	        Evry_Fuzzy;
 
 typedef unsigned int Evry_Type;
 
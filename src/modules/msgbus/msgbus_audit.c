@@ -25,8 +25,57 @@ cb_audit_timer_dump(const Eldbus_Service_Interface *iface EINA_UNUSED,
    return reply;
 }
 
+static Eldbus_Message *
+cb_audit_comp_profiler_enable(const Eldbus_Service_Interface *iface EINA_UNUSED,
+                              const Eldbus_Message *msg)
+{
+   Eldbus_Message *reply = eldbus_message_method_return_new(msg);
+   Eina_Bool enable;
+
+   if (!eldbus_message_arguments_get(msg, "b", &enable))
+     {
+        ERR("could not get CompProfilerEnable arguments");
+        return reply;
+     }
+   e_comp_profiler_enabled_set(enable);
+   return reply;
+}
+
+static Eldbus_Message *
+cb_audit_comp_profiler_dump(const Eldbus_Service_Interface *iface EINA_UNUSED,
+                            const Eldbus_Message *msg)
+{
+   Eldbus_Message *reply = eldbus_message_method_return_new(msg);
+   char *file;
+
+   if (!eldbus_message_arguments_get(msg, "s", &file))
+     {
+        ERR("could not get CompProfilerDump arguments");
+        eldbus_message_arguments_append(reply, "b", EINA_FALSE);
+        return reply;
+     }
+   eldbus_message_arguments_append(reply, "b", e_comp_profiler_dump(file));
+   return reply;
+}
+
+static Eldbus_Message *
+cb_audit_comp_profiler_summary(const Eldbus_Service_Interface *iface EINA_UNUSED,
+                               const Eldbus_Message *msg)
+{
+   Eldbus_Message *reply = eldbus_message_method_return_new(msg);
+   char *tmp;
+
+   tmp = e_comp_profiler_summary_get();
+   eldbus_message_arguments_append(reply, "s", tmp ?: "");
+   free(tmp);
+   return reply;
+}
+
 static const Eldbus_Method methods[] = {
    { "Timers", NULL, ELDBUS_ARGS({"s", ""}), cb_audit_timer_dump, 0 },
+   { "CompProfilerEnable", ELDBUS_ARGS({"b", "enable"}), NULL, cb_audit_comp_profiler_enable, 0 },
+   { "CompProfilerDump", ELDBUS_ARGS({"s", "file"}), ELDBUS_ARGS({"b", "written"}), cb_audit_comp_profiler_dump, 0 },
+   { "CompProfilerSummary", NULL, ELDBUS_ARGS({"s", "summary"}), cb_audit_comp_profiler_summary, 0 },
    { NULL, NULL, NULL, NULL, 0 }
 };
 
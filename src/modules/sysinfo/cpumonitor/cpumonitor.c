@@ -4,13 +4,11 @@ typedef struct _Thread_Config Thread_Config;
 
 struct _Thread_Config
 {
-   int                  interval;
    int                  num_cores;
    int                  percent;
    unsigned long        total;
    unsigned long        idle;
    Instance            *inst;
-   E_Powersave_Sleeper *sleeper;
    Eina_List           *cores;
 };
 
@@ -149,28 +147,19 @@ _cpumonitor_resize_cb(void *data, Evas *e EINA_UNUSED, Evas_Object *obj, void *e
 }
 
 static void
-_cpumonitor_cb_usage_check_main(void *data, Ecore_Thread *th)
+_cpumonitor_cb_usage_check_sample(void *data, const Sysinfo_Sample *s EINA_UNUSED)
 {
    Thread_Config *thc = data;
-   for (;; )
-     {
-        if (ecore_thread_check(th)) break;
+
 #if defined(__FreeBSD__) || defined(__DragonFly__) || defined(__OpenBSD__)
-        _cpumonitor_sysctl_getusage(&thc->total, &thc->idle, &thc->percent, thc->cores);
+   _cpumonitor_sysctl_getusage(&thc->total, &thc->idle, &thc->percent, thc->cores);
 #else
-        _cpumonitor_proc_getusage(&thc->total, &thc->idle, &thc->percent, thc->cores);
+   _cpumonitor_proc_getusage(s, &thc->total, &thc->idle, &thc->percent, thc->cores);
 #endif
-        ecore_thread_feedback(th, NULL);
-        if (ecore_thread_check(th)) break;
-        e_powersave_sleeper_sleep(thc->sleeper, thc->interval);
-        if (ecore_thread_check(th)) break;
-     }
 }
 
 static void
-_cpumonitor_cb_usage_check_notify(void *data,
-                                  Ecore_Thread *th EINA_UNUSED,
-                                  void *msg EINA_UNUSED)
+_cpumonitor_cb_usage_check_notify(void *data)
 {
    Thread_Config *thc = data;
 
@@ -181,12 +170,11 @@ _cpumonitor_cb_usage_check_notify(void *data,
 }
 
 static void
-_cpumonitor_cb_usage_check_end(void *data, Ecore_Thread *th EINA_UNUSED)
+_cpumonitor_cb_usage_check_end(void *data)
 {
    Thread_Config *thc = data;
    CPU_Core *core;
 
-   e_powersave_sleeper_free(thc->sleeper);
    EINA_LIST_FREE(thc->cores, core)
      E_FREE(core);
    E_FREE(thc);
@@ -225,11 +213,10 @@ _screensaver_on(void *data)
 {
    Instance *inst = data;
 
-   if (!ecore_thread_check(inst->cfg->cpumonitor.usage_check_thread))
+   if (inst->cfg->cpumonitor.usage_check)
      {
         _cpumonitor_del_layouts(inst);
-        ecore_thread_cancel(inst->cfg->cpumonitor.usage_check_thread);
-        inst->cfg->cpumonitor.usage_check_thread = NULL;
+        E_FREE_FUNC(inst->cfg->cpumonitor.usage_check, sysinfo_sampler_del);
      }
    return ECORE_CALLBACK_RENEW;
 }
@@ -282,11 +269,10 @@ _cpumonitor_config_updated(Instance *inst)
           }
         return;
      }
-   if (!ecore_thread_check(inst->cfg->cpumonitor.usage_check_thread))
+   if (inst->cfg->cpumonitor.usage_check)
      {
         _cpumonitor_del_layouts(inst);
-        ecore_thread_cancel(inst->cfg->cpumonitor.usage_check_thread);
-        inst->cfg->cpumonitor.usage_check_thread = NULL;
+        E_FREE_FUNC(inst->cfg->cpumonitor.usage_check, sysinfo_sampler_del);
      }
    thc = E_NEW(Thread_Config, 1);
    if (thc)
@@ -295,8 +281,6 @@ _cpumonitor_config_updated(Instance *inst)
         thc->total = 0;
         thc->idle = 0;
         thc->percent = 0;
-        thc->interval = inst->cfg->cpumonitor.poll_interval;
-        thc->sleeper = e_powersave_sleeper_new();
 #if defined(__FreeBSD__) || defined(__DragonFly__) || defined(__OpenBSD__)
         thc->num_cores = _cpumonitor_sysctl_getcores();
 #else
@@ -314,11 +298,14 @@ _cpumonitor_config_updated(Instance *inst)
              core->idle = 0;
              thc->cores = eina_list_append(thc->cores, core);
           }
-        inst->cfg->cpumonitor.usage_check_thread =
-          ecore_thread_feedback_run(_cpumonitor_cb_usage_check_main,
-                                    _cpumonitor_cb_usage_check_notify,
-                                    _cpumonitor_cb_usage_check_end,
-                                    _cpumonitor_cb_usage_check_end, thc, EINA_TRUE);
+        inst->cfg->cpumonitor.usage_check =
+          sysinfo_sampler_add(SYSINFO_SAMPLE_CPU,
+                              inst->cfg->cpumonitor.poll_interval,
+                              _cpumonitor_cb_usage_check_sample,
+                              _cpumonitor_cb_usage_check_notify,
+                              _cpumonitor_cb_usage_check_end, thc);
+        if (!inst->cfg->cpumonitor.usage_check)
+          _cpumonitor_cb_usage_check_end(thc);
      }
    e_config_save_queue();
 }
@@ -340,11 +327,10 @@ _cpumonitor_removed_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_dat
    evas_object_smart_callback_del_full(e_gadget_site_get(inst->o_main), "gadget_removed",
                                        _cpumonitor_removed_cb, inst);
    evas_object_event_callback_del_full(inst->o_main, EVAS_CALLBACK_DEL, sysinfo_cpumonitor_remove, data);
-   if (!ecore_thread_check(inst->cfg->cpumonitor.usage_check_thread))
+   if (inst->cfg->cpumonitor.usage_check)
      {
         _cpumonitor_del_layouts(inst);
-        ecore_thread_cancel(inst->cfg->cpumonitor.usage_check_thread);
-        inst->cfg->cpumonitor.usage_check_thread = NULL;
+        E_FREE_FUNC(inst->cfg->cpumonitor.usage_check, sysinfo_sampler_del);
      }
    sysinfo_config->items = eina_list_remove(sysinfo_config->items, inst->cfg);
    if (inst->cfg->id >= 0)
@@ -365,11 +351,10 @@ sysinfo_cpumonitor_remove(void *data, Evas *e EINA_UNUSED, Evas_Object *obj EINA
      E_FREE_FUNC(inst->cfg->cpumonitor.configure, evas_object_del);
    EINA_LIST_FREE(inst->cfg->cpumonitor.handlers, handler)
      ecore_event_handler_del(handler);
-   if (!ecore_thread_check(inst->cfg->cpumonitor.usage_check_thread))
+   if (inst->cfg->cpumonitor.usage_check)
      {
         _cpumonitor_del_layouts(inst);
-        ecore_thread_cancel(inst->cfg->cpumonitor.usage_check_thread);
-        inst->cfg->cpumonitor.usage_check_thread = NULL;
+        E_FREE_FUNC(inst->cfg->cpumonitor.usage_check, sysinfo_sampler_del);
      }
 }
 
@@ -5,7 +5,7 @@
 
 EINTERN void _cpumonitor_config_updated(Instance *inst);
 EINTERN int _cpumonitor_proc_getcores(void);
-EINTERN void _cpumonitor_proc_getusage(unsigned long *prev_total, unsigned long *prev_idle, int *prev_precent, Eina_List *cores);
+EINTERN void _cpumonitor_proc_getusage(const Sysinfo_Sample *s, unsigned long *prev_total, unsigned long *prev_idle, int *prev_precent, Eina_List *cores);
 EINTERN int _cpumonitor_sysctl_getcores(void);
 EINTERN void _cpumonitor_sysctl_getusage(unsigned long *prev_total, unsigned long *prev_idle, int *prev_precent, Eina_List *cores);
 EINTERN Evas_Object *cpumonitor_configure(Instance *inst);
@@ -27,88 +27,43 @@ _cpumonitor_proc_getcores(void)
    return cores;
 }
 
+static int
+_cpumonitor_proc_percent(const Sysinfo_Sample_Cpu *cpu, unsigned long prev_total, unsigned long prev_idle)
+{
+   unsigned long total_change, idle_change;
+   int percent = 0;
+
+   total_change = cpu->total - prev_total;
+   idle_change = cpu->idle - prev_idle;
+   if (total_change != 0)
+     percent = 100 * (1 - ((float)idle_change / (float)total_change));
+   if (percent > 100) percent = 100;
+   else if (percent < 0)
+     percent = 0;
+   return percent;
+}
+
 void
-_cpumonitor_proc_getusage(unsigned long *prev_total,
+_cpumonitor_proc_getusage(const Sysinfo_Sample *s,
+                          unsigned long *prev_total,
                           unsigned long *prev_idle,
                           int *prev_percent,
                           Eina_List *cores)
 {
-   int k = 0, j = 0;
-   char buf[4096];
-   FILE *f;
+   Eina_List *l;
    CPU_Core *core;
+   int j = 1;
 
-   f = fopen("/proc/stat", "r");
-   if (f)
+   if (!s->cpu) return;
+   *prev_percent = _cpumonitor_proc_percent(&(s->cpu[0]), *prev_total, *prev_idle);
+   *prev_total = s->cpu[0].total;
+   *prev_idle = s->cpu[0].idle;
+   EINA_LIST_FOREACH(cores, l, core)
      {
-        while (fgets(buf, sizeof(buf), f))
-          {
-             if (k == 0)
-               {
-                  unsigned long total = 0, idle = 0, use = 0, total_change = 0, idle_change = 0;
-                  int percent = 0;
-                  char *line, *tok;
-                  int i = 0;
-
-                  line = strchr(buf, ' ') + 1;
-                  tok = strtok(line, " ");
-                  while (tok)
-                    {
-                       use = atol(tok);
-                       total += use;
-                       i++;
-                       if (i == 4)
-                         idle = use;
-                       tok = strtok(NULL, " ");
-                    }
-                  total_change = total - *prev_total;
-                  idle_change = idle - *prev_idle;
-                  if (total_change != 0)
-                    percent = 100 * (1 - ((float)idle_change / (float)total_change));
-                  if (percent > 100) percent = 100;
-                  else if (percent < 0)
-                    percent = 0;
-                  *prev_total = total;
-                  *prev_idle = idle;
-                  *prev_percent = percent;
-               }
-             if (k > 0)
-               {
-                  unsigned long total = 0, idle = 0, use = 0, total_change = 0, idle_change = 0;
-                  int percent = 0;
-                  if (!strncmp(buf, "cpu", 3))
-                    {
-                       char *line, *tok;
-                       int i = 0;
-                       line = strchr(buf, ' ');
-                       tok = strtok(line, " ");
-                       while (tok)
-                         {
-                            use = atol(tok);
-                            total += use;
-                            i++;
-                            if (i == 4)
-                              idle = use;
-                            tok = strtok(NULL, " ");
-                         }
-                    }
-                  else break;
-                  core = eina_list_nth(cores, j);
-                  total_change = total - core->total;
-                  idle_change = idle - core->idle;
-                  if (total_change != 0)
-                    percent = 100 * (1 - ((float)idle_change / (float)total_change));
-                  if (percent > 100) percent = 100;
-                  else if (percent < 0)
-                    percent = 0;
-                  core->percent = percent;
-                  core->total = total;
-                  core->idle = idle;
-                  j++;
-               }
-             k++;
-          }
-        fclose(f);
+        if (j > s->cpu_count) break;
+        core->percent = _cpumonitor_proc_percent(&(s->cpu[j]), core->total, core->idle);
+        core->total = s->cpu[j].total;
+        core->idle = s->cpu[j].idle;
+        j++;
      }
 }
-
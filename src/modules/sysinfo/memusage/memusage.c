@@ -4,7 +4,6 @@ typedef struct _Thread_Config Thread_Config;
 
 struct _Thread_Config
 {
-   int                  interval;
    Instance            *inst;
    int                  mem_percent;
    int                  swp_percent;
@@ -15,7 +14,6 @@ struct _Thread_Config
    unsigned long        mem_shared;
    unsigned long        swp_total;
    unsigned long        swp_used;
-   E_Powersave_Sleeper *sleeper;
 };
 
 static void
@@ -274,45 +272,34 @@ _memusage_resize_cb(void *data, Evas *e EINA_UNUSED, Evas_Object *obj EINA_UNUSE
 }
 
 static void
-_memusage_cb_usage_check_main(void *data, Ecore_Thread *th)
+_memusage_cb_usage_check_sample(void *data, const Sysinfo_Sample *s EINA_UNUSED)
 {
    Thread_Config *thc = data;
-   for (;; )
-     {
-        if (ecore_thread_check(th)) break;
+
 #if defined(__OpenBSD__) || defined(__FreeBSD__) || defined(__DragonFly__)
-        _memusage_sysctl_getusage(&thc->mem_total, &thc->mem_used,
-                                  &thc->mem_cached, &thc->mem_buffers, &thc->mem_shared,
-                                  &thc->swp_total, &thc->swp_used);
+   _memusage_sysctl_getusage(&thc->mem_total, &thc->mem_used,
+                             &thc->mem_cached, &thc->mem_buffers, &thc->mem_shared,
+                             &thc->swp_total, &thc->swp_used);
 #else
-        _memusage_proc_getusage(&thc->mem_total, &thc->mem_used,
-                                &thc->mem_cached, &thc->mem_buffers, &thc->mem_shared,
-                                &thc->swp_total, &thc->swp_used);
+   _memusage_proc_getusage(s, &thc->mem_total, &thc->mem_used,
+                           &thc->mem_cached, &thc->mem_buffers, &thc->mem_shared,
+                           &thc->swp_total, &thc->swp_used);
 #endif
-        if (thc->mem_total > 0)
-          thc->mem_percent = 100 * ((float)thc->mem_used / (float)thc->mem_total);
-        if (thc->swp_total > 0)
-          thc->swp_percent = 100 * ((float)thc->swp_used / (float)thc->swp_total);
-
-        ecore_thread_feedback(th, NULL);
-        if (ecore_thread_check(th)) break;
-        e_powersave_sleeper_sleep(thc->sleeper, thc->interval);
-        if (ecore_thread_check(th)) break;
-     }
+   if (thc->mem_total > 0)
+     thc->mem_percent = 100 * ((float)thc->mem_used / (float)thc->mem_total);
+   if (thc->swp_total > 0)
+     thc->swp_percent = 100 * ((float)thc->swp_used / (float)thc->swp_total);
 }
 
 static void
-_memusage_cb_usage_check_end(void *data, Ecore_Thread *th EINA_UNUSED)
+_memusage_cb_usage_check_end(void *data)
 {
    Thread_Config *thc = data;
-   e_powersave_sleeper_free(thc->sleeper);
    E_FREE(thc);
 }
 
 static void
-_memusage_cb_usage_check_notify(void *data,
-                                Ecore_Thread *th EINA_UNUSED,
-                                void *msg EINA_UNUSED)
+_memusage_cb_usage_check_notify(void *data)
 {
    Thread_Config *thc = data;
 
@@ -337,11 +324,8 @@ _screensaver_on(void *data)
 {
    Instance *inst = data;
 
-   if (inst->cfg->memusage.usage_check_thread)
-     {
-        ecore_thread_cancel(inst->cfg->memusage.usage_check_thread);
-        inst->cfg->memusage.usage_check_thread = NULL;
-     }
+   if (inst->cfg->memusage.usage_check)
+     E_FREE_FUNC(inst->cfg->memusage.usage_check, sysinfo_sampler_del);
    return ECORE_CALLBACK_RENEW;
 }
 
@@ -367,24 +351,22 @@ _memusage_config_updated(Instance *inst)
         _memusage_face_update(inst);
         return;
      }
-   if (inst->cfg->memusage.usage_check_thread)
-     {
-        ecore_thread_cancel(inst->cfg->memusage.usage_check_thread);
-        inst->cfg->memusage.usage_check_thread = NULL;
-     }
+   if (inst->cfg->memusage.usage_check)
+     E_FREE_FUNC(inst->cfg->memusage.usage_check, sysinfo_sampler_del);
    thc = E_NEW(Thread_Config, 1);
    if (thc)
      {
         thc->inst = inst;
-        thc->sleeper = e_powersave_sleeper_new();
-        thc->interval = inst->cfg->memusage.poll_interval;
         thc->mem_percent = 0;
         thc->swp_percent = 0;
-        inst->cfg->memusage.usage_check_thread =
-          ecore_thread_feedback_run(_memusage_cb_usage_check_main,
-                                    _memusage_cb_usage_check_notify,
-                                    _memusage_cb_usage_check_end,
-                                    _memusage_cb_usage_check_end, thc, EINA_TRUE);
+        inst->cfg->memusage.usage_check =
+          sysinfo_sampler_add(SYSINFO_SAMPLE_MEM,
+                              inst->cfg->memusage.poll_interval,
+                              _memusage_cb_usage_check_sample,
+                              _memusage_cb_usage_check_notify,
+                              _memusage_cb_usage_check_end, thc);
+        if (!inst->cfg->memusage.usage_check)
+          _memusage_cb_usage_check_end(thc);
      }
    e_config_save_queue();
 }
@@ -407,11 +389,8 @@ _memusage_removed_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_data)
                                        sysinfo_memusage_remove, data);
    EINA_LIST_FREE(inst->cfg->memusage.handlers, handler)
      ecore_event_handler_del(handler);
-   if (inst->cfg->memusage.usage_check_thread)
-     {
-        ecore_thread_cancel(inst->cfg->memusage.usage_check_thread);
-        inst->cfg->memusage.usage_check_thread = NULL;
-     }
+   if (inst->cfg->memusage.usage_check)
+     E_FREE_FUNC(inst->cfg->memusage.usage_check, sysinfo_sampler_del);
    sysinfo_config->items = eina_list_remove(sysinfo_config->items, inst->cfg);
    if (inst->cfg->id >= 0)
      sysinfo_instances = eina_list_remove(sysinfo_instances, inst);
@@ -429,11 +408,8 @@ sysinfo_memusage_remove(void *data, Evas *e EINA_UNUSED, Evas_Object *obj EINA_U
      E_FREE_FUNC(inst->cfg->memusage.popup, evas_object_del);
    if (inst->cfg->memusage.configure)
      E_FREE_FUNC(inst->cfg->memusage.configure, evas_object_del);
-   if (inst->cfg->memusage.usage_check_thread)
-     {
-        ecore_thread_cancel(inst->cfg->memusage.usage_check_thread);
-        inst->cfg->memusage.usage_check_thread = NULL;
-     }
+   if (inst->cfg->memusage.usage_check)
+     E_FREE_FUNC(inst->cfg->memusage.usage_check, sysinfo_sampler_del);
    EINA_LIST_FREE(inst->cfg->memusage.handlers, handler)
      ecore_event_handler_del(handler);
 }
@@ -6,7 +6,8 @@
 EINTERN void _memusage_config_updated(Instance *inst);
 EINTERN Evas_Object *memusage_configure(Instance *inst);
 
-EINTERN void _memusage_proc_getusage(unsigned long *mem_total,
+EINTERN void _memusage_proc_getusage(const Sysinfo_Sample *s,
+                             unsigned long *mem_total,
                              unsigned long *mem_used,
                              unsigned long *mem_cached,
                              unsigned long *mem_buffers,
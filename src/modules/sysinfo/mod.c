@@ -13,6 +13,8 @@ sysinfo_init(void)
    Eina_List *l;
    Config_Item *ci;
 
+   sysinfo_sampler_init();
+
    conf_item_edd = E_CONFIG_DD_NEW("Sysinfo_Config_Item", Config_Item);
 #undef T
 #undef D
@@ -189,6 +191,8 @@ sysinfo_shutdown(void)
    e_gadget_type_del("MemUsage");
    e_gadget_type_del("NetStatus");
    e_gadget_type_del("SysInfo");
+
+   sysinfo_sampler_shutdown();
 }
 
 E_API E_Module_Api e_modapi =
@@ -4,7 +4,6 @@ typedef struct _Thread_Config Thread_Config;
 
 struct _Thread_Config
 {
-   int                  interval;
    Instance            *inst;
    Eina_Bool            automax;
    time_t               checktime;
@@ -18,7 +17,6 @@ struct _Thread_Config
    unsigned long        outcurrent;
    unsigned long        outmax;
    Eina_Stringshare    *outstring;
-   E_Powersave_Sleeper *sleeper;
 };
 
 static void
@@ -182,62 +180,52 @@ _netstatus_resize_cb(void *data, Evas *e EINA_UNUSED, Evas_Object *obj EINA_UNUS
 }
 
 static void
-_netstatus_cb_usage_check_main(void *data, Ecore_Thread *th)
+_netstatus_cb_usage_check_sample(void *data, const Sysinfo_Sample *s EINA_UNUSED)
 {
    Thread_Config *thc = data;
-   for (;; )
-     {
-        char rin[4096], rout[4096];
+   char rin[4096], rout[4096];
 
-        if (ecore_thread_check(th)) break;
 #if defined(__FreeBSD__) || defined(__DragonFly__) || defined(__OpenBSD__)
-        _netstatus_sysctl_getstatus(thc->automax, &thc->checktime, &thc->in, &thc->incurrent,
-            &thc->inmax, &thc->inpercent, &thc->out, &thc->outcurrent, &thc->outmax,
-            &thc->outpercent);
+   _netstatus_sysctl_getstatus(thc->automax, &thc->checktime, &thc->in, &thc->incurrent,
+       &thc->inmax, &thc->inpercent, &thc->out, &thc->outcurrent, &thc->outmax,
+       &thc->outpercent);
 #else
-        _netstatus_proc_getstatus(thc->automax, &thc->checktime, &thc->in, &thc->incurrent,
-            &thc->inmax, &thc->inpercent, &thc->out, &thc->outcurrent, &thc->outmax,
-            &thc->outpercent);
+   _netstatus_proc_getstatus(s, thc->automax, &thc->checktime, &thc->in, &thc->incurrent,
+       &thc->inmax, &thc->inpercent, &thc->out, &thc->outcurrent, &thc->outmax,
+       &thc->outpercent);
 #endif
-        if (!thc->incurrent)
-          {
-             snprintf(rin, sizeof(rin), "0 B/s");
-          }
+   if (!thc->incurrent)
+     {
+        snprintf(rin, sizeof(rin), "0 B/s");
+     }
+   else
+     {
+        if (thc->incurrent > 1048576)
+          snprintf(rin, sizeof(rin), "%.2f MB/s", ((float)thc->incurrent / 1048576));
+        else if ((thc->incurrent > 1024) && (thc->incurrent < 1048576))
+          snprintf(rin, sizeof(rin), "%lu KB/s", (thc->incurrent / 1024));
         else
-          {
-             if (thc->incurrent > 1048576)
-               snprintf(rin, sizeof(rin), "%.2f MB/s", ((float)thc->incurrent / 1048576));
-             else if ((thc->incurrent > 1024) && (thc->incurrent < 1048576))
-               snprintf(rin, sizeof(rin), "%lu KB/s", (thc->incurrent / 1024));
-             else
-               snprintf(rin, sizeof(rin), "%lu B/s", thc->incurrent);
-          }
-        eina_stringshare_replace(&thc->instring, rin);
-        if (!thc->outcurrent)
-          {
-             snprintf(rout, sizeof(rout), "0 B/s");
-          }
+          snprintf(rin, sizeof(rin), "%lu B/s", thc->incurrent);
+     }
+   eina_stringshare_replace(&thc->instring, rin);
+   if (!thc->outcurrent)
+     {
+        snprintf(rout, sizeof(rout), "0 B/s");
+     }
+   else
+     {
+        if (thc->outcurrent > 1048576)
+          snprintf(rout, sizeof(rout), "%.2f MB/s", ((float)thc->outcurrent / 1048576));
+        else if ((thc->outcurrent > 1024) && (thc->outcurrent < 1048576))
+          snprintf(rout, sizeof(rout), "%lu KB/s", (thc->outcurrent / 1024));
         else
-          {
-             if (thc->outcurrent > 1048576)
-               snprintf(rout, sizeof(rout), "%.2f MB/s", ((float)thc->outcurrent / 1048576));
-             else if ((thc->outcurrent > 1024) && (thc->outcurrent < 1048576))
-               snprintf(rout, sizeof(rout), "%lu KB/s", (thc->outcurrent / 1024));
-             else
-               snprintf(rout, sizeof(rout), "%lu B/s", thc->outcurrent);
-          }
-        eina_stringshare_replace(&thc->outstring, rout);
-        ecore_thread_feedback(th, NULL);
-        if (ecore_thread_check(th)) break;
-        e_powersave_sleeper_sleep(thc->sleeper, thc->interval);
-        if (ecore_thread_check(th)) break;
+          snprintf(rout, sizeof(rout), "%lu B/s", thc->outcurrent);
      }
+   eina_stringshare_replace(&thc->outstring, rout);
 }
 
 static void
-_netstatus_cb_usage_check_notify(void *data,
-                                 Ecore_Thread *th EINA_UNUSED,
-                                 void *msg EINA_UNUSED)
+_netstatus_cb_usage_check_notify(void *data)
 {
    Thread_Config *thc = data;
 
@@ -252,10 +240,9 @@ _netstatus_cb_usage_check_notify(void *data,
 }
 
 static void
-_netstatus_cb_usage_check_end(void *data, Ecore_Thread *th EINA_UNUSED)
+_netstatus_cb_usage_check_end(void *data)
 {
    Thread_Config *thc = data;
-   e_powersave_sleeper_free(thc->sleeper);
    E_FREE_FUNC(thc->instring, eina_stringshare_del);
    E_FREE_FUNC(thc->outstring, eina_stringshare_del);
    E_FREE(thc);
@@ -266,11 +253,8 @@ _screensaver_on(void *data)
 {
    Instance *inst = data;
 
-   if (inst->cfg->netstatus.usage_check_thread)
-     {
-        ecore_thread_cancel(inst->cfg->netstatus.usage_check_thread);
-        inst->cfg->netstatus.usage_check_thread = NULL;
-     }
+   if (inst->cfg->netstatus.usage_check)
+     E_FREE_FUNC(inst->cfg->netstatus.usage_check, sysinfo_sampler_del);
    return ECORE_CALLBACK_RENEW;
 }
 
@@ -302,17 +286,12 @@ _netstatus_config_updated(Instance *inst)
           }
         return;
      }
-   if (inst->cfg->netstatus.usage_check_thread)
-     {
-        ecore_thread_cancel(inst->cfg->netstatus.usage_check_thread);
-        inst->cfg->netstatus.usage_check_thread = NULL;
-     }
+   if (inst->cfg->netstatus.usage_check)
+     E_FREE_FUNC(inst->cfg->netstatus.usage_check, sysinfo_sampler_del);
    thc = E_NEW(Thread_Config, 1);
    if (thc)
      {
         thc->inst = inst;
-        thc->sleeper = e_powersave_sleeper_new();
-        thc->interval = inst->cfg->netstatus.poll_interval;
         thc->in = 0;
         thc->inmax = inst->cfg->netstatus.inmax;
         thc->incurrent = 0;
@@ -324,11 +303,14 @@ _netstatus_config_updated(Instance *inst)
         thc->outpercent = 0;
         thc->outstring = NULL;
         thc->automax = inst->cfg->netstatus.automax;
-        inst->cfg->netstatus.usage_check_thread =
-          ecore_thread_feedback_run(_netstatus_cb_usage_check_main,
-                                    _netstatus_cb_usage_check_notify,
-                                    _netstatus_cb_usage_check_end,
-                                    _netstatus_cb_usage_check_end, thc, EINA_TRUE);
+        inst->cfg->netstatus.usage_check =
+          sysinfo_sampler_add(SYSINFO_SAMPLE_NET,
+                              inst->cfg->netstatus.poll_interval,
+                              _netstatus_cb_usage_check_sample,
+                              _netstatus_cb_usage_check_notify,
+                              _netstatus_cb_usage_check_end, thc);
+        if (!inst->cfg->netstatus.usage_check)
+          _netstatus_cb_usage_check_end(thc);
      }
    e_config_save_queue();
 }
@@ -350,11 +332,8 @@ _netstatus_removed_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_data
    evas_object_event_callback_del_full(inst->o_main, EVAS_CALLBACK_DEL, sysinfo_netstatus_remove, data);
    EINA_LIST_FREE(inst->cfg->netstatus.handlers, handler)
      ecore_event_handler_del(handler);
-   if (inst->cfg->netstatus.usage_check_thread)
-     {
-        ecore_thread_cancel(inst->cfg->netstatus.usage_check_thread);
-        inst->cfg->netstatus.usage_check_thread = NULL;
-     }
+   if (inst->cfg->netstatus.usage_check)
+     E_FREE_FUNC(inst->cfg->netstatus.usage_check, sysinfo_sampler_del);
    E_FREE_FUNC(inst->cfg->netstatus.instring, eina_stringshare_del);
    E_FREE_FUNC(inst->cfg->netstatus.outstring, eina_stringshare_del);
 
@@ -377,10 +356,9 @@ sysinfo_netstatus_remove(void *data, Evas *e EINA_UNUSED, Evas_Object *obj EINA_
      E_FREE_FUNC(inst->cfg->netstatus.configure, evas_object_del);
    EINA_LIST_FREE(inst->cfg->netstatus.handlers, handler)
      ecore_event_handler_del(handler);
-   if (inst->cfg->netstatus.usage_check_thread)
+   if (inst->cfg->netstatus.usage_check)
      {
-        ecore_thread_cancel(inst->cfg->netstatus.usage_check_thread);
-        inst->cfg->netstatus.usage_check_thread = NULL;
+        E_FREE_FUNC(inst->cfg->netstatus.usage_check, sysinfo_sampler_del);
         return;
      }
    E_FREE_FUNC(inst->cfg->netstatus.instring, eina_stringshare_del);
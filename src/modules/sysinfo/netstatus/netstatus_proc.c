@@ -1,7 +1,8 @@
 #include "netstatus.h"
 
 void
-_netstatus_proc_getstatus(Eina_Bool automax,
+_netstatus_proc_getstatus(const Sysinfo_Sample *s,
+                          Eina_Bool automax,
                           time_t *last_checked,
                           unsigned long *prev_in,
                           unsigned long *prev_incurrent,
@@ -12,11 +13,9 @@ _netstatus_proc_getstatus(Eina_Bool automax,
                           unsigned long *prev_outmax,
                           int *prev_outpercent)
 {
-   unsigned long in, out, dummy, tot_in = 0, tot_out = 0;
+   unsigned long tot_in = s->net_in, tot_out = s->net_out;
    unsigned long diffin, diffout;
    int percent = 0;
-   char buf[4096], dummys[64];
-   FILE *f;
    time_t current = time(NULL);
    time_t diff = 0;
 
@@ -27,22 +26,6 @@ _netstatus_proc_getstatus(Eina_Bool automax,
    else
      diff = current - *last_checked;
 
-   f = fopen("/proc/net/dev", "r");
-   if (f)
-     {
-        while (fgets(buf, sizeof(buf), f) != NULL)
-          {
-             if (sscanf(buf, "%s %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu "
-                             "%lu %lu %lu %lu\n", dummys, &in, &dummy, &dummy,
-                        &dummy, &dummy, &dummy, &dummy, &dummy, &out, &dummy,
-                        &dummy, &dummy, &dummy, &dummy, &dummy, &dummy) < 17)
-               continue;
-             tot_in += in;
-             tot_out += out;
-          }
-        fclose(f);
-     }
-
    diffin = tot_in - *prev_in;
    if (diff > 1)
      diffin /= diff;
@@ -0,0 +1,416 @@
+#include "sysinfo.h"
+
+/* One thread polls for all sysinfo gadgets. Each gadget subscribes with
+ * the sources it reads and its poll interval. The thread wakes at the
+ * shortest interval of all subscribers, reads each source that a due
+ * subscriber wants once into a shared sample, and runs the sample
+ * callback of every due subscriber on it. Their notify callbacks run in
+ * the main loop after that, like with ecore_thread_feedback_run().
+ *
+ * The /proc files stay open and are read with pread() at offset 0,
+ * which has procfs generate them anew.
+ */
+#define SOURCE_COUNT 3
+#define BUF_SIZE     16384
+
+typedef struct _Sampler_Thread Sampler_Thread;
+
+struct _Sysinfo_Sampler
+{
+   Sysinfo_Sampler_Sample_Cb sample;
+   Sysinfo_Sampler_Cb        notify;
+   Sysinfo_Sampler_Cb        end;
+   void                     *data;
+   unsigned int              sources;
+   int                       interval;
+   double                    next;
+   int                       ref;
+   Eina_Bool                 delete_me E_BITFIELD;
+};
+
+struct _Sampler_Thread
+{
+   E_Powersave_Sleeper *sleeper;
+   int                  fds[SOURCE_COUNT];
+   char                *buf;
+   size_t               size;
+   int                  cpu_size;
+   Sysinfo_Sample       sample;
+};
+
+#ifdef __linux__
+static const char *_sampler_paths[SOURCE_COUNT] =
+{
+   "/proc/stat", "/proc/meminfo", "/proc/net/dev"
+};
+#endif
+
+/* guards the subscriber list and the refs of subscribers */
+static Eina_Lock _sampler_lock;
+static Eina_List *_sampler_subs = NULL;
+static Ecore_Thread *_sampler_thread = NULL;
+static Sampler_Thread *_sampler_td = NULL;
+static int _sampler_threads = 0;
+
+static const char *
+_sampler_file_read(Sampler_Thread *td, int source, const char *stop)
+{
+   size_t len = 0;
+   ssize_t ret;
+   char *tmp;
+
+   if (td->fds[source] < 0) return NULL;
+   for (;;)
+     {
+        ret = pread(td->fds[source], td->buf + len, td->size - len - 1, len);
+        if (ret < 0) return NULL;
+        len += ret;
+        td->buf[len] = 0;
+        if ((ret == 0) || ((stop) && (strstr(td->buf, stop)))) break;
+        if (len == td->size - 1)
+          {
+             tmp = realloc(td->buf, td->size * 2);
+             if (!tmp) break;
+             td->buf = tmp;
+             td->size *= 2;
+          }
+     }
+   return td->buf;
+}
+
+static const char *
+_sampler_line_next(const char *p)
+{
+   p = strchr(p, '\n');
+   return p ? p + 1 : NULL;
+}
+
+/* reads a number after any spaces at p, returns NULL if there is none */
+static const char *
+_sampler_ulong_parse(const char *p, unsigned long *val)
+{
+   unsigned long v = 0;
+
+   while (*p == ' ') p++;
+   if ((*p < '0') || (*p > '9')) return NULL;
+   for (; (*p >= '0') && (*p <= '9'); p++)
+     v = (v * 10) + (*p - '0');
+   *val = v;
+   return p;
+}
+
+static void
+_sampler_stat_parse(Sampler_Thread *td, const char *p)
+{
+   Sysinfo_Sample_Cpu *cpu;
+   const char *q;
+   unsigned long val;
+   int n = 0, i;
+
+   /* "cpu" for all cores, then a "cpuN" line for each core, each with
+    * the time spent in user nice system idle ... */
+   while (!strncmp(p, "cpu", 3))
+     {
+        if (n >= td->cpu_size)
+          {
+             cpu = realloc(td->sample.cpu, (n + 16) * sizeof(Sysinfo_Sample_Cpu));
+             if (!cpu) break;
+             td->sample.cpu = cpu;
+             td->cpu_size = n + 16;
+          }
+        cpu = &(td->sample.cpu[n++]);
+        cpu->total = 0;
+        cpu->idle = 0;
+        for (p += 3; (*p) && (*p != ' '); p++) ;
+        for (i = 0; (q = _sampler_ulong_parse(p, &val)); i++)
+          {
+             cpu->total += val;
+             if (i == 3) cpu->idle = val;
+             p = q;
+          }
+        p = _sampler_line_next(p);
+        if (!p) break;
+     }
+   td->sample.cpu_count = n ? n - 1 : 0;
+}
+
+static void
+_sampler_meminfo_parse(Sampler_Thread *td, const char *p)
+{
+   static const struct
+   {
+      const char *name;
+      size_t      offset;
+   } fields[] =
+   {
+      { "MemTotal:", offsetof(Sysinfo_Sample, mem_total) },
+      { "MemFree:", offsetof(Sysinfo_Sample, mem_free) },
+      { "Buffers:", offsetof(Sysinfo_Sample, mem_buffers) },
+      { "Cached:", offsetof(Sysinfo_Sample, mem_cached) },
+      { "SwapTotal:", offsetof(Sysinfo_Sample, swp_total) },
+      { "SwapFree:", offsetof(Sysinfo_Sample, swp_free) },
+      { "Shmem:", offsetof(Sysinfo_Sample, mem_shared) },
+      { "Slab:", offsetof(Sysinfo_Sample, mem_slab) }
+   };
+   unsigned int i, found = 0, n = sizeof(fields) / sizeof(fields[0]);
+   unsigned long *val;
+
+   for (i = 0; i < n; i++)
+     {
+        val = (unsigned long *)((char *)&(td->sample) + fields[i].offset);
+        *val = 0;
+     }
+   /* fields are in this order in the file, but don't rely on it */
+   for (; (p) && (*p) && (found < n); p = _sampler_line_next(p))
+     {
+        for (i = 0; i < n; i++)
+          {
+             size_t len = strlen(fields[i].name);
+
+             if (strncmp(p, fields[i].name, len)) continue;
+             val = (unsigned long *)((char *)&(td->sample) + fields[i].offset);
+             _sampler_ulong_parse(p + len, val);
+             found++;
+             break;
+          }
+     }
+}
+
+static void
+_sampler_net_parse(Sampler_Thread *td, const char *p)
+{
+   unsigned long val;
+   const char *q;
+   int i;
+
+   td->sample.net_in = 0;
+   td->sample.net_out = 0;
+   /* two header lines, then "iface: rx bytes packets ... tx bytes ..." */
+   for (; (p) && (*p); p = _sampler_line_next(p))
+     {
+        q = strchr(p, ':');
+        if ((!q) || (memchr(p, '\n', q - p))) continue;
+        p = q + 1;
+        for (i = 0; (q = _sampler_ulong_parse(p, &val)); i++)
+          {
+             if (i == 0) td->sample.net_in += val;
+             else if (i == 8) td->sample.net_out += val;
+             p = q;
+          }
+     }
+}
+
+static void
+_sampler_read(Sampler_Thread *td, unsigned int sources)
+{
+   const char *p;
+
+   if ((sources & SYSINFO_SAMPLE_CPU) &&
+       (p = _sampler_file_read(td, 0, "\nintr ")))
+     _sampler_stat_parse(td, p);
+   if ((sources & SYSINFO_SAMPLE_MEM) &&
+       (p = _sampler_file_read(td, 1, NULL)))
+     _sampler_meminfo_parse(td, p);
+   if ((sources & SYSINFO_SAMPLE_NET) &&
+       (p = _sampler_file_read(td, 2, NULL)))
+     _sampler_net_parse(td, p);
+}
+
+static void
+_sampler_unref(Sysinfo_Sampler *smp)
+{
+   int ref;
+
+   eina_lock_take(&_sampler_lock);
+   ref = --smp->ref;
+   eina_lock_release(&_sampler_lock);
+   if (ref > 0) return;
+   if (smp->end) smp->end(smp->data);
+   E_FREE(smp);
+}
+
+static void
+_sampler_main(void *data, Ecore_Thread *th)
+{
+   Sampler_Thread *td = data;
+   Sysinfo_Sampler *smp;
+   Eina_List *l, *due;
+   unsigned int sources;
+   int interval;
+   double now;
+
+   for (;; )
+     {
+        if (ecore_thread_check(th)) break;
+        due = NULL;
+        sources = 0;
+        interval = 0;
+        eina_lock_take(&_sampler_lock);
+        EINA_LIST_FOREACH(_sampler_subs, l, smp)
+          {
+             if ((!interval) || (smp->interval < interval))
+               interval = smp->interval;
+          }
+        /* wakeups are aligned to the interval, allow for some jitter
+         * so subscribers with multiples of it stay on time */
+        now = ecore_time_get() + ((double)interval / 16.0);
+        EINA_LIST_FOREACH(_sampler_subs, l, smp)
+          {
+             if (smp->next > now) continue;
+             sources |= smp->sources;
+             due = eina_list_append(due, smp);
+          }
+        _sampler_read(td, sources);
+        now = ecore_time_get();
+        EINA_LIST_FOREACH(due, l, smp)
+          {
+             smp->sample(smp->data, &(td->sample));
+             smp->next = now + ((double)smp->interval / 8.0);
+             smp->ref++;
+          }
+        eina_lock_release(&_sampler_lock);
+        if (due) ecore_thread_feedback(th, due);
+        if (ecore_thread_check(th)) break;
+        e_powersave_sleeper_sleep(td->sleeper, interval ? interval : 8);
+     }
+}
+
+static void
+_sampler_notify(void *data EINA_UNUSED, Ecore_Thread *th EINA_UNUSED, void *msg)
+{
+   Eina_List *due = msg;
+   Sysinfo_Sampler *smp;
+
+   EINA_LIST_FREE(due, smp)
+     {
+        if ((!smp->delete_me) && (smp->notify))
+          smp->notify(smp->data);
+        _sampler_unref(smp);
+     }
+}
+
+static void
+_sampler_end(void *data, Ecore_Thread *th EINA_UNUSED)
+{
+   Sampler_Thread *td = data;
+   int i;
+
+   for (i = 0; i < SOURCE_COUNT; i++)
+     {
+        if (td->fds[i] >= 0) close(td->fds[i]);
+     }
+   e_powersave_sleeper_free(td->sleeper);
+   free(td->sample.cpu);
+   free(td->buf);
+   if (_sampler_td == td)
+     {
+        _sampler_td = NULL;
+        _sampler_thread = NULL;
+     }
+   E_FREE(td);
+   _sampler_threads--;
+}
+
+static Eina_Bool
+_sampler_start(void)
+{
+   Sampler_Thread *td;
+   int i;
+
+   td = E_NEW(Sampler_Thread, 1);
+   if (!td) return EINA_FALSE;
+   td->size = BUF_SIZE;
+   td->buf = malloc(td->size);
+   if (!td->buf)
+     {
+        E_FREE(td);
+        return EINA_FALSE;
+     }
+   for (i = 0; i < SOURCE_COUNT; i++)
+     {
+#ifdef __linux__
+        td->fds[i] = open(_sampler_paths[i], O_RDONLY | O_CLOEXEC);
+#else
+        /* elsewhere the gadgets get their numbers from sysctl */
+        td->fds[i] = -1;
+#endif
+     }
+   td->sleeper = e_powersave_sleeper_new();
+   _sampler_td = td;
+   _sampler_threads++;
+   _sampler_thread =
+     ecore_thread_feedback_run(_sampler_main, _sampler_notify,
+                               _sampler_end, _sampler_end, td, EINA_TRUE);
+   /* if it failed _sampler_end() has already freed td */
+   return !!_sampler_thread;
+}
+
+EINTERN void
+sysinfo_sampler_init(void)
+{
+   eina_lock_new(&_sampler_lock);
+}
+
+EINTERN void
+sysinfo_sampler_shutdown(void)
+{
+   /* a cancelled thread may still be sleeping and take the lock once
+    * more before it ends */
+   if (!_sampler_threads)
+     eina_lock_free(&_sampler_lock);
+}
+
+/* sample is called in the sampler thread every poll_interval with the
+ * sources read, notify in the main loop after each sample and end once
+ * the subscriber is deleted and neither is called any more */
+EINTERN Sysinfo_Sampler *
+sysinfo_sampler_add(unsigned int sources, int poll_interval,
+                    Sysinfo_Sampler_Sample_Cb sample,
+                    Sysinfo_Sampler_Cb notify,
+                    Sysinfo_Sampler_Cb end, void *data)
+{
+   Sysinfo_Sampler *smp;
+
+   EINA_SAFETY_ON_NULL_RETURN_VAL(sample, NULL);
+   if ((!_sampler_thread) && (!_sampler_start())) return NULL;
+
+   smp = E_NEW(Sysinfo_Sampler, 1);
+   if (!smp) return NULL;
+   smp->sources = sources;
+   smp->interval = poll_interval > 0 ? poll_interval : 1;
+   smp->sample = sample;
+   smp->notify = notify;
+   smp->end = end;
+   smp->data = data;
+   smp->ref = 1;
+
+   eina_lock_take(&_sampler_lock);
+   _sampler_subs = eina_list_append(_sampler_subs, smp);
+   eina_lock_release(&_sampler_lock);
+   /* sample it now rather than after the current interval */
+   if (_sampler_td) e_powersave_sleeper_wake(_sampler_td->sleeper);
+   return smp;
+}
+
+EINTERN void
+sysinfo_sampler_del(Sysinfo_Sampler *smp)
+{
+   Eina_Bool empty;
+
+   if (!smp) return;
+   eina_lock_take(&_sampler_lock);
+   _sampler_subs = eina_list_remove(_sampler_subs, smp);
+   empty = !_sampler_subs;
+   eina_lock_release(&_sampler_lock);
+   smp->delete_me = EINA_TRUE;
+   _sampler_unref(smp);
+
+   if ((!empty) || (!_sampler_thread)) return;
+   if (!ecore_thread_cancel(_sampler_thread))
+     {
+        /* it ends once woken */
+        e_powersave_sleeper_wake(_sampler_td->sleeper);
+        _sampler_td = NULL;
+        _sampler_thread = NULL;
+     }
+}
@@ -61,6 +61,20 @@ typedef enum _Unit
    FAHRENHEIT
 } Unit;
 
+typedef enum _Sysinfo_Sample_Source
+{
+   SYSINFO_SAMPLE_CPU = (1 << 0), /* /proc/stat */
+   SYSINFO_SAMPLE_MEM = (1 << 1), /* /proc/meminfo */
+   SYSINFO_SAMPLE_NET = (1 << 2)  /* /proc/net/dev */
+} Sysinfo_Sample_Source;
+
+typedef struct _Sysinfo_Sample     Sysinfo_Sample;
+typedef struct _Sysinfo_Sample_Cpu Sysinfo_Sample_Cpu;
+typedef struct _Sysinfo_Sampler    Sysinfo_Sampler;
+
+typedef void (*Sysinfo_Sampler_Sample_Cb)(void *data, const Sysinfo_Sample *s);
+typedef void (*Sysinfo_Sampler_Cb)(void *data);
+
 typedef struct _Tempthread Tempthread;
 typedef struct _Cpu_Status       Cpu_Status;
 typedef struct _CPU_Core         CPU_Core;
@@ -111,6 +125,33 @@ struct _CPU_Core
    Evas_Object *layout;
 };
 
+struct _Sysinfo_Sample_Cpu
+{
+   unsigned long total;
+   unsigned long idle;
+};
+
+/* what the sampler read last, only valid in a sample callback and only
+ * for the sources that subscriber asked for */
+struct _Sysinfo_Sample
+{
+   /* cpu[0] is all cores, cpu[1] to cpu[cpu_count] each core */
+   Sysinfo_Sample_Cpu *cpu;
+   int                 cpu_count;
+   /* in kB */
+   unsigned long       mem_total;
+   unsigned long       mem_free;
+   unsigned long       mem_cached;
+   unsigned long       mem_slab;
+   unsigned long       mem_buffers;
+   unsigned long       mem_shared;
+   unsigned long       swp_total;
+   unsigned long       swp_free;
+   /* in bytes, over all interfaces */
+   unsigned long       net_in;
+   unsigned long       net_out;
+};
+
 struct _Config
 {
    Eina_List *items;
@@ -211,7 +252,7 @@ struct _Config_Item
       int                  percent;
       int                  cores;
 
-      Ecore_Thread        *usage_check_thread;
+      Sysinfo_Sampler     *usage_check;
       Eina_List           *handlers;
    } cpumonitor;
    struct
@@ -229,7 +270,7 @@ struct _Config_Item
       unsigned long        mem_shared;
       unsigned long        swp_total;
       unsigned long        swp_used;
-      Ecore_Thread        *usage_check_thread;
+      Sysinfo_Sampler     *usage_check;
       Eina_List           *handlers;
    } memusage;
    struct
@@ -247,7 +288,7 @@ struct _Config_Item
       int                  outpercent;
       unsigned long        inmax;
       unsigned long        outmax;
-      Ecore_Thread        *usage_check_thread;
+      Sysinfo_Sampler     *usage_check;
       Eina_List           *handlers;
       Eina_Stringshare    *instring;
       Eina_Stringshare    *outstring;
@@ -296,6 +337,11 @@ EINTERN void sysinfo_cpumonitor_remove(void *data, Evas *e EINA_UNUSED, Evas_Obj
 EINTERN void sysinfo_memusage_remove(void *data, Evas *e EINA_UNUSED, Evas_Object *obj EINA_UNUSED, void *event_data EINA_UNUSED);
 EINTERN void sysinfo_netstatus_remove(void *data, Evas *e EINA_UNUSED, Evas_Object *obj EINA_UNUSED, void *event_data EINA_UNUSED);
 
+EINTERN void             sysinfo_sampler_init(void);
+EINTERN void             sysinfo_sampler_shutdown(void);
+EINTERN Sysinfo_Sampler *sysinfo_sampler_add(unsigned int sources, int poll_interval, Sysinfo_Sampler_Sample_Cb sample, Sysinfo_Sampler_Cb notify, Sysinfo_Sampler_Cb end, void *data);
+EINTERN void             sysinfo_sampler_del(Sysinfo_Sampler *smp);
+
 EINTERN extern Config *sysinfo_config;
 EINTERN extern Eina_List *sysinfo_instances;
 